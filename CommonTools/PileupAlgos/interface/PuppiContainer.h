@@ -2,9 +2,11 @@
 #define COMMONTOOLS_PUPPI_PUPPICONTAINER_H_
 
 #include "CommonTools/PileupAlgos/interface/PuppiAlgo.h"
+#include "CommonTools/PileupAlgos/interface/PuppiNeighbourGrid.h"
 #include "CommonTools/PileupAlgos/interface/RecoObj.h"
 #include "fastjet/internal/base.hh"
 #include "fastjet/PseudoJet.hh"
+#include "tbb/enumerable_thread_specific.h"
 
 //FASTJET_BEGIN_NAMESPACE      // defined in fastjet/internal/base.hh
 
@@ -52,12 +54,20 @@ public:
     std::vector<fastjet::PseudoJet> const & puppiParticles() const { return fPupParticles;}
 
 protected:
-    double  goodVar      (fastjet::PseudoJet const &iPart,std::vector<fastjet::PseudoJet> const &iParts, int iOpt,const double iRCone);
-    void    getRMSAvg    (int iOpt,std::vector<fastjet::PseudoJet> const &iConstits,std::vector<fastjet::PseudoJet> const &iParticles,std::vector<fastjet::PseudoJet> const &iChargeParticles);
-    void    getRawAlphas    (int iOpt,std::vector<fastjet::PseudoJet> const &iConstits,std::vector<fastjet::PseudoJet> const &iParticles,std::vector<fastjet::PseudoJet> const &iChargeParticles);
+    // local metric of a sub algo, shared by the algos with the same definition
+    struct Metric {
+        int    algoId;
+        bool   charged;
+        double cone;
+    };
+
+    double  goodVar      (fastjet::PseudoJet const &iPart,PuppiNeighbourGrid const &iParts, int iOpt,const double iRCone,std::vector<unsigned int> &iBuffer) const;
+    void    getRMSAvg    (int iOpt,std::vector<fastjet::PseudoJet> const &iConstits,PuppiNeighbourGrid const &iParticles,PuppiNeighbourGrid const &iChargeParticles);
+    void    getRawAlphas    (int iOpt,std::vector<fastjet::PseudoJet> const &iConstits,PuppiNeighbourGrid const &iParticles,PuppiNeighbourGrid const &iChargeParticles);
+    void    getMetricValues(int iOpt,std::vector<fastjet::PseudoJet> const &iConstits,PuppiNeighbourGrid const &iParticles,PuppiNeighbourGrid const &iChargeParticles);
     double  getChi2FromdZ(double iDZ);
     int     getPuppiId   ( float iPt, float iEta);
-    double  var_within_R (int iId, const std::vector<fastjet::PseudoJet> & particles, const fastjet::PseudoJet& centre, const double R);  
+    double  var_within_R (int iId, const PuppiNeighbourGrid & particles, const fastjet::PseudoJet& centre, const double R, std::vector<unsigned int> &iBuffer) const;
     
     bool      fPuppiDiagnostics;
     std::vector<RecoObj>   fRecoParticles;
@@ -70,6 +80,20 @@ protected:
     std::vector<double>    fAlphaMed;
     std::vector<double>    fAlphaRMS;
 
+    // neighbour grids of fPFParticles and fChargedPV, with cells as large as the largest cone
+    double fMaxCone;
+    PuppiNeighbourGrid fPFGrid;
+    PuppiNeighbourGrid fChargedPVGrid;
+    // buffers reused across the events: the puppi ids of the particles (-1 when
+    // not computed), the distinct metrics of the iteration, the metric of each
+    // algo, the values of the metrics for each particle and the neighbour
+    // candidates of each thread
+    std::vector<int>       fPupIds;
+    std::vector<Metric>    fMetrics;
+    std::vector<int>       fMetricOfAlgo;
+    std::vector<double>    fMetricVals;
+    tbb::enumerable_thread_specific<std::vector<unsigned int> > fNeighbours;
+
     bool   fApplyCHS;
     bool   fInvert;
     bool   fUseExp;
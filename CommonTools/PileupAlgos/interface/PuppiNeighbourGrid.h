@@ -0,0 +1,47 @@
+#ifndef CommonTools_PileupAlgos_PuppiNeighbourGrid_h
+#define CommonTools_PileupAlgos_PuppiNeighbourGrid_h
+
+#include "fastjet/PseudoJet.hh"
+#include <vector>
+
+// Rapidity-phi grid of the particles used for the local metrics of puppi.
+// The cells are at least cellSize wide in rapidity and in phi, so that all
+// the particles closer than cellSize to a point are in the 3x3 cells around
+// the cell of the point (phi being periodic). The particle indices are
+// stored cell by cell in a single array, in increasing order in each cell,
+// and the coordinates of the particles are copied in flat arrays.
+class PuppiNeighbourGrid {
+public:
+  // maximum number of cells in rapidity, wider cells are used beyond
+  static const int maxRapBins = 256;
+  // the cells cover at most |rap| < maxRap, the particles beyond (e.g. the
+  // ones with a non finite rapidity) being in the first or last cells
+  static constexpr double maxRap = 10.;
+
+  void fill(const std::vector<fastjet::PseudoJet> &iParticles, double iCellSize);
+
+  // appends to oIndices the indices, in increasing order, of the particles in
+  // the cells around (iRap,iPhi), a superset of the ones closer than cellSize
+  void candidates(double iRap, double iPhi, std::vector<unsigned int> &oIndices) const;
+
+  unsigned int size() const { return fRap.size(); }
+
+  // coordinates as given by fastjet, phi being in [0,2pi)
+  const double *rap() const { return fRap.data(); }
+  const double *phi() const { return fPhi.data(); }
+  const double *eta() const { return fEta.data(); }
+  const double *pt () const { return fPt .data(); }
+
+private:
+  int rapBin(double iRap) const;
+  int phiBin(double iPhi) const;
+
+  double fRapMin = 0., fRapWidth = 1., fPhiWidth = 1.;
+  int    fNRap = 1, fNPhi = 1;
+  std::vector<unsigned int> fOffsets;
+  std::vector<unsigned int> fIndices;
+  std::vector<int>          fCells;
+  std::vector<double> fRap, fPhi, fEta, fPt;
+};
+
+#endif
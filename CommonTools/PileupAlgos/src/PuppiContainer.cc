@@ -6,8 +6,11 @@
 #include "TMath.h"
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/Utilities/interface/isFinite.h"
+#include "tbb/task_arena.h"
+#include "tbb/tbb.h"
 
 using namespace std;
 using namespace fastjet;
@@ -25,6 +28,11 @@ PuppiContainer::PuppiContainer(const edm::ParameterSet &iConfig) {
         PuppiAlgo pPuppiConfig(lAlgos[i0]);
         fPuppiAlgo.push_back(pPuppiConfig);
     }
+    fMaxCone = 0;
+    for(int i0 = 0; i0 < fNAlgos; i0++) {
+        for(int i1 = 0; i1 < fPuppiAlgo[i0].numAlgos(); i1++) fMaxCone = std::max(fMaxCone,fPuppiAlgo[i0].coneSize(i1));
+    }
+    if(fMaxCone <= 0) fMaxCone = fastjet::twopi;
 }
 
 void PuppiContainer::initialize(const std::vector<RecoObj> &iRecoObjects) {
@@ -72,15 +80,17 @@ void PuppiContainer::initialize(const std::vector<RecoObj> &iRecoObjects) {
     }
     if (fPVFrac != 0) fPVFrac = double(fChargedPV.size())/fPVFrac;
     else fPVFrac = 0;
+    fPFGrid       .fill(fPFParticles,fMaxCone);
+    fChargedPVGrid.fill(fChargedPV  ,fMaxCone);
 }
 PuppiContainer::~PuppiContainer(){}
 
-double PuppiContainer::goodVar(PseudoJet const &iPart,std::vector<PseudoJet> const &iParts, int iOpt,const double iRCone) {
+double PuppiContainer::goodVar(PseudoJet const &iPart,PuppiNeighbourGrid const &iParts, int iOpt,const double iRCone,std::vector<unsigned int> &iBuffer) const {
     double lPup = 0;
-    lPup = var_within_R(iOpt,iParts,iPart,iRCone);
+    lPup = var_within_R(iOpt,iParts,iPart,iRCone,iBuffer);
     return lPup;
 }
-double PuppiContainer::var_within_R(int iId, const vector<PseudoJet> & particles, const PseudoJet& centre, const double R){
+double PuppiContainer::var_within_R(int iId, const PuppiNeighbourGrid & particles, const PseudoJet& centre, const double R, std::vector<unsigned int> &iBuffer) const {
     if(iId == -1) return 1;
 
     //this is a circle in rapidity-phi
@@ -88,23 +98,37 @@ double PuppiContainer::var_within_R(int iId, const vector<PseudoJet> & particles
     //fastjet::Selector sel = fastjet::SelectorCircle(R);
     //sel.set_reference(centre);
     //the original code used Selector infrastructure: it is too heavy here
-    //logic of SelectorCircle is preserved below
+    //logic of SelectorCircle is preserved below, on the particles of the
+    //cells around the centre, in the order of the collection
 
-    vector<double > near_dR2s;     near_dR2s.reserve(std::min(50UL, particles.size()));
-    vector<double > near_pts;      near_pts.reserve(std::min(50UL, particles.size()));
-    for (auto const& part : particles){
-      if ( part.squared_distance(centre) < R*R ){
-	near_dR2s.push_back(reco::deltaR2(part, centre));
-	near_pts.push_back(part.pt());
-      }
+    iBuffer.clear();
+    particles.candidates(centre.rap(), centre.phi(), iBuffer);
+    const double *lRap = particles.rap();
+    const double *lPhi = particles.phi();
+    const double *lEta = particles.eta();
+    const double *lPt  = particles.pt();
+    const double lCentreRap = centre.rap();
+    const double lCentrePhi = centre.phi();
+    const double lCentreEta = centre.eta();
+
+    // keep the candidates within the cone (as PseudoJet::squared_distance),
+    // compacting their indices in place
+    unsigned int nParts = 0;
+    for(unsigned int j : iBuffer){
+        double dphi = std::abs(lPhi[j] - lCentrePhi);
+        if(dphi > fastjet::pi) dphi = fastjet::twopi - dphi;
+        const double drap = lRap[j] - lCentreRap;
+        iBuffer[nParts] = j;
+        nParts += (dphi*dphi + drap*drap < R*R);
     }
+
     double var = 0;
     //double lSumPt = 0;
     //if(iId == 1) for(auto  pt : near_pts) lSumPt += pt;
-    auto nParts = near_dR2s.size();
-    for(auto i = 0UL; i < nParts; ++i){
-        auto dr2 = near_dR2s[i];
-        auto pt  = near_pts[i];
+    for(auto i = 0U; i < nParts; ++i){
+        const unsigned int j = iBuffer[i];
+        auto dr2 = reco::deltaR2(lEta[j], lPhi[j], lCentreEta, lCentrePhi);
+        auto pt  = lPt[j];
         if(dr2  <  0.0001) continue;
         if(iId == 0) var += (pt/dr2);
         else if(iId == 1) var += pt;
@@ -119,23 +143,55 @@ double PuppiContainer::var_within_R(int iId, const vector<PseudoJet> & particles
     else if(iId == 5 && var != 0) var = log(var);
     return var;
 }
+//Values of the distinct metrics of iteration iOpt for the particles with a puppi id (fPupIds), in parallel
+void PuppiContainer::getMetricValues(int iOpt,std::vector<fastjet::PseudoJet> const &iConstits,PuppiNeighbourGrid const &iParticles,PuppiNeighbourGrid const &iChargedParticles) {
+    fMetrics.clear();
+    fMetricOfAlgo.assign(fNAlgos,-1);
+    for(int i0 = 0; i0 < fNAlgos; i0++) {
+        Metric lMetric{ fPuppiAlgo[i0].algoId(iOpt), fPuppiAlgo[i0].isCharged(iOpt), fPuppiAlgo[i0].coneSize(iOpt) };
+        unsigned int i1 = 0;
+        for(; i1 < fMetrics.size(); i1++) {
+            if(fMetrics[i1].algoId == lMetric.algoId && fMetrics[i1].charged == lMetric.charged && fMetrics[i1].cone == lMetric.cone) break;
+        }
+        if(i1 == fMetrics.size()) fMetrics.push_back(lMetric);
+        fMetricOfAlgo[i0] = i1;
+    }
+
+    const unsigned int lNMetrics = fMetrics.size();
+    fMetricVals.resize(iConstits.size()*lNMetrics);
+    tbb::this_task_arena::isolate([&] {
+        tbb::parallel_for(size_t(0), iConstits.size(), [&](size_t i0) {
+            if(fPupIds[i0] == -1) return;
+            std::vector<unsigned int> &lBuffer = fNeighbours.local();
+            for(unsigned int i1 = 0; i1 < lNMetrics; i1++) {
+                const Metric &lMetric = fMetrics[i1];
+                fMetricVals[i0*lNMetrics+i1] = goodVar(iConstits[i0], lMetric.charged ? iChargedParticles : iParticles, lMetric.algoId, lMetric.cone, lBuffer);
+            }
+        });
+    });
+}
 //In fact takes the median not the average
-void PuppiContainer::getRMSAvg(int iOpt,std::vector<fastjet::PseudoJet> const &iConstits,std::vector<fastjet::PseudoJet> const &iParticles,std::vector<fastjet::PseudoJet> const &iChargedParticles) {
+void PuppiContainer::getRMSAvg(int iOpt,std::vector<fastjet::PseudoJet> const &iConstits,PuppiNeighbourGrid const &iParticles,PuppiNeighbourGrid const &iChargedParticles) {
+    //Calculate the Puppi Algo to use, sequentially since it fixes the eta bins of the algos
+    fPupIds.resize(iConstits.size());
+    bool lAny = false;
     for(unsigned int i0 = 0; i0 < iConstits.size(); i0++ ) {
-        double pVal = -1;
-        //Calculate the Puppi Algo to use
         int  pPupId   = getPuppiId(iConstits[i0].pt(),iConstits[i0].eta());
-        if(pPupId == -1 || fPuppiAlgo[pPupId].numAlgos() <= iOpt){
+        if(pPupId == -1 || fPuppiAlgo[pPupId].numAlgos() <= iOpt) pPupId = -1;
+        fPupIds[i0] = pPupId;
+        lAny |= (pPupId != -1);
+    }
+    //Compute the Puppi Metrics of all the algos
+    if(lAny) getMetricValues(iOpt,iConstits,iParticles,iChargedParticles);
+
+    const unsigned int lNMetrics = fMetrics.size();
+    for(unsigned int i0 = 0; i0 < iConstits.size(); i0++ ) {
+        int  pPupId   = fPupIds[i0];
+        if(pPupId == -1){
             fVals.push_back(-1);
             continue;
         }
-        //Get the Puppi Sub Algo (given iteration)
-        int  pAlgo    = fPuppiAlgo[pPupId].algoId   (iOpt);
-        bool pCharged = fPuppiAlgo[pPupId].isCharged(iOpt);
-        double pCone  = fPuppiAlgo[pPupId].coneSize (iOpt);
-        //Compute the Puppi Metric
-        if(!pCharged) pVal = goodVar(iConstits[i0],iParticles       ,pAlgo,pCone);
-        if( pCharged) pVal = goodVar(iConstits[i0],iChargedParticles,pAlgo,pCone);
+        double pVal = fMetricVals[i0*lNMetrics+fMetricOfAlgo[pPupId]];
         fVals.push_back(pVal);
         //if(std::isnan(pVal) || std::isinf(pVal)) cerr << "====> Value is Nan " << pVal << " == " << iConstits[i0].pt() << " -- " << iConstits[i0].eta() << endl;
         if( ! edm::isFinite(pVal)) {
@@ -146,12 +202,7 @@ void PuppiContainer::getRMSAvg(int iOpt,std::vector<fastjet::PseudoJet> const &i
         // // fPuppiAlgo[pPupId].add(iConstits[i0],pVal,iOpt);
         //code added by Nhan, now instead for every algorithm give it all the particles
         for(int i1 = 0; i1 < fNAlgos; i1++){
-            pAlgo    = fPuppiAlgo[i1].algoId   (iOpt);
-            pCharged = fPuppiAlgo[i1].isCharged(iOpt);
-            pCone    = fPuppiAlgo[i1].coneSize (iOpt);
-            double curVal = -1; 
-            if(!pCharged) curVal = goodVar(iConstits[i0],iParticles       ,pAlgo,pCone);
-            if( pCharged) curVal = goodVar(iConstits[i0],iChargedParticles,pAlgo,pCone);
+            double curVal = fMetricVals[i0*lNMetrics+fMetricOfAlgo[i1]];
             //std::cout << "i1 = " << i1 << ", curVal = " << curVal << ", eta = " << iConstits[i0].eta() << ", pupID = " << pPupId << std::endl;
             fPuppiAlgo[i1].add(iConstits[i0],curVal,iOpt);
         }
@@ -160,17 +211,15 @@ void PuppiContainer::getRMSAvg(int iOpt,std::vector<fastjet::PseudoJet> const &i
     for(int i0 = 0; i0 < fNAlgos; i0++) fPuppiAlgo[i0].computeMedRMS(iOpt,fPVFrac);
 }
 //In fact takes the median not the average
-void PuppiContainer::getRawAlphas(int iOpt,std::vector<fastjet::PseudoJet> const &iConstits,std::vector<fastjet::PseudoJet> const &iParticles,std::vector<fastjet::PseudoJet> const &iChargedParticles) {
+void PuppiContainer::getRawAlphas(int iOpt,std::vector<fastjet::PseudoJet> const &iConstits,PuppiNeighbourGrid const &iParticles,PuppiNeighbourGrid const &iChargedParticles) {
+    if(iConstits.empty()) return;
+    fPupIds.assign(iConstits.size(),0);
+    getMetricValues(iOpt,iConstits,iParticles,iChargedParticles);
+
+    const unsigned int lNMetrics = fMetrics.size();
     for(int j0 = 0; j0 < fNAlgos; j0++){
         for(unsigned int i0 = 0; i0 < iConstits.size(); i0++ ) {
-            double pVal = -1;
-            //Get the Puppi Sub Algo (given iteration)
-            int  pAlgo    = fPuppiAlgo[j0].algoId   (iOpt);
-            bool pCharged = fPuppiAlgo[j0].isCharged(iOpt);
-            double pCone  = fPuppiAlgo[j0].coneSize (iOpt);
-            //Compute the Puppi Metric
-            if(!pCharged) pVal = goodVar(iConstits[i0],iParticles       ,pAlgo,pCone);
-            if( pCharged) pVal = goodVar(iConstits[i0],iChargedParticles,pAlgo,pCone);
+            double pVal = fMetricVals[i0*lNMetrics+fMetricOfAlgo[j0]];
             fRawAlphas.push_back(pVal);
             if( ! edm::isFinite(pVal)) {
                 LogDebug( "NotFound" )  << "====> Value is Nan " << pVal << " == " << iConstits[i0].pt() << " -- " << iConstits[i0].eta() << endl;
@@ -220,9 +269,9 @@ std::vector<double> const & PuppiContainer::puppiWeights() {
     //Run through all compute mean and RMS
     int lNParticles    = fRecoParticles.size();
     for(int i0 = 0; i0 < lNMaxAlgo; i0++) {
-        getRMSAvg(i0,fPFParticles,fPFParticles,fChargedPV);
+        getRMSAvg(i0,fPFParticles,fPFGrid,fChargedPVGrid);
     }
-    if (fPuppiDiagnostics) getRawAlphas(0,fPFParticles,fPFParticles,fChargedPV);
+    if (fPuppiDiagnostics) getRawAlphas(0,fPFParticles,fPFGrid,fChargedPVGrid);
 
     std::vector<double> pVals;
     for(int i0 = 0; i0 < lNParticles; i0++) {
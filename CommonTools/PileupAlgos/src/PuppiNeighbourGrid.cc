@@ -0,0 +1,63 @@
+#include "CommonTools/PileupAlgos/interface/PuppiNeighbourGrid.h"
+#include <algorithm>
+
+void PuppiNeighbourGrid::fill(const std::vector<fastjet::PseudoJet> &iParticles, double iCellSize) {
+    const unsigned int lN = iParticles.size();
+    fRap.resize(lN);
+    fPhi.resize(lN);
+    fEta.resize(lN);
+    fPt .resize(lN);
+    double lRapMax = 0.;
+    fRapMin = 0.;
+    for(unsigned int i0 = 0; i0 < lN; i0++) {
+        fRap[i0] = iParticles[i0].rap();
+        fPhi[i0] = iParticles[i0].phi();
+        fEta[i0] = iParticles[i0].eta();
+        fPt [i0] = iParticles[i0].pt();
+        if(i0 == 0 || fRap[i0] < fRapMin) fRapMin = fRap[i0];
+        if(i0 == 0 || fRap[i0] > lRapMax) lRapMax = fRap[i0];
+    }
+
+    fRapMin = std::min(std::max(fRapMin, -maxRap), maxRap);
+    lRapMax = std::min(std::max(lRapMax, fRapMin), maxRap);
+    fRapWidth = std::max(iCellSize, (lRapMax - fRapMin) / maxRapBins);
+    fNRap     = std::min(int((lRapMax - fRapMin) / fRapWidth) + 1, int(maxRapBins));
+    fNPhi     = std::max(int(fastjet::twopi / iCellSize), 1);
+    fPhiWidth = fastjet::twopi / fNPhi;
+
+    // counting sort of the particles by cell, keeping their order in a cell
+    fCells.resize(lN);
+    fOffsets.assign(fNRap * fNPhi + 1, 0);
+    for(unsigned int i0 = 0; i0 < lN; i0++) {
+        fCells[i0] = rapBin(fRap[i0]) * fNPhi + phiBin(fPhi[i0]);
+        ++fOffsets[fCells[i0] + 1];
+    }
+    for(int i0 = 0; i0 < fNRap * fNPhi; i0++) fOffsets[i0 + 1] += fOffsets[i0];
+    fIndices.resize(lN);
+    std::vector<unsigned int> lNext(fOffsets.begin(), fOffsets.end() - 1);
+    for(unsigned int i0 = 0; i0 < lN; i0++) fIndices[lNext[fCells[i0]]++] = i0;
+}
+
+int PuppiNeighbourGrid::rapBin(double iRap) const {
+    return std::min(std::max(int((iRap - fRapMin) / fRapWidth), 0), fNRap - 1);
+}
+
+int PuppiNeighbourGrid::phiBin(double iPhi) const {
+    return std::min(std::max(int(iPhi / fPhiWidth), 0), fNPhi - 1);
+}
+
+void PuppiNeighbourGrid::candidates(double iRap, double iPhi, std::vector<unsigned int> &oIndices) const {
+    const unsigned int lFirst = oIndices.size();
+    const int lRapBin = rapBin(iRap);
+    const int lPhiBin = phiBin(iPhi);
+    // with less than 3 cells in phi, all of them are neighbours
+    const int lPhiLow  = fNPhi < 3 ? 0         : lPhiBin - 1;
+    const int lPhiHigh = fNPhi < 3 ? fNPhi - 1 : lPhiBin + 1;
+    for(int iR = std::max(lRapBin - 1, 0); iR <= std::min(lRapBin + 1, fNRap - 1); iR++) {
+        for(int iP = lPhiLow; iP <= lPhiHigh; iP++) {
+            const int lCell = iR * fNPhi + (iP + fNPhi) % fNPhi;
+            oIndices.insert(oIndices.end(), fIndices.begin() + fOffsets[lCell], fIndices.begin() + fOffsets[lCell + 1]);
+        }
+    }
+    std::sort(oIndices.begin() + lFirst, oIndices.end());
+}
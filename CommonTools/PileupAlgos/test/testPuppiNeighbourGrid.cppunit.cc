@@ -0,0 +1,211 @@
+/* Unit test of the neighbour grid of PuppiContainer: the candidates of the grid
+   must include all the particles in the cone (as PseudoJet::squared_distance),
+   in the order of the collection, and the weights computed on the grid must be
+   identical to the ones of a plain scan of all the particles, on random events
+   with particles across phi = 0 and phi = +-pi and at the edge of the cones
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "CommonTools/PileupAlgos/interface/PuppiContainer.h"
+#include "CommonTools/PileupAlgos/interface/PuppiNeighbourGrid.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+class testPuppiNeighbourGrid: public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(testPuppiNeighbourGrid);
+  CPPUNIT_TEST(testCandidates);
+  CPPUNIT_TEST(testWeights);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+
+  void testCandidates();
+  void testWeights();
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testPuppiNeighbourGrid);
+
+namespace {
+
+  // the metrics of PuppiContainer on the particles of a single cell, i.e. on
+  // all of them in the order of the collection, as the former plain scan
+  class PuppiContainerPlainScan : public PuppiContainer {
+  public:
+    PuppiContainerPlainScan(const edm::ParameterSet &iConfig) : PuppiContainer(iConfig) {}
+
+    void initialize(const std::vector<RecoObj> &iRecoObjects) {
+      PuppiContainer::initialize(iRecoObjects);
+      const double lCellSize = 2.*PuppiNeighbourGrid::maxRap + fastjet::twopi;
+      fPFGrid       .fill(fPFParticles,lCellSize);
+      fChargedPVGrid.fill(fChargedPV  ,lCellSize);
+    }
+  };
+
+  edm::ParameterSet puppiAlgo(int algoId, bool useCharged, double cone, double rmsPtMin) {
+    edm::ParameterSet pset;
+    pset.addParameter<int>("algoId", algoId);
+    pset.addParameter<bool>("useCharged", useCharged);
+    pset.addParameter<bool>("applyLowPUCorr", true);
+    pset.addParameter<int>("combOpt", 0);
+    pset.addParameter<double>("cone", cone);
+    pset.addParameter<double>("rmsPtMin", rmsPtMin);
+    pset.addParameter<double>("rmsScaleFactor", 1.);
+    return pset;
+  }
+
+  edm::ParameterSet etaRange(std::vector<double> etaMin, std::vector<double> etaMax, std::vector<double> minNeutralPt,
+                             std::vector<double> rmsEtaSF, std::vector<double> medEtaSF,
+                             std::vector<edm::ParameterSet> puppiAlgos) {
+    edm::ParameterSet pset;
+    pset.addParameter<std::vector<double> >("ptMin", std::vector<double>(etaMin.size(), 0.));
+    pset.addParameter<std::vector<double> >("MinNeutralPtSlope", std::vector<double>(etaMin.size(), 0.015));
+    pset.addParameter<std::vector<double> >("etaMin", etaMin);
+    pset.addParameter<std::vector<double> >("etaMax", etaMax);
+    pset.addParameter<std::vector<double> >("MinNeutralPt", minNeutralPt);
+    pset.addParameter<std::vector<double> >("RMSEtaSF", rmsEtaSF);
+    pset.addParameter<std::vector<double> >("MedEtaSF", medEtaSF);
+    pset.addParameter<double>("EtaMaxExtrap", 2.);
+    pset.addParameter<std::vector<edm::ParameterSet> >("puppiAlgos", puppiAlgos);
+    return pset;
+  }
+
+  // the configuration of Puppi_cff, with a second iteration (a neutral
+  // metric of a smaller cone) in both regions
+  edm::ParameterSet puppiConfig() {
+    edm::ParameterSet pset;
+    pset.addParameter<bool>("puppiDiagnostics", true);
+    pset.addParameter<bool>("applyCHS", true);
+    pset.addParameter<bool>("invertPuppi", false);
+    pset.addParameter<bool>("useExp", false);
+    pset.addParameter<double>("MinPuppiWeight", 0.01);
+    pset.addParameter<double>("PtMaxNeutrals", 200.);
+    std::vector<edm::ParameterSet> algos;
+    algos.push_back(etaRange({0.}, {2.5}, {0.2}, {1.}, {1.},
+                             {puppiAlgo(5, true, 0.4, 0.1), puppiAlgo(0, false, 0.3, 0.1)}));
+    algos.push_back(etaRange({2.5, 3.}, {3., 10.}, {1.7, 2.}, {1.2, 0.95}, {0.9, 0.75},
+                             {puppiAlgo(5, false, 0.4, 0.5), puppiAlgo(0, false, 0.3, 0.5)}));
+    pset.addParameter<std::vector<edm::ParameterSet> >("algos", algos);
+    return pset;
+  }
+
+  RecoObj particle(float pt, float rap, float phi, int id, int charge) {
+    RecoObj obj;
+    obj.pt = pt;
+    obj.eta = rap;
+    obj.rapidity = rap;
+    obj.phi = phi;
+    obj.m = 0;
+    obj.id = id;
+    obj.charge = charge;
+    return obj;
+  }
+
+  // random particles of all kinds, with groups of particles around phi = 0
+  // (the periodicity of the fastjet phi) and phi = +-pi, at the edge of the cones
+  std::vector<RecoObj> randomEvent(std::mt19937 &rng, unsigned int nParticles) {
+    std::uniform_real_distribution<float> flat(0.f, 1.f);
+    std::exponential_distribution<float> spectrum(0.5f);
+    auto randomParticle = [&](float rap, float phi) {
+      float kind = flat(rng);
+      int id = kind < 0.4f ? 0 : (kind < 0.7f ? 1 : 2);
+      int charge = id == 0 ? 0 : (flat(rng) < 0.5f ? -1 : 1);
+      if (phi > float(M_PI)) phi -= 2.f*float(M_PI);
+      if (phi < -float(M_PI)) phi += 2.f*float(M_PI);
+      return particle(0.1f + spectrum(rng), rap, phi, id, charge);
+    };
+
+    std::vector<RecoObj> particles;
+    while (particles.size() < nParticles) {
+      float rap = -5.f + 10.f*flat(rng);
+      float phi = float(M_PI)*(2.f*flat(rng) - 1.f);
+      float where = flat(rng);
+      if (where < 0.1f) phi = 0.02f*(2.f*flat(rng) - 1.f);
+      else if (where < 0.2f) phi = float(M_PI)*(1.f - 0.02f*flat(rng))*(flat(rng) < 0.5f ? -1.f : 1.f);
+      particles.push_back(randomParticle(rap, phi));
+      if (flat(rng) < 0.2f) {
+        // neighbours at the edge of the cones, just inside, on and just outside
+        for (float cone : {0.3f, 0.4f}) {
+          for (float dr : {cone - 1.e-5f, cone, cone + 1.e-5f}) {
+            float a = 2.f*float(M_PI)*flat(rng);
+            particles.push_back(randomParticle(rap + dr*std::cos(a), phi + dr*std::sin(a)));
+          }
+        }
+      }
+    }
+    // a particle without a finite rapidity
+    particles.push_back(particle(1.f, std::numeric_limits<float>::quiet_NaN(), 0.f, 0, 0));
+    return particles;
+  }
+
+  template <typename T>
+  bool identical(const std::vector<T> &a, const std::vector<T> &b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size()*sizeof(T)) == 0;
+  }
+
+}
+
+void testPuppiNeighbourGrid::testCandidates() {
+  std::mt19937 rng(49);
+  for (unsigned int iEvent = 0; iEvent < 10; ++iEvent) {
+    std::vector<fastjet::PseudoJet> particles;
+    for (const auto &obj : randomEvent(rng, 200 + 100*iEvent)) {
+      fastjet::PseudoJet p;
+      if (std::isfinite(obj.rapidity)) p.reset_PtYPhiM(obj.pt, obj.rapidity, obj.phi, obj.m);
+      else p.reset_PtYPhiM(0, 99., 0, 0);
+      particles.push_back(p);
+    }
+    for (double cone : {0.3, 0.4, 2.5}) {
+      PuppiNeighbourGrid grid;
+      grid.fill(particles, cone);
+      CPPUNIT_ASSERT_EQUAL((unsigned int)particles.size(), grid.size());
+      std::vector<unsigned int> candidates;
+      for (const auto &centre : particles) {
+        candidates.clear();
+        grid.candidates(centre.rap(), centre.phi(), candidates);
+        CPPUNIT_ASSERT(std::adjacent_find(candidates.begin(), candidates.end(),
+                                          [](unsigned int a, unsigned int b) { return a >= b; }) == candidates.end());
+        for (unsigned int j = 0; j < particles.size(); ++j) {
+          if (particles[j].squared_distance(centre) < cone*cone) {
+            CPPUNIT_ASSERT(std::binary_search(candidates.begin(), candidates.end(), j));
+          }
+        }
+      }
+    }
+  }
+}
+
+void testPuppiNeighbourGrid::testWeights() {
+  const edm::ParameterSet config = puppiConfig();
+  PuppiContainer onGrid(config);
+  PuppiContainerPlainScan plainScan(config);
+
+  std::mt19937 rng(2049);
+  for (unsigned int iEvent = 0; iEvent < 20; ++iEvent) {
+    const std::vector<RecoObj> particles = randomEvent(rng, 100 + 150*iEvent);
+    onGrid.initialize(particles);
+    plainScan.initialize(particles);
+    onGrid.setNPV(20);
+    plainScan.setNPV(20);
+
+    const std::vector<double> &weights = onGrid.puppiWeights();
+    const std::vector<double> &reference = plainScan.puppiWeights();
+    CPPUNIT_ASSERT_EQUAL(particles.size(), weights.size());
+    CPPUNIT_ASSERT(identical(weights, reference));
+    CPPUNIT_ASSERT(identical(onGrid.puppiAlphas(), plainScan.puppiAlphas()));
+    CPPUNIT_ASSERT(identical(onGrid.puppiRawAlphas(), plainScan.puppiRawAlphas()));
+    CPPUNIT_ASSERT(identical(onGrid.puppiAlphasMed(), plainScan.puppiAlphasMed()));
+    CPPUNIT_ASSERT(identical(onGrid.puppiAlphasRMS(), plainScan.puppiAlphasRMS()));
+    // not all the weights are trivial
+    CPPUNIT_ASSERT(std::count_if(weights.begin(), weights.end(), [](double w) { return w > 0. && w < 1.; }) > 0);
+  }
+}
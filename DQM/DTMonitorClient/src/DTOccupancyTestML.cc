@@ -133,13 +133,11 @@ void DTOccupancyTestML::beginRun(const edm::Run& run, const EventSetup& context)
   // Get all the DT chambers
   vector<const DTChamber*> chambers = muonGeom->chambers();
 
-  // Load graph
+  // Get the session, its graph is parsed once and shared with the other users of the same graph
   tensorflow::setLogging("3");
   edm::FileInPath modelFilePath("DQM/DTMonitorClient/data/occupancy_cnn_v1.pb");
-  tensorflow::GraphDef* graphDef = tensorflow::loadGraphDef(modelFilePath.fullPath());
-
-  // Create session
-  tensorflow::Session* session = tensorflow::createSession(graphDef);
+  std::shared_ptr<tensorflow::Session> session =
+    tensorflow::SessionCache::instance().getSession(modelFilePath.fullPath());
 
   for(vector<const DTChamber*>::const_iterator chamber = chambers.begin();
       chamber != chambers.end(); ++chamber) {  // Loop over all chambers
@@ -153,7 +151,7 @@ void DTOccupancyTestML::beginRun(const edm::Run& run, const EventSetup& context)
       TH2F *histo = chamberOccupancyHisto->getTH2F();
 
       float chamberPercentage = 1.;
-      int result = runOccupancyTest(histo, chId, chamberPercentage, graphDef, session);
+      int result = runOccupancyTest(histo, chId, chamberPercentage, session.get());
       int sector = chId.sector();
 
       if(sector == 13) {
@@ -186,9 +184,8 @@ void DTOccupancyTestML::beginRun(const edm::Run& run, const EventSetup& context)
 
   }
 
-  // Clean up neural network graph
-  tensorflow::closeSession(session);
-  delete graphDef;
+  // Release the neural network session
+  session.reset();
 
   string nEvtsName = "DT/EventInfo/Counters/nProcessedEventsDigi";
 
@@ -301,7 +298,6 @@ int DTOccupancyTestML::getIntegral(TH2F *histo, int firstBinX, int lastBinX, int
 
 int DTOccupancyTestML::runOccupancyTest(TH2F *histo, const DTChamberId& chId,
                                         float& chamberPercentage,
-                                        tensorflow::GraphDef *graphDef,
                                         tensorflow::Session *session) {
 
   LogTrace("DTDQM|DTMonitorClient|DTOccupancyTestML")
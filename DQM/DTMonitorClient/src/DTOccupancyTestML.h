@@ -23,7 +23,7 @@
 
 #include <DQMServices/Core/interface/DQMEDHarvester.h>
 
-#include "PhysicsTools/TensorFlow/interface/TensorFlow.h"
+#include "PhysicsTools/TensorFlow/interface/SessionCache.h"
 
 #include "TH2F.h"
 
@@ -71,7 +71,7 @@ private:
   int getIntegral(TH2F *histo, int, int, int, int, bool);
 
   // Run the test on the occupancy histos
-  int runOccupancyTest(TH2F *histo, const DTChamberId& chId, float& chamberPercentage, tensorflow::GraphDef *graphDef, tensorflow::Session *session);
+  int runOccupancyTest(TH2F *histo, const DTChamberId& chId, float& chamberPercentage, tensorflow::Session *session);
 
   std::vector<float> interpolateLayers(std::vector<float> const& inputs, int size, int targetSize);
 
@@ -6,6 +6,10 @@
  *  Class representing the raw data for one FED.
  *  The raw data is owned as a binary buffer. It is required that the 
  *  lenght of the data is a multiple of the S-Link64 word lenght (8 byte).
+ *  Alternatively the data can be referenced in a buffer kept alive by a
+ *  shared holder (e.g. the input buffer of the source), without copy:
+ *  they are then copied into the owned buffer on the first non-const
+ *  access, and when written out (see FEDRawDataStreamer).
  *  The FED data should include the standard FED header and trailer.
  *
  *  \author G. Bruno - CERN, EP Division
@@ -16,6 +20,7 @@
 
 #include <vector>
 #include <cstddef>
+#include <memory>
 
 class FEDRawData {
 
@@ -31,6 +36,9 @@ class FEDRawData {
   /// word (8 bytes)
   FEDRawData(size_t newsize);
 
+  /// Ctor referencing size bytes at data, valid as long as holder
+  FEDRawData(const unsigned char * data, size_t size, std::shared_ptr<const void> holder);
+
   /// Copy constructor
   FEDRawData(const FEDRawData &);
 
@@ -44,7 +52,10 @@ class FEDRawData {
   unsigned char * data();
 
   /// Lenght of the data buffer in bytes
-  size_t size() const {return data_.size();}
+  size_t size() const {return external_ ? externalSize_ : data_.size();}
+
+  /// True if the data are referenced rather than owned
+  bool isExternal() const {return external_ != nullptr;}
     
   /// Resize to the specified size in bytes. It is required that 
   /// the size is a multiple of the size of a FED word (8 bytes)
@@ -52,9 +63,16 @@ class FEDRawData {
 
  private:
 
+  /// copy referenced data into data_
+  void own();
 
   Data data_;
 
+  // referenced data (transient)
+  const unsigned char * external_ = nullptr;
+  size_t externalSize_ = 0;
+  std::shared_ptr<const void> holder_;
+
 };
 
 #endif
@@ -0,0 +1,32 @@
+#ifndef FEDRawData_FEDRawDataStreamer_h
+#define FEDRawData_FEDRawDataStreamer_h
+
+/** \class FEDRawDataStreamer
+ *
+ *  ROOT streamer of FEDRawData: a FEDRawData referencing the buffer of
+ *  the source is written as an owning copy, so that the file content does
+ *  not depend on how the data were read in. Reading is unchanged.
+ *  To be installed (setFEDRawDataStreamerInTClass) by the sources that
+ *  produce referencing FEDRawData.
+ */
+
+#include "TClassStreamer.h"
+#include "TClassRef.h"
+
+class TBuffer;
+
+class FEDRawDataStreamer : public TClassStreamer {
+ public:
+  explicit FEDRawDataStreamer() : cl_("FEDRawData"){}
+
+  void operator() (TBuffer &R__b, void *objp) override;
+
+  TClassStreamer* Generate() const override;
+
+ private:
+  TClassRef cl_;
+};
+
+void setFEDRawDataStreamerInTClass();
+
+#endif
@@ -19,20 +19,36 @@ FEDRawData::FEDRawData(size_t newsize):data_(newsize){
   if (newsize%8!=0) throw cms::Exception("DataCorrupt") << "FEDRawData::resize: " << newsize << " is not a multiple of 8 bytes." << endl;
 }
 
-FEDRawData::FEDRawData(const FEDRawData &in) : data_(in.data_)
+FEDRawData::FEDRawData(const unsigned char * data, size_t size, std::shared_ptr<const void> holder):
+  external_(data), externalSize_(size), holder_(std::move(holder)){
+  if (size%8!=0) throw cms::Exception("DataCorrupt") << "FEDRawData::FEDRawData: " << size << " is not a multiple of 8 bytes." << endl;
+}
+
+FEDRawData::FEDRawData(const FEDRawData &in) :
+  data_(in.data_), external_(in.external_), externalSize_(in.externalSize_), holder_(in.holder_)
 {
 }
 FEDRawData::~FEDRawData()
 {
 }
-const unsigned char * FEDRawData::data()const {return &data_[0];}
+const unsigned char * FEDRawData::data()const {return external_ ? external_ : &data_[0];}
 
-unsigned char * FEDRawData::data() {return &data_[0];}
+unsigned char * FEDRawData::data() {own(); return &data_[0];}
 
 void FEDRawData::resize(size_t newsize) {
+  own();
+
   if (size()==newsize) return;
 
   data_.resize(newsize);
 
   if (newsize%8!=0) throw cms::Exception("DataCorrupt") << "FEDRawData::resize: " << newsize << " is not a multiple of 8 bytes." << endl;
 }
+
+void FEDRawData::own() {
+  if (!external_) return;
+  data_.assign(external_, external_+externalSize_);
+  external_ = nullptr;
+  externalSize_ = 0;
+  holder_.reset();
+}
@@ -0,0 +1,36 @@
+#include "DataFormats/FEDRawData/interface/FEDRawDataStreamer.h"
+#include "DataFormats/FEDRawData/interface/FEDRawData.h"
+#include "TBuffer.h"
+#include "TClass.h"
+
+#include <algorithm>
+
+void
+FEDRawDataStreamer::operator()(TBuffer &R__b, void *objp) {
+  if (R__b.IsReading()) {
+    cl_->ReadBuffer(R__b, objp);
+  } else {
+    const FEDRawData* obj = static_cast<const FEDRawData*>(objp);
+    if (obj->isExternal()) {
+      // write an owning copy, the product itself is left untouched
+      FEDRawData copy(obj->size());
+      std::copy(obj->data(), obj->data()+obj->size(), copy.data());
+      cl_->WriteBuffer(R__b, &copy);
+    } else {
+      cl_->WriteBuffer(R__b, objp);
+    }
+  }
+}
+
+TClassStreamer*
+FEDRawDataStreamer::Generate() const {
+  return new FEDRawDataStreamer(*this);
+}
+
+void setFEDRawDataStreamerInTClass() {
+  TClass *cl = TClass::GetClass("FEDRawData");
+  TClassStreamer *st = cl->GetStreamer();
+  if (st == nullptr) {
+    cl->AdoptStreamer(new FEDRawDataStreamer());
+  }
+}
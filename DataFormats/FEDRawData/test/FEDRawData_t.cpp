@@ -10,6 +10,8 @@
 #include <DataFormats/FEDRawData/interface/FEDRawData.h>
 
 #include <iostream>
+#include <memory>
+#include <vector>
 
 class testFEDRawData: public CppUnit::TestFixture {
 
@@ -17,6 +19,7 @@ class testFEDRawData: public CppUnit::TestFixture {
 
   CPPUNIT_TEST(testCtor);
   CPPUNIT_TEST(testdata);
+  CPPUNIT_TEST(testExternal);
  
   CPPUNIT_TEST_SUITE_END();
 
@@ -27,6 +30,7 @@ public:
   void tearDown(){}  
   void testCtor();
   void testdata(); 
+  void testExternal();
  
 }; 
 
@@ -56,5 +60,35 @@ void testFEDRawData::testdata(){
   CPPUNIT_ASSERT(buf[47] == 'c');
 }
 
+void testFEDRawData::testExternal(){
+  auto buffer = std::make_shared<std::vector<unsigned char> >(32,'x');
+  (*buffer)[8]='a';
+  FEDRawData f(buffer->data()+8, 16, buffer);
+  CPPUNIT_ASSERT(f.isExternal());
+  CPPUNIT_ASSERT(f.size()==size_t(16));
+  CPPUNIT_ASSERT(static_cast<const FEDRawData&>(f).data()==buffer->data()+8);
+
+  // the holder keeps the buffer alive
+  std::weak_ptr<std::vector<unsigned char> > alive(buffer);
+  buffer.reset();
+  CPPUNIT_ASSERT(!alive.expired());
+
+  // copies share the buffer
+  FEDRawData f2(f);
+  CPPUNIT_ASSERT(f2.isExternal());
+
+  // non-const access copies the data
+  f.data()[1]='b';
+  CPPUNIT_ASSERT(!f.isExternal());
+  CPPUNIT_ASSERT(f.size()==size_t(16));
+  CPPUNIT_ASSERT(f.data()[0]=='a');
+  CPPUNIT_ASSERT(static_cast<const FEDRawData&>(f2).data()[1]=='x');
+
+  f2.resize(24);
+  CPPUNIT_ASSERT(!f2.isExternal());
+  CPPUNIT_ASSERT(f2.data()[0]=='a');
+  CPPUNIT_ASSERT(alive.expired());
+}
+
 
 #include <Utilities/Testing/interface/CppUnit_testdriver.icpp>
@@ -58,6 +58,13 @@ public :
   */
   void unpack(const uint64_t* buffer, size_t bufferSize, unsigned int smId, unsigned int fedId);
 
+  /**
+     FED (DCC) and SM being unpacked: kept here rather than in the shared
+     mapper, so that one unpacker per thread can run on different FEDs
+  */
+  unsigned int getActiveDCC() const { return activeDCC_; }
+  unsigned int getActiveSM() const  { return activeSM_;  }
+
 
   /**
     Set the collection pointers
@@ -255,6 +262,8 @@ protected :
   std::unique_ptr<EcalPnDiodeDigiCollection>   * pnDiodeDigis_;
 
   EcalElectronicsMapper  * electronicsMapper_;
+  unsigned int             activeDCC_;
+  unsigned int             activeSM_;
   const EcalChannelStatusMap* chdb_;
   DCCEventBlock          * currentEvent_;
   DCCEBEventBlock        * ebEventBlock_;
@@ -57,12 +57,6 @@ public:
   void deletePointers();
   void resetPointers();
 
-  /**
-  * Set DCC id that is going to be unpacked for the event
-  */
-  bool setActiveDCC(unsigned int dccId); 
-
-
   /**
    * Receives a string with a path and checks if file is accessible
    */
@@ -93,7 +87,12 @@ public:
    */
   const std::map<unsigned int ,unsigned int>& getDCCMap() const { return myDCCMap_; }
   
-  DetId  * getDetIdPointer(unsigned int feChannel, unsigned int strip, unsigned int xtal){  return  xtalDetIds_[smId_-1][feChannel-1][strip-1][xtal-1];}
+  /**
+   * The mapper holds no per-FED state: the SM being unpacked is given by the
+   * caller (DCCDataUnpacker::getActiveSM()), so that several unpackers can
+   * share it and unpack different FEDs concurrently.
+   */
+  DetId  * getDetIdPointer(unsigned int smId, unsigned int feChannel, unsigned int strip, unsigned int xtal){  return  xtalDetIds_[smId-1][feChannel-1][strip-1][xtal-1];}
 	 
   EcalTrigTowerDetId * getTTDetIdPointer(unsigned int tccId, unsigned int tower){ return ttDetIds_[tccId-1][tower-1];}
 	 
@@ -115,14 +114,10 @@ public:
   // Changed by Ph.G. on July 1, 09: return a vector instead of a single
   // element. One SRF can be associated to two  supercrystals, because of
   // channel grouping.
-  std::vector<EcalSrFlag*> getSrFlagPointer(unsigned int feChannel){ return srFlags_[smId_-1][feChannel-1]; }
+  std::vector<EcalSrFlag*> getSrFlagPointer(unsigned int smId, unsigned int feChannel){ return srFlags_[smId-1][feChannel-1]; }
   
-  std::vector<unsigned int> * getTccs(unsigned int smId){ return mapSmIdToTccIds_[smId];}
+  std::vector<unsigned int> * getTccs(unsigned int smId) const;
 	
-  unsigned int getActiveDCC()                 { return dccId_;                      }
- 
-  unsigned int getActiveSM()                  { return smId_;                       }
-
   unsigned int numbXtalTSamples()             { return numbXtalTSamples_;           }
 
   unsigned int numbTriggerTSamples()          { return numbTriggerTSamples_;        }
@@ -185,10 +180,6 @@ private:
   
   std::map< unsigned int, std::vector<unsigned int> * > mapSmIdToTccIds_;
   
-  unsigned int dccId_;
-  
-  unsigned int smId_;
-  
   unsigned int unfilteredFEBlockLength_;
   
   unsigned int srpBlockLength_;
@@ -217,7 +208,7 @@ private:
 public:
   // check, does the given [FED (dcc), CCU (tower), VFE (strip)] belongs
   // to the list of VFEs with 'ghost' channels
-  bool isGhost(const int FED, const int CCU, const int VFE);
+  bool isGhost(const int FED, const int CCU, const int VFE) const;
   
 private:
   void setupGhostMap();
@@ -12,8 +12,223 @@
 #include "CondFormats/EcalObjects/interface/EcalChannelStatus.h"
 #include "CondFormats/DataRecord/interface/EcalChannelStatusRcd.h"
 
-#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
-#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "tbb/task_arena.h"
+#include "tbb/tbb.h"
+
+#include <algorithm>
+#include <numeric>
+
+// one unpacker with the collections it fills
+struct EcalRawToDigi::Lane {
+
+  explicit Lane(DCCDataUnpacker * u) : unpacker(u) {}
+
+  // create the collections of the event and set the unpacker pointers
+  void newCollections();
+
+  // unpack the FEDs [fedBegin,fedEnd)
+  void unpack(const FEDRawDataCollection& rawdata, const EcalElectronicsMapper& map);
+
+  // DetId order of the digis, to merge them with those of the other lanes
+  void sortDigis();
+
+  std::unique_ptr<DCCDataUnpacker> unpacker;
+
+  std::vector<int>::const_iterator fedBegin, fedEnd;
+
+  std::vector<unsigned int> ebOrder, eeOrder;
+
+  std::unique_ptr<EBDigiCollection> productDigisEB;
+  std::unique_ptr<EEDigiCollection> productDigisEE;
+  std::unique_ptr<EcalRawDataCollection> productDccHeaders;
+  std::unique_ptr<EBDetIdCollection> productInvalidGains;
+  std::unique_ptr<EBDetIdCollection> productInvalidGainsSwitch;
+  std::unique_ptr<EBDetIdCollection> productInvalidChIds;
+  std::unique_ptr<EEDetIdCollection> productInvalidEEGains;
+  std::unique_ptr<EEDetIdCollection> productInvalidEEGainsSwitch;
+  std::unique_ptr<EEDetIdCollection> productInvalidEEChIds;
+  std::unique_ptr<EBSrFlagCollection> productEBSrFlags;
+  std::unique_ptr<EESrFlagCollection> productEESrFlags;
+  std::unique_ptr<EcalTrigPrimDigiCollection> productEcalTps;
+  std::unique_ptr<EcalPSInputDigiCollection> productEcalPSs;
+  std::unique_ptr<EcalElectronicsIdCollection> productInvalidTTIds;
+  std::unique_ptr<EcalElectronicsIdCollection> productInvalidZSXtalIds;
+  std::unique_ptr<EcalElectronicsIdCollection> productInvalidBlockLengths;
+  std::unique_ptr<EcalPnDiodeDigiCollection> productPnDiodeDigis;
+  std::unique_ptr<EcalElectronicsIdCollection> productInvalidMemTtIds;
+  std::unique_ptr<EcalElectronicsIdCollection> productInvalidMemBlockSizes;
+  std::unique_ptr<EcalElectronicsIdCollection> productInvalidMemChIds;
+  std::unique_ptr<EcalElectronicsIdCollection> productInvalidMemGains;
+};
+
+namespace {
+
+  // indices of the digis of c in DetId order
+  void sortedOrder(const edm::DataFrameContainer& c, std::vector<unsigned int>& order) {
+    order.resize(c.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&c](unsigned int i, unsigned int j){ return c.id(i) < c.id(j); });
+  }
+
+  // k-way merge of the digis of the lanes, each read in its DetId order:
+  // every frame is copied once, straight to its place (as in sort())
+  template <typename T>
+  std::unique_ptr<T> mergeSorted(const std::vector<const T*>& in, const std::vector<const std::vector<unsigned int>*>& order) {
+    auto out = std::make_unique<T>(in.front()->stride());
+    size_t n = 0;
+    for (auto c : in) n += c->size();
+    out->reserve(n);
+    std::vector<size_t> pos(in.size(), 0);
+    while (true) {
+      int best = -1;
+      for (size_t k = 0; k < in.size(); ++k) {
+        if (pos[k] == order[k]->size()) continue;
+        if (best < 0 || in[k]->id((*order[k])[pos[k]]) < in[best]->id((*order[best])[pos[best]])) best = k;
+      }
+      if (best < 0) break;
+      const unsigned int i = (*order[best])[pos[best]++];
+      out->push_back(in[best]->id(i), in[best]->frame(i));
+    }
+    return out;
+  }
+
+  template <typename C>
+  void append(C& to, const C& from) {
+    for (auto const& x : from) to.push_back(x);
+  }
+
+}
+
+void EcalRawToDigi::Lane::newCollections()
+{
+  // create the collection of Ecal Digis
+  productDigisEB = std::make_unique<EBDigiCollection>();
+  productDigisEB->reserve(1700);
+  unpacker->setEBDigisCollection(&productDigisEB);
+  
+  // create the collection of Ecal Digis
+  productDigisEE = std::make_unique<EEDigiCollection>();
+  unpacker->setEEDigisCollection(&productDigisEE);
+  
+  // create the collection for headers
+  productDccHeaders = std::make_unique<EcalRawDataCollection>();
+  unpacker->setDccHeadersCollection(&productDccHeaders); 
+
+  // create the collection for invalid gains
+  productInvalidGains = std::make_unique<EBDetIdCollection>();
+  unpacker->setInvalidGainsCollection(&productInvalidGains); 
+
+  // create the collection for invalid gain Switch
+  productInvalidGainsSwitch = std::make_unique<EBDetIdCollection>();
+  unpacker->setInvalidGainsSwitchCollection(&productInvalidGainsSwitch);
+   
+  // create the collection for invalid chids
+  productInvalidChIds = std::make_unique<EBDetIdCollection>();
+  unpacker->setInvalidChIdsCollection(&productInvalidChIds);
+  
+  ///////////////// make EEDetIdCollections for these ones
+    
+  // create the collection for invalid gains
+  productInvalidEEGains = std::make_unique<EEDetIdCollection>();
+  unpacker->setInvalidEEGainsCollection(&productInvalidEEGains); 
+    
+  // create the collection for invalid gain Switch
+  productInvalidEEGainsSwitch = std::make_unique<EEDetIdCollection>();
+  unpacker->setInvalidEEGainsSwitchCollection(&productInvalidEEGainsSwitch);
+    
+  // create the collection for invalid chids
+  productInvalidEEChIds = std::make_unique<EEDetIdCollection>();
+  unpacker->setInvalidEEChIdsCollection(&productInvalidEEChIds);
+
+  ///////////////// make EEDetIdCollections for these ones    
+
+  // create the collection for EB srflags       
+  productEBSrFlags = std::make_unique<EBSrFlagCollection>();
+  unpacker->setEBSrFlagsCollection(&productEBSrFlags);
+  
+  // create the collection for EB srflags       
+  productEESrFlags = std::make_unique<EESrFlagCollection>();
+  unpacker->setEESrFlagsCollection(&productEESrFlags);
+
+  // create the collection for ecal trigger primitives
+  productEcalTps = std::make_unique<EcalTrigPrimDigiCollection>();
+  unpacker->setEcalTpsCollection(&productEcalTps);
+  /////////////////////// collections for problems pertaining towers are already EE+EB communal
+
+  // create the collection for ecal trigger primitives
+  productEcalPSs = std::make_unique<EcalPSInputDigiCollection>();
+  unpacker->setEcalPSsCollection(&productEcalPSs);
+  /////////////////////// collections for problems pertaining towers are already EE+EB communal
+
+  // create the collection for invalid TTIds
+  productInvalidTTIds = std::make_unique<EcalElectronicsIdCollection>();
+  unpacker->setInvalidTTIdsCollection(&productInvalidTTIds);
+ 
+   // create the collection for invalid TTIds
+  productInvalidZSXtalIds = std::make_unique<EcalElectronicsIdCollection>();
+  unpacker->setInvalidZSXtalIdsCollection(&productInvalidZSXtalIds);
+
+
+ 
+  // create the collection for invalid BlockLengths
+  productInvalidBlockLengths = std::make_unique<EcalElectronicsIdCollection>();
+  unpacker->setInvalidBlockLengthsCollection(&productInvalidBlockLengths);
+
+  // MEMs Collections
+  // create the collection for the Pn Diode Digis
+  productPnDiodeDigis = std::make_unique<EcalPnDiodeDigiCollection>();
+  unpacker->setPnDiodeDigisCollection(&productPnDiodeDigis);
+
+  // create the collection for invalid Mem Tt id 
+  productInvalidMemTtIds = std::make_unique<EcalElectronicsIdCollection>();
+  unpacker->setInvalidMemTtIdsCollection(& productInvalidMemTtIds);
+  
+  // create the collection for invalid Mem Block Size 
+  productInvalidMemBlockSizes = std::make_unique<EcalElectronicsIdCollection>();
+  unpacker->setInvalidMemBlockSizesCollection(& productInvalidMemBlockSizes);
+  
+  // create the collection for invalid Mem Block Size 
+  productInvalidMemChIds = std::make_unique<EcalElectronicsIdCollection>();
+  unpacker->setInvalidMemChIdsCollection(& productInvalidMemChIds);
+ 
+  // create the collection for invalid Mem Gain Errors 
+  productInvalidMemGains = std::make_unique<EcalElectronicsIdCollection>();
+  unpacker->setInvalidMemGainsCollection(& productInvalidMemGains);
+}
+
+void EcalRawToDigi::Lane::unpack(const FEDRawDataCollection& rawdata, const EcalElectronicsMapper& map)
+{
+  for (auto i=fedBegin; i!=fedEnd; i++) {
+
+    // get fed raw data and SM id
+    const FEDRawData& fedData = rawdata.FEDData(*i);
+    const size_t length = fedData.size();
+
+    LogDebug("EcalRawToDigi") << "raw data length: " << length ;
+    //if data size is not null interpret data
+    if ( length >= EMPTYEVENTSIZE ){
+
+      const int smId = map.getSMId(*i);
+      if(smId){
+
+        LogDebug("EcalRawToDigi") << "Getting FED = " << *i <<"(SM = "<<smId<<")"<<" data size is: " << length;
+
+        const uint64_t* data = (uint64_t*) fedData.data();
+        unpacker->unpack(data, length, smId, *i);
+
+        LogDebug("EcalRawToDigi") <<" in EE :"<<productDigisEE->size()
+                                  <<" in EB :"<<productDigisEB->size();
+      }
+    }
+
+  }// loop on FEDs
+}
+
+void EcalRawToDigi::Lane::sortDigis()
+{
+  sortedOrder(*productDigisEB, ebOrder);
+  sortedOrder(*productDigisEE, eeOrder);
+}
 
 EcalRawToDigi::EcalRawToDigi(edm::ParameterSet const& conf):
   
@@ -65,9 +280,7 @@ EcalRawToDigi::EcalRawToDigi(edm::ParameterSet const& conf):
 
 
 
-  myMap_(nullptr),
-  
-  theUnpacker_(nullptr)
+  myMap_(nullptr)
 
 {
   
@@ -179,8 +392,10 @@ EcalRawToDigi::EcalRawToDigi(edm::ParameterSet const& conf):
     //   <<conf.getParameter<std::string>("DCCMapFile");
   }
   
-  // Build a new ECAL DCC data unpacker
-  theUnpacker_ = new DCCDataUnpacker(myMap_,headerUnpacking_,srpUnpacking_,tccUnpacking_,feUnpacking_,memUnpacking_,syncCheck_,feIdCheck_,forceToKeepFRdata_);
+  // Build the ECAL DCC data unpackers, one per lane, sharing the mapper
+  const unsigned int nLanes = std::max(1u, conf.getParameter<unsigned int>("numberOfLanes"));
+  for (unsigned int l=0; l<nLanes; l++)
+    lanes_.push_back(std::make_unique<Lane>(new DCCDataUnpacker(myMap_,headerUnpacking_,srpUnpacking_,tccUnpacking_,feUnpacking_,memUnpacking_,syncCheck_,feIdCheck_,forceToKeepFRdata_)));
    
 }
 
@@ -278,6 +493,7 @@ void EcalRawToDigi::fillDescriptions(edm::ConfigurationDescriptions& description
   desc.add<bool>("forceToKeepFRData",false);
   desc.add<bool>("headerUnpacking",true);
   desc.add<bool>("memUnpacking",true);
+  desc.add<unsigned int>("numberOfLanes",1)->setComment("number of FED slices unpacked concurrently");
   descriptions.add("ecalRawToDigi",desc);
 }
 
@@ -287,13 +503,13 @@ void EcalRawToDigi::beginRun(const edm::Run&, const edm::EventSetup& es)
   // channel status database
   edm::ESHandle<EcalChannelStatusMap> pChStatus;
   es.get<EcalChannelStatusRcd>().get(pChStatus);
-  theUnpacker_->setChannelStatusDB(pChStatus.product());
+  for (auto& lane : lanes_) lane->unpacker->setChannelStatusDB(pChStatus.product());
   
   // uncomment following line to print list of crystals with bad status
   //edm::ESHandle<EcalElectronicsMapping> pEcalMapping;
   //es.get<EcalMappingRcd>().get(pEcalMapping);
   //const EcalElectronicsMapping* mapping = pEcalMapping.product();
-  //printStatusRecords(theUnpacker_, mapping);
+  //printStatusRecords(lanes_.front()->unpacker.get(), mapping);
 }
 
 
@@ -340,135 +556,83 @@ void EcalRawToDigi::produce(edm::Event& e, const edm::EventSetup& es)
   e.getByToken(dataToken_,rawdata);
 
 
-  // Step B: encapsulate vectors in actual collections and set unpacker pointers
-
-  // create the collection of Ecal Digis
-  auto productDigisEB = std::make_unique<EBDigiCollection>();
-  productDigisEB->reserve(1700);
-  theUnpacker_->setEBDigisCollection(&productDigisEB);
-  
-  // create the collection of Ecal Digis
-  auto productDigisEE = std::make_unique<EEDigiCollection>();
-  theUnpacker_->setEEDigisCollection(&productDigisEE);
-  
-  // create the collection for headers
-  auto productDccHeaders = std::make_unique<EcalRawDataCollection>();
-  theUnpacker_->setDccHeadersCollection(&productDccHeaders); 
-
-  // create the collection for invalid gains
-  auto productInvalidGains = std::make_unique<EBDetIdCollection>();
-  theUnpacker_->setInvalidGainsCollection(&productInvalidGains); 
-
-  // create the collection for invalid gain Switch
-  auto productInvalidGainsSwitch = std::make_unique<EBDetIdCollection>();
-  theUnpacker_->setInvalidGainsSwitchCollection(&productInvalidGainsSwitch);
-   
-  // create the collection for invalid chids
-  auto productInvalidChIds = std::make_unique<EBDetIdCollection>();
-  theUnpacker_->setInvalidChIdsCollection(&productInvalidChIds);
-  
-  ///////////////// make EEDetIdCollections for these ones
-    
-  // create the collection for invalid gains
-  auto productInvalidEEGains = std::make_unique<EEDetIdCollection>();
-  theUnpacker_->setInvalidEEGainsCollection(&productInvalidEEGains); 
-    
-  // create the collection for invalid gain Switch
-  auto productInvalidEEGainsSwitch = std::make_unique<EEDetIdCollection>();
-  theUnpacker_->setInvalidEEGainsSwitchCollection(&productInvalidEEGainsSwitch);
-    
-  // create the collection for invalid chids
-  auto productInvalidEEChIds = std::make_unique<EEDetIdCollection>();
-  theUnpacker_->setInvalidEEChIdsCollection(&productInvalidEEChIds);
-
-  ///////////////// make EEDetIdCollections for these ones    
-
-  // create the collection for EB srflags       
-  auto productEBSrFlags = std::make_unique<EBSrFlagCollection>();
-  theUnpacker_->setEBSrFlagsCollection(&productEBSrFlags);
-  
-  // create the collection for EB srflags       
-  auto productEESrFlags = std::make_unique<EESrFlagCollection>();
-  theUnpacker_->setEESrFlagsCollection(&productEESrFlags);
-
-  // create the collection for ecal trigger primitives
-  auto productEcalTps = std::make_unique<EcalTrigPrimDigiCollection>();
-  theUnpacker_->setEcalTpsCollection(&productEcalTps);
-  /////////////////////// collections for problems pertaining towers are already EE+EB communal
+  // Step B: share the requested FEDs among the lanes, encapsulate vectors
+  // in actual collections and set unpacker pointers
 
-  // create the collection for ecal trigger primitives
-  auto productEcalPSs = std::make_unique<EcalPSInputDigiCollection>();
-  theUnpacker_->setEcalPSsCollection(&productEcalPSs);
-  /////////////////////// collections for problems pertaining towers are already EE+EB communal
-
-  // create the collection for invalid TTIds
-  auto productInvalidTTIds = std::make_unique<EcalElectronicsIdCollection>();
-  theUnpacker_->setInvalidTTIdsCollection(&productInvalidTTIds);
- 
-   // create the collection for invalid TTIds
-  auto productInvalidZSXtalIds = std::make_unique<EcalElectronicsIdCollection>();
-  theUnpacker_->setInvalidZSXtalIdsCollection(&productInvalidZSXtalIds);
-
-
- 
-  // create the collection for invalid BlockLengths
-  auto productInvalidBlockLengths = std::make_unique<EcalElectronicsIdCollection>();
-  theUnpacker_->setInvalidBlockLengthsCollection(&productInvalidBlockLengths);
-
-  // MEMs Collections
-  // create the collection for the Pn Diode Digis
-  auto productPnDiodeDigis = std::make_unique<EcalPnDiodeDigiCollection>();
-  theUnpacker_->setPnDiodeDigisCollection(&productPnDiodeDigis);
-
-  // create the collection for invalid Mem Tt id 
-  auto productInvalidMemTtIds = std::make_unique<EcalElectronicsIdCollection>();
-  theUnpacker_->setInvalidMemTtIdsCollection(& productInvalidMemTtIds);
-  
-  // create the collection for invalid Mem Block Size 
-  auto productInvalidMemBlockSizes = std::make_unique<EcalElectronicsIdCollection>();
-  theUnpacker_->setInvalidMemBlockSizesCollection(& productInvalidMemBlockSizes);
-  
-  // create the collection for invalid Mem Block Size 
-  auto productInvalidMemChIds = std::make_unique<EcalElectronicsIdCollection>();
-  theUnpacker_->setInvalidMemChIdsCollection(& productInvalidMemChIds);
- 
-  // create the collection for invalid Mem Gain Errors 
-  auto productInvalidMemGains = std::make_unique<EcalElectronicsIdCollection>();
-  theUnpacker_->setInvalidMemGainsCollection(& productInvalidMemGains); 
-  //  double TIME_START = clock(); 
-  
-
-  // Step C: unpack all requested FEDs    
+  fedsToUnpack_.clear();
   for (std::vector<int>::const_iterator i=fedUnpackList_.begin(); i!=fedUnpackList_.end(); i++) {
 
     if (REGIONAL_) {
       std::vector<int>::const_iterator fed_it = find(FEDS_to_unpack.begin(), FEDS_to_unpack.end(), *i);
       if (fed_it == FEDS_to_unpack.end()) continue;
     }
+    fedsToUnpack_.push_back(*i);
+  }
 
-  
-    // get fed raw data and SM id
-    const FEDRawData& fedData = rawdata->FEDData(*i);
-    const size_t length = fedData.size();
-
-    LogDebug("EcalRawToDigi") << "raw data length: " << length ;
-    //if data size is not null interpret data
-    if ( length >= EMPTYEVENTSIZE ){
-      
-      if(myMap_->setActiveDCC(*i)){
+  const size_t nFeds = fedsToUnpack_.size();
+  const size_t nLanes = std::max(size_t(1), std::min(lanes_.size(), nFeds));
+  for (size_t l=0; l<nLanes; ++l) {
+    lanes_[l]->fedBegin = fedsToUnpack_.begin() + l*nFeds/nLanes;
+    lanes_[l]->fedEnd   = fedsToUnpack_.begin() + (l+1)*nFeds/nLanes;
+    lanes_[l]->newCollections();
+  }
 
-        const int smId = myMap_->getActiveSM();
-        LogDebug("EcalRawToDigi") << "Getting FED = " << *i <<"(SM = "<<smId<<")"<<" data size is: " << length;
+  //  double TIME_START = clock(); 
+  
 
-        const uint64_t* data = (uint64_t*) fedData.data();
-        theUnpacker_->unpack(data, length, smId, *i);
+  // Step C: unpack all requested FEDs, the lanes concurrently
+  if (nLanes == 1) {
+    lanes_[0]->unpack(*rawdata, *myMap_);
+  } else {
+    tbb::this_task_arena::isolate([&] {
+      tbb::parallel_for(size_t(0), nLanes, [&](size_t l) {
+        lanes_[l]->unpack(*rawdata, *myMap_);
+        lanes_[l]->sortDigis();
+      });
+    });
+  }
 
-        LogDebug("EcalRawToDigi") <<" in EE :"<<productDigisEE->size()
-                                  <<" in EB :"<<productDigisEB->size();
-      }
+  // merge into the collections of the first lane: the digis in DetId order,
+  // the others appended in the FED order, as if unpacked by a single lane
+  Lane& out = *lanes_[0];
+  if (nLanes > 1) {
+    std::vector<const EBDigiCollection*> digisEB;
+    std::vector<const EEDigiCollection*> digisEE;
+    std::vector<const std::vector<unsigned int>*> orderEB, orderEE;
+    for (size_t l=0; l<nLanes; ++l) {
+      digisEB.push_back(lanes_[l]->productDigisEB.get());
+      digisEE.push_back(lanes_[l]->productDigisEE.get());
+      orderEB.push_back(&lanes_[l]->ebOrder);
+      orderEE.push_back(&lanes_[l]->eeOrder);
     }
-    
-  }// loop on FEDs
+    auto mergedEB = mergeSorted(digisEB, orderEB);
+    auto mergedEE = mergeSorted(digisEE, orderEE);
+    out.productDigisEB = std::move(mergedEB);
+    out.productDigisEE = std::move(mergedEE);
+
+    for (size_t l=1; l<nLanes; ++l) {
+      const Lane& lane = *lanes_[l];
+      append(*out.productDccHeaders, *lane.productDccHeaders);
+      append(*out.productInvalidGains, *lane.productInvalidGains);
+      append(*out.productInvalidGainsSwitch, *lane.productInvalidGainsSwitch);
+      append(*out.productInvalidChIds, *lane.productInvalidChIds);
+      append(*out.productInvalidEEGains, *lane.productInvalidEEGains);
+      append(*out.productInvalidEEGainsSwitch, *lane.productInvalidEEGainsSwitch);
+      append(*out.productInvalidEEChIds, *lane.productInvalidEEChIds);
+      append(*out.productEBSrFlags, *lane.productEBSrFlags);
+      append(*out.productEESrFlags, *lane.productEESrFlags);
+      append(*out.productEcalTps, *lane.productEcalTps);
+      append(*out.productEcalPSs, *lane.productEcalPSs);
+      append(*out.productInvalidTTIds, *lane.productInvalidTTIds);
+      append(*out.productInvalidZSXtalIds, *lane.productInvalidZSXtalIds);
+      append(*out.productInvalidBlockLengths, *lane.productInvalidBlockLengths);
+      append(*out.productPnDiodeDigis, *lane.productPnDiodeDigis);
+      append(*out.productInvalidMemTtIds, *lane.productInvalidMemTtIds);
+      append(*out.productInvalidMemBlockSizes, *lane.productInvalidMemBlockSizes);
+      append(*out.productInvalidMemChIds, *lane.productInvalidMemChIds);
+      append(*out.productInvalidMemGains, *lane.productInvalidMemGains);
+    }
+  }
   
   //if(nevts_>1){   //NUNO
   //  double TIME_END = clock(); //NUNO
@@ -481,40 +645,41 @@ void EcalRawToDigi::produce(edm::Event& e, const edm::EventSetup& es)
   if(put_){
     
     if( headerUnpacking_){ 
-      e.put(std::move(productDccHeaders));
+      e.put(std::move(out.productDccHeaders));
     }
     
     if(feUnpacking_){
-      productDigisEB->sort();
-      e.put(std::move(productDigisEB),"ebDigis");
-      productDigisEE->sort();
-      e.put(std::move(productDigisEE),"eeDigis");
-      e.put(std::move(productInvalidGains),"EcalIntegrityGainErrors");
-      e.put(std::move(productInvalidGainsSwitch), "EcalIntegrityGainSwitchErrors");
-      e.put(std::move(productInvalidChIds), "EcalIntegrityChIdErrors");
+      // already in DetId order if merged from several lanes
+      if (nLanes == 1) out.productDigisEB->sort();
+      e.put(std::move(out.productDigisEB),"ebDigis");
+      if (nLanes == 1) out.productDigisEE->sort();
+      e.put(std::move(out.productDigisEE),"eeDigis");
+      e.put(std::move(out.productInvalidGains),"EcalIntegrityGainErrors");
+      e.put(std::move(out.productInvalidGainsSwitch), "EcalIntegrityGainSwitchErrors");
+      e.put(std::move(out.productInvalidChIds), "EcalIntegrityChIdErrors");
       // EE (leaving for now the same names as in EB)
-      e.put(std::move(productInvalidEEGains),"EcalIntegrityGainErrors");
-      e.put(std::move(productInvalidEEGainsSwitch), "EcalIntegrityGainSwitchErrors");
-      e.put(std::move(productInvalidEEChIds), "EcalIntegrityChIdErrors");
+      e.put(std::move(out.productInvalidEEGains),"EcalIntegrityGainErrors");
+      e.put(std::move(out.productInvalidEEGainsSwitch), "EcalIntegrityGainSwitchErrors");
+      e.put(std::move(out.productInvalidEEChIds), "EcalIntegrityChIdErrors");
       // EE
-      e.put(std::move(productInvalidTTIds),"EcalIntegrityTTIdErrors");
-      e.put(std::move(productInvalidZSXtalIds),"EcalIntegrityZSXtalIdErrors");
-      e.put(std::move(productInvalidBlockLengths),"EcalIntegrityBlockSizeErrors");
-      e.put(std::move(productPnDiodeDigis));
+      e.put(std::move(out.productInvalidTTIds),"EcalIntegrityTTIdErrors");
+      e.put(std::move(out.productInvalidZSXtalIds),"EcalIntegrityZSXtalIdErrors");
+      e.put(std::move(out.productInvalidBlockLengths),"EcalIntegrityBlockSizeErrors");
+      e.put(std::move(out.productPnDiodeDigis));
     }
     if(memUnpacking_){
-      e.put(std::move(productInvalidMemTtIds),"EcalIntegrityMemTtIdErrors");
-      e.put(std::move(productInvalidMemBlockSizes),"EcalIntegrityMemBlockSizeErrors");
-      e.put(std::move(productInvalidMemChIds),"EcalIntegrityMemChIdErrors");
-      e.put(std::move(productInvalidMemGains),"EcalIntegrityMemGainErrors");
+      e.put(std::move(out.productInvalidMemTtIds),"EcalIntegrityMemTtIdErrors");
+      e.put(std::move(out.productInvalidMemBlockSizes),"EcalIntegrityMemBlockSizeErrors");
+      e.put(std::move(out.productInvalidMemChIds),"EcalIntegrityMemChIdErrors");
+      e.put(std::move(out.productInvalidMemGains),"EcalIntegrityMemGainErrors");
     }
     if(srpUnpacking_){
-      e.put(std::move(productEBSrFlags));
-      e.put(std::move(productEESrFlags));
+      e.put(std::move(out.productEBSrFlags));
+      e.put(std::move(out.productEESrFlags));
     }
     if(tccUnpacking_){
-      e.put(std::move(productEcalTps),"EcalTriggerPrimitives");
-      e.put(std::move(productEcalPSs),"EcalPseudoStripInputs");
+      e.put(std::move(out.productEcalTps),"EcalTriggerPrimitives");
+      e.put(std::move(out.productEcalPSs),"EcalPseudoStripInputs");
     }
   }
   
@@ -542,6 +707,5 @@ EcalRawToDigi::~EcalRawToDigi()
   
   
   if(myMap_      ) delete myMap_;
-  if(theUnpacker_) delete theUnpacker_;
   
 }
@@ -33,6 +33,8 @@
 #include <FWCore/Framework/interface/ESWatcher.h>
 #include "DataFormats/EcalRawData/interface/EcalListOfFEDS.h"
 #include <sys/time.h>
+#include <memory>
+#include <vector>
 
 class EcalElectronicsMapper;
 class EcalElectronicsMapping;
@@ -97,8 +99,12 @@ class EcalRawToDigi : public edm::stream::EDProducer<>{
   //an electronics mapper class 
   EcalElectronicsMapper * myMap_;
   
-  //Ecal unpacker
-  DCCDataUnpacker * theUnpacker_;
+  //Ecal unpackers: the FEDs of the event are shared among the lanes in
+  //contiguous slices and unpacked concurrently, each lane with its own
+  //unpacker and collections, then merged in the FED order
+  struct Lane;
+  std::vector<std::unique_ptr<Lane> > lanes_;
+  std::vector<int> fedsToUnpack_;
   
   unsigned int nevts_; // NA: for testing
   double  RUNNING_TIME_, SETUP_TIME_;
@@ -12,6 +12,9 @@ DCCDataUnpacker::DCCDataUnpacker(
   EcalElectronicsMapper * mapper, bool hU, bool srpU, bool tccU, bool feU , bool memU, bool syncCheck, bool feIdCheck, bool forceToKeepFRdata
 ){ 
   electronicsMapper_ = mapper;
+  activeDCC_ = 0;
+  activeSM_  = 0;
+  chdb_      = nullptr;
   ebEventBlock_   = new DCCEBEventBlock(this,mapper,hU,srpU,tccU,feU,memU,forceToKeepFRdata);
   eeEventBlock_   = new DCCEEEventBlock(this,mapper,hU,srpU,tccU,feU,memU,forceToKeepFRdata);
   if(syncCheck){
@@ -28,6 +31,8 @@ DCCDataUnpacker::DCCDataUnpacker(
 void DCCDataUnpacker::unpack(const uint64_t* buffer, size_t bufferSize, unsigned int smId, unsigned int fedId){
   //buffer is pointer to binary data
   //See if this fed is on EB or in EE
+  activeDCC_ = fedId;
+  activeSM_  = smId;
 
   if(smId>9&&smId<46){ 
     
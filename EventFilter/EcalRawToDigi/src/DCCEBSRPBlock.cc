@@ -42,7 +42,7 @@ void DCCEBSRPBlock::addSRFlagToCollection(){
     unsigned int theSRPi = n ;
 
 
-    if(NUMB_SM_EB_PLU_MIN<= mapper_->getActiveSM() && mapper_->getActiveSM()<=NUMB_SM_EB_PLU_MAX && fov>=1 ){
+    if(NUMB_SM_EB_PLU_MIN<= unpacker_->getActiveSM() && unpacker_->getActiveSM()<=NUMB_SM_EB_PLU_MAX && fov>=1 ){
       unsigned int u   = n%towersInPhi;
       u        = towersInPhi-u;
       theSRPi  = ( n/towersInPhi )*towersInPhi + u - 1;
@@ -53,7 +53,7 @@ void DCCEBSRPBlock::addSRFlagToCollection(){
 
     if(unpackInternalData_){  
     
-      std::vector<EcalSrFlag*> srs = mapper_->getSrFlagPointer(theSRPi+1);
+      std::vector<EcalSrFlag*> srs = mapper_->getSrFlagPointer(unpacker_->getActiveSM(),theSRPi+1);
 
       for(size_t i = 0; i < srs.size(); ++i){
 	srs[i]->setValue(srFlag); 
@@ -73,7 +73,7 @@ bool DCCEBSRPBlock::checkSrpIdAndNumbSRFlags(){
   if (nSRFlags_ != expNumbSrFlags_) {
     if (! DCCDataUnpacker::silentMode_) {
       edm::LogWarning("IncorrectBlock")
-        <<"Unable to unpack SRP block for event " << event_->l1A()<<" in fed <<"<<mapper_->getActiveDCC()
+        <<"Unable to unpack SRP block for event " << event_->l1A()<<" in fed <<"<<unpacker_->getActiveDCC()
         <<"\nNumber of flags "<<nSRFlags_<<" is different from expected "<<expNumbSrFlags_;
      }
     //Note : add to error collection ?
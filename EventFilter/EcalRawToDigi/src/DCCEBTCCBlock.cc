@@ -16,13 +16,13 @@ void DCCEBTCCBlock::updateCollectors(){
 
 bool DCCEBTCCBlock::checkTccIdAndNumbTTs(){
 
-  expTccId_ = mapper_->getActiveSM()+TCCID_SMID_SHIFT_EB;
+  expTccId_ = unpacker_->getActiveSM()+TCCID_SMID_SHIFT_EB;
 
   if( tccId_ != expTccId_ ){
 
     if( ! DCCDataUnpacker::silentMode_ ){
       edm::LogWarning("IncorrectBlock")
-        <<"Error on event "<<event_->l1A()<<" with bx "<<event_->bx()<<" in fed "<<mapper_->getActiveDCC()
+        <<"Error on event "<<event_->l1A()<<" with bx "<<event_->bx()<<" in fed "<<unpacker_->getActiveDCC()
         <<"\n TCC id is "<<tccId_<<" while expected is "<<expTccId_
         <<"\n TCC Block Skipped ...";  
          //todo : add this to error colection
@@ -34,7 +34,7 @@ bool DCCEBTCCBlock::checkTccIdAndNumbTTs(){
   if( nTTs_ != expNumbTTs_ ){
     if( ! DCCDataUnpacker::silentMode_ ){
       edm::LogWarning("IncorrectBlock")
-       <<"Unable to unpack TCC block for event "<<event_->l1A()<<" in fed "<<mapper_->getActiveDCC()
+       <<"Unable to unpack TCC block for event "<<event_->l1A()<<" in fed "<<unpacker_->getActiveDCC()
        <<"\n Number of TTs "<<nTTs_<<" is different from expected "<<expNumbTTs_
        <<"\n TCC Block Skipped ..."; 
          //todo : add this to error colection
@@ -59,7 +59,7 @@ void DCCEBTCCBlock::addTriggerPrimitivesToCollection(){
 
     unsigned int theTT = i;
 
-    if(NUMB_SM_EB_PLU_MIN<= mapper_->getActiveSM() && mapper_->getActiveSM()<=NUMB_SM_EB_PLU_MAX)
+    if(NUMB_SM_EB_PLU_MIN<= unpacker_->getActiveSM() && unpacker_->getActiveSM()<=NUMB_SM_EB_PLU_MAX)
     {
         unsigned int u = (i-1)%towersInPhi;
         u      = towersInPhi-u;
@@ -30,7 +30,7 @@ void DCCEESRPBlock::addSRFlagToCollection(){
      unsigned short srFlag =  ( *my16Bitp_ >> ( (n-(n/4)*4) * 3 ) )  &  SRP_SRFLAG_MASK ;
      srFlags_[n] = srFlag;
      if(unpackInternalData_){
-       std::vector<EcalSrFlag*> srs = mapper_->getSrFlagPointer(n+1);
+       std::vector<EcalSrFlag*> srs = mapper_->getSrFlagPointer(unpacker_->getActiveSM(),n+1);
        for(size_t i = 0; i < srs.size(); ++i){
          srs[i]->setValue(srFlag); 
          (*eeSrFlagsDigis_)->push_back(*((EESrFlag*)srs[i]));
@@ -43,7 +43,7 @@ bool DCCEESRPBlock::checkSrpIdAndNumbSRFlags(){
 
   expNumbSrFlags_=36;//to be corrected
 
-  int dccId = mapper_->getActiveDCC() - 600;
+  int dccId = unpacker_->getActiveDCC() - 600;
   if (dccId == SECTOR_EEM_CCU_JUMP || dccId == SECTOR_EEP_CCU_JUMP) expNumbSrFlags_ = 41;
 
   //todo :  checks to be implemented...
@@ -32,7 +32,7 @@ void DCCEETCCBlock::addTriggerPrimitivesToCollection(){
     if( ! DCCDataUnpacker::silentMode_ ){
       edm::LogWarning("IncorrectEvent") 
         <<"\n FOV value in data is: " << dccFOV <<
-        "At event: "  <<event_->l1A()<<" with bx "<<event_->bx()<<" in fed <<"<<mapper_->getActiveDCC()
+        "At event: "  <<event_->l1A()<<" with bx "<<event_->bx()<<" in fed <<"<<unpacker_->getActiveDCC()
         <<"\n TCC id "<<tccId_<<" FOV "<< dccFOV << " which is not a foreseen value. Setting it to: " << dcc_FOV_2;
     }
     dccFOV=dcc_FOV_2;
@@ -186,7 +186,7 @@ bool DCCEETCCBlock::checkTccIdAndNumbTTs(){
         
   bool tccFound(false);
   bool errorOnNumbOfTTs(false);
-  const int  activeDCC =  mapper_->getActiveSM();
+  const int  activeDCC =  unpacker_->getActiveSM();
   std::vector<unsigned int> * m = mapper_->getTccs(activeDCC);
   std::vector<unsigned int>::iterator it;
   for(it= m->begin();it!=m->end();it++){
@@ -209,7 +209,7 @@ bool DCCEETCCBlock::checkTccIdAndNumbTTs(){
           if( nTTs_ != 28 && nTTs_ !=16 ){
             if( ! DCCDataUnpacker::silentMode_ ){
           edm::LogWarning("IncorrectBlock") 
-            <<"Error on event "<<event_->l1A()<<" with bx "<<event_->bx()<<" in fed <<"<<mapper_->getActiveDCC()
+            <<"Error on event "<<event_->l1A()<<" with bx "<<event_->bx()<<" in fed <<"<<unpacker_->getActiveDCC()
            <<"\n TCC id "<<tccId_<<" has "<<nTTs_<<" Trigger Towers (only 28 or 16 are the expected values in EE)"
            <<"\n => Skipping to next fed block...";
           errorOnNumbOfTTs = true; 
@@ -223,7 +223,7 @@ bool DCCEETCCBlock::checkTccIdAndNumbTTs(){
 
     if( ! DCCDataUnpacker::silentMode_ ){
       edm::LogWarning("IncorrectBlock") 
-        <<"Error on event "<<event_->l1A()<<" with bx "<<event_->bx()<<" in fed <<"<<mapper_->getActiveDCC()
+        <<"Error on event "<<event_->l1A()<<" with bx "<<event_->bx()<<" in fed <<"<<unpacker_->getActiveDCC()
         <<"\n TCC id "<<tccId_<<" is not valid for this dcc "
         <<"\n => Skipping to next fed block...";
        //todo : add to error collection   
@@ -137,7 +137,7 @@ void DCCEventBlock::addHeaderToCollection(){
 
   // dccId is number internal to ECAL running 1.. 54.
   // convention is that dccId = (fed_id - 600)
-  int dccId = mapper_->getActiveSM();
+  int dccId = unpacker_->getActiveSM();
   // DCCHeaders follow  the same convenction
   theDCCheader.setId(dccId);
   
@@ -33,7 +33,7 @@ int DCCFEBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, bool zs,
   data_    = *data;
   dwToEnd_ = dwToEnd;
   
-  const unsigned int activeDCC = mapper_->getActiveSM();
+  const unsigned int activeDCC = unpacker_->getActiveSM();
 
   if( (*dwToEnd_)<1){
     if( ! DCCDataUnpacker::silentMode_ ){
@@ -75,7 +75,7 @@ int DCCFEBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, bool zs,
     if (! DCCDataUnpacker::silentMode_) {
       edm::LogWarning("IncorrectBlock")
         << "Expected tower ID is " << expTowerID_ << " while " << towerId_ << " was found"
-        << " (L1A " << event_->l1A() << " fed " << mapper_->getActiveDCC() << ")\n"
+        << " (L1A " << event_->l1A() << " fed " << unpacker_->getActiveDCC() << ")\n"
         << "  => Skipping to next FE block...";
     }
     
@@ -91,7 +91,7 @@ int DCCFEBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, bool zs,
            towerId_ > mapper_->getNumChannelsInDcc(activeDCC) ){ // fe_id must still be within range foreseen in the FED 
     if( ! DCCDataUnpacker::silentMode_ ){
       edm::LogWarning("IncorrectBlock")
-        <<"For event "<<event_->l1A()<<" and fed "<<mapper_->getActiveDCC()<<" (there's no check fe_id==dcc_channel)"
+        <<"For event "<<event_->l1A()<<" and fed "<<unpacker_->getActiveDCC()<<" (there's no check fe_id==dcc_channel)"
         <<"\n the FE_id found: "<<towerId_<<" exceeds max number of FE foreseen in fed"
         <<"\n => Skipping to next FE block...";
     }
@@ -112,7 +112,7 @@ int DCCFEBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, bool zs,
         
         edm::LogWarning("IncorrectBlock")
           << "Synchronization error for Tower Block"
-          << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << mapper_->getActiveDCC() << " tower " << towerId_ << ")\n"
+          << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << unpacker_->getActiveDCC() << " tower " << towerId_ << ")\n"
           << "  dccBx = " << dccBx << " bx_ = " << bx_ << " dccL1 = " << dccL1 << " l1_ = " << l1_ << "\n"
           << "  => Skipping to next tower block";
       }
@@ -127,7 +127,7 @@ int DCCFEBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, bool zs,
   if( nTSamples_ != expXtalTSamples_ ){
     if( ! DCCDataUnpacker::silentMode_ ){
       edm::LogWarning("IncorrectBlock")
-        <<"Unable to unpack Tower Block "<<towerId_<<" for event L1A "<<event_->l1A()<<" in fed "<<mapper_->getActiveDCC()
+        <<"Unable to unpack Tower Block "<<towerId_<<" for event L1A "<<event_->l1A()<<" in fed "<<unpacker_->getActiveDCC()
         <<"\n Number of time samples "<<nTSamples_<<" is not the same as expected ("<<expXtalTSamples_<<")"
         <<"\n => Skipping to next tower block...";
      } 
@@ -143,7 +143,7 @@ int DCCFEBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, bool zs,
   if((*dwToEnd_)<blockLength_){
     if( ! DCCDataUnpacker::silentMode_ ){
       edm::LogWarning("IncorrectEvent")
-        <<"\n Unable to unpack Tower Block "<<towerId_<<" for event L1A "<<event_->l1A()<<" in fed "<<mapper_->getActiveDCC()
+        <<"\n Unable to unpack Tower Block "<<towerId_<<" for event L1A "<<event_->l1A()<<" in fed "<<unpacker_->getActiveDCC()
         <<"\n Only "<<((*dwToEnd_)*8)<<" bytes are available while "<<blockSize_<<" are needed!"
         <<"\n => Skipping to next fed block...";
     }
@@ -157,7 +157,7 @@ int DCCFEBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, bool zs,
     if ( unfilteredDataBlockLength_ != blockLength_ ){
       if( ! DCCDataUnpacker::silentMode_ ){ 
         edm::LogWarning("IncorrectEvent")
-          <<"\n For event L1A "<<event_->l1A()<<", fed "<<mapper_->getActiveDCC()<<" and tower "<<towerId_
+          <<"\n For event L1A "<<event_->l1A()<<", fed "<<unpacker_->getActiveDCC()<<" and tower "<<towerId_
           <<"\n Expected block size is "<<(unfilteredDataBlockLength_*8)<<" bytes while "<<(blockLength_*8)<<" was found"
           <<"\n => Skipping to next fed block...";
        }
@@ -177,7 +177,7 @@ int DCCFEBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, bool zs,
      if ( unfilteredDataBlockLength_ != blockLength_ ){
       if( ! DCCDataUnpacker::silentMode_ ){ 
         edm::LogWarning("IncorrectBlock")
-          <<"For event L1A "<<event_->l1A()<<", fed "<<mapper_->getActiveDCC()<<" and tower "<<towerId_
+          <<"For event L1A "<<event_->l1A()<<", fed "<<unpacker_->getActiveDCC()<<" and tower "<<towerId_
           <<"\n Expected block size is "<<(unfilteredDataBlockLength_*8)<<" bytes while "<<(blockLength_*8)<<" was found"
           <<"\n => Keeps unpacking as the unpacker was forced to keep FR data (by configuration) ...";
        }
@@ -189,7 +189,7 @@ int DCCFEBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, bool zs,
   else if( blockLength_ > unfilteredDataBlockLength_ || (blockLength_-1) < numbDWInXtalBlock_ ){
     if( ! DCCDataUnpacker::silentMode_ ){
       edm::LogWarning("IncorrectEvent")
-        <<"\n For event L1A "<<event_->l1A()<<" and fed "<<mapper_->getActiveDCC()
+        <<"\n For event L1A "<<event_->l1A()<<" and fed "<<unpacker_->getActiveDCC()
         <<"\n The tower "<<towerId_<<" has a wrong number of bytes : "<<(blockLength_*8)           
         <<"\n => Skipping to next fed block...";
      }
@@ -236,7 +236,7 @@ int DCCFEBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, bool zs,
       {
         if( ! DCCDataUnpacker::silentMode_ ){
             edm::LogWarning("IncorrectBlock")
-            <<"For event L1A "<<event_->l1A()<<" and fed "<<mapper_->getActiveDCC()
+            <<"For event L1A "<<event_->l1A()<<" and fed "<<unpacker_->getActiveDCC()
             <<"\n The tower "<<towerId_<<" won't be unpacked further";
         }
       }
@@ -49,7 +49,7 @@ int DCCMemBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, unsigned
   if( (*dwToEnd_)<1){
     if( ! DCCDataUnpacker::silentMode_ ){
       edm::LogWarning("IncorrectEvent")
-        <<"\nUnable to unpack MEM block for event "<<event_->l1A()<<" in fed "<<mapper_->getActiveDCC()
+        <<"\nUnable to unpack MEM block for event "<<event_->l1A()<<" in fed "<<unpacker_->getActiveDCC()
         <<"\nThe end of event was reached !";
     }
     return STOP_EVENT_UNPACKING;
@@ -79,11 +79,11 @@ int DCCMemBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, unsigned
   if ( unfilteredTowerBlockLength_ != blockLength_ ){    
    
     // chosing channel 1 as representative of a dummy...
-    EcalElectronicsId id( mapper_->getActiveSM() , expTowerID_,1, 1);
+    EcalElectronicsId id( unpacker_->getActiveSM() , expTowerID_,1, 1);
     (*invalidMemBlockSizes_)->push_back(id);
     if( ! DCCDataUnpacker::silentMode_ ){ 
       edm::LogWarning("IncorrectEvent")
-        <<"\nFor event "<<event_->l1A()<<", fed "<<mapper_->getActiveDCC()<<" and tower block "<<towerId_
+        <<"\nFor event "<<event_->l1A()<<", fed "<<unpacker_->getActiveDCC()<<" and tower block "<<towerId_
         <<"\nExpected mem block size is "<<(unfilteredTowerBlockLength_*8)<<" bytes while "<<(blockLength_*8)<<" was found";
     }
     return STOP_EVENT_UNPACKING;
@@ -94,11 +94,11 @@ int DCCMemBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, unsigned
   if((*dwToEnd_)<blockLength_){
     if( ! DCCDataUnpacker::silentMode_ ){
       edm::LogWarning("IncorrectEvent")
-        <<"\nUnable to unpack MEM block for event "<<event_->l1A()<<" in fed "<<mapper_->getActiveDCC()
+        <<"\nUnable to unpack MEM block for event "<<event_->l1A()<<" in fed "<<unpacker_->getActiveDCC()
         <<"\n Only "<<((*dwToEnd_)*8)<<" bytes are available while "<<(blockLength_*8)<<" are needed!";
       // chosing channel 1 as representative of a dummy...
     } 
-    EcalElectronicsId id( mapper_->getActiveSM() , expTowerID_,1, 1);
+    EcalElectronicsId id( unpacker_->getActiveSM() , expTowerID_,1, 1);
     (*invalidMemBlockSizes_)->push_back(id);
     return STOP_EVENT_UNPACKING;
   }
@@ -113,7 +113,7 @@ int DCCMemBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, unsigned
       if( ! DCCDataUnpacker::silentMode_ ){
         edm::LogWarning("IncorrectEvent")
           << "Synchronization error for Mem block"
-          << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << mapper_->getActiveDCC() << ")\n"
+          << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << unpacker_->getActiveDCC() << ")\n"
           << "  dccBx = " << dccBx << " bx_ = " << bx_ << " dccL1 = " << dccL1 << " l1_ = " << l1_ << "\n"
           << "  => Stop event unpacking";
       }
@@ -127,7 +127,7 @@ int DCCMemBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, unsigned
   if( nTSamples_ != expXtalTSamples_ ){
     if( ! DCCDataUnpacker::silentMode_ ){
       edm::LogWarning("IncorrectEvent")
-        <<"\nUnable to unpack MEM block for event "<<event_->l1A()<<" in fed "<<mapper_->getActiveDCC()
+        <<"\nUnable to unpack MEM block for event "<<event_->l1A()<<" in fed "<<unpacker_->getActiveDCC()
         <<"\nNumber of time samples "<<nTSamples_<<" is not the same as expected ("<<expXtalTSamples_<<")";
      }
     //Note : add to error collection ?		 
@@ -139,11 +139,11 @@ int DCCMemBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, unsigned
   if( expTowerID_ != towerId_){
     
     // chosing channel 1 as representative as a dummy...
-    EcalElectronicsId id( mapper_->getActiveSM() , expTowerID_, 1,1);
+    EcalElectronicsId id( unpacker_->getActiveSM() , expTowerID_, 1,1);
     (*invalidMemTtIds_)->push_back(id);
     if( ! DCCDataUnpacker::silentMode_ ){
       edm::LogWarning("IncorrectBlock")
-        <<"For event "<<event_->l1A()<<" and fed "<<mapper_->getActiveDCC() << " and sm: "  << mapper_->getActiveSM()
+        <<"For event "<<event_->l1A()<<" and fed "<<unpacker_->getActiveDCC() << " and sm: "  << unpacker_->getActiveSM()
         <<"\nExpected mem tower block is "<<expTowerID_<<" while "<<towerId_<<" was found ";
      }
     
@@ -181,7 +181,7 @@ void DCCMemBlock::unpackMemTowerData(){
 
   lastTowerBeforeMem_ = 0;
   // differentiating the barrel and the endcap case
-  if (9 < mapper_->getActiveSM() || mapper_->getActiveSM() < 46){
+  if (9 < unpacker_->getActiveSM() || unpacker_->getActiveSM() < 46){
     lastTowerBeforeMem_ = 69; }
   else {
     lastTowerBeforeMem_ = 69; } 
@@ -202,12 +202,12 @@ void DCCMemBlock::unpackMemTowerData(){
       if(expStripId != stripId || expXtalId != xtalId){
 
         // chosing channel and strip as EcalElectronicsId
-        EcalElectronicsId id( mapper_->getActiveSM() , towerId_, expStripId, expXtalId);
+        EcalElectronicsId id( unpacker_->getActiveSM() , towerId_, expStripId, expXtalId);
        (*invalidMemChIds_)->push_back(id);
       
         if( ! DCCDataUnpacker::silentMode_ ){
           edm::LogWarning("IncorrectBlock")
-            <<"For event "<<event_->l1A()<<", fed "<<mapper_->getActiveDCC()<<" and tower mem block "<<towerId_
+            <<"For event "<<event_->l1A()<<", fed "<<unpacker_->getActiveDCC()<<" and tower mem block "<<towerId_
             <<"\nThe expected strip is "<<expStripId<<" and "<<stripId<<" was found"
             <<"\nThe expected xtal  is "<<expXtalId <<" and "<<xtalId<<" was found";
         }
@@ -260,12 +260,12 @@ void DCCMemBlock::unpackMemTowerData(){
 			
         if( gain >= 2 ){
 
-          EcalElectronicsId id(mapper_->getActiveSM() , towerId_, stripId,xtalId);
+          EcalElectronicsId id(unpacker_->getActiveSM() , towerId_, stripId,xtalId);
           (*invalidMemGains_)->push_back(id);
           
            if( ! DCCDataUnpacker::silentMode_ ){
 	      edm::LogWarning("IncorrectGain")
-	       <<"For event "<<event_->l1A()<<", fed "<<mapper_->getActiveDCC()<<" , mem tower block "<<towerId_
+	       <<"For event "<<event_->l1A()<<", fed "<<unpacker_->getActiveDCC()<<" , mem tower block "<<towerId_
 	       <<"\nIn strip "<<stripId<<" xtal "<<xtalId<<" the gain is "<<gain<<" in sample "<<(i+1);
            }
 
@@ -296,13 +296,13 @@ void DCCMemBlock::fillPnDiodeDigisCollection(){
     // This means we all have 5 pns per tower 
 
     // solution before sending creation of PnDigi's in mapper as done with crystals
-    //     mapper_->getActiveSM()  : this is the 'dccid'
+    //     unpacker_->getActiveSM()  : this is the 'dccid'
     //     number ranging internally in ECAL from 1 to 54, according convention specified here:
     //     http://indico.cern.ch/getFile.py/access?contribId=0&resId=0&materialId=slides&confId=11621
 
-    //     mapper_->getActiveDCC() : this is the FED_id (601 - 654 for ECAL at CMS)
+    //     unpacker_->getActiveDCC() : this is the FED_id (601 - 654 for ECAL at CMS)
 
-    const int activeSM = mapper_->getActiveSM();
+    const int activeSM = unpacker_->getActiveSM();
     int subdet(0);
     if (NUMB_SM_EB_MIN_MIN <= activeSM && activeSM <= NUMB_SM_EB_PLU_MAX) {
       subdet = EcalBarrel;
@@ -45,14 +45,14 @@ int DCCSCBlock::unpackXtalData(unsigned int expStripID, unsigned int expXtalID){
 
     if( ! DCCDataUnpacker::silentMode_ ){         
       edm::LogWarning("IncorrectBlock")
-        <<"For event LV1: "<<event_->l1A()<<", fed "<<mapper_->getActiveDCC()<<" and tower "<<towerId_
+        <<"For event LV1: "<<event_->l1A()<<", fed "<<unpacker_->getActiveDCC()<<" and tower "<<towerId_
         <<"\n The expected strip is "<<expStripID<<" and "<<stripId<<" was found"
         <<"\n The expected xtal  is "<<expXtalID <<" and "<<xtalId<<" was found";        
      }
     
     
     // using expected cry_di to raise warning about xtal_id problem
-    pDetId_ = (EEDetId*) mapper_->getDetIdPointer(towerId_,expStripID,expXtalID);
+    pDetId_ = (EEDetId*) mapper_->getDetIdPointer(unpacker_->getActiveSM(),towerId_,expStripID,expXtalID);
     if(pDetId_) {  (*invalidChIds_)->push_back(*pDetId_); }
     
     
@@ -72,7 +72,7 @@ int DCCSCBlock::unpackXtalData(unsigned int expStripID, unsigned int expXtalID){
       
       if (! DCCDataUnpacker::silentMode_ ) {
         edm::LogWarning("IncorrectBlock")
-          <<"For event LV1: "<<event_->l1A()<<", fed "<<mapper_->getActiveDCC()<<" and tower "<<towerId_
+          <<"For event LV1: "<<event_->l1A()<<", fed "<<unpacker_->getActiveDCC()<<" and tower "<<towerId_
           <<"\n Invalid strip : "<<stripId<<" or xtal : "<<xtalId
           <<" ids ( last strip was: " << lastStripId_ << " last ch was: " << lastXtalId_ << ")";
        }
@@ -103,7 +103,7 @@ int DCCSCBlock::unpackXtalData(unsigned int expStripID, unsigned int expXtalID){
           if (! DCCDataUnpacker::silentMode_) {
             edm::LogWarning("IncorrectBlock")
               << "Xtal id was expected to increase but it didn't - last xtal id was " << lastXtalId_ << " while current xtal is " << xtalId
-              << " (LV1 " << event_->l1A() << " fed " << mapper_->getActiveDCC() << " tower " << towerId_ << ")";
+              << " (LV1 " << event_->l1A() << " fed " << unpacker_->getActiveDCC() << " tower " << towerId_ << ")";
           }
           
           int st = lastStripId_;
@@ -136,7 +136,7 @@ int DCCSCBlock::unpackXtalData(unsigned int expStripID, unsigned int expXtalID){
   // otherwise, assume channel_id is valid and proceed with making and checking the data frame
   if(errorOnXtal) return SKIP_BLOCK_UNPACKING;
   
-  pDetId_ = (EEDetId*) mapper_->getDetIdPointer(towerId_, stripId, xtalId);
+  pDetId_ = (EEDetId*) mapper_->getDetIdPointer(unpacker_->getActiveSM(),towerId_, stripId, xtalId);
   
   if(pDetId_){// checking that requested EEDetId exists
     
@@ -185,10 +185,10 @@ int DCCSCBlock::unpackXtalData(unsigned int expStripID, unsigned int expXtalID){
     if(firstGainZeroSampID<3) {isSaturation=false; }
 
     if (! DCCDataUnpacker::silentMode_) {
-      if (unpacker_->getChannelValue(mapper_->getActiveDCC(), towerId_, stripId, xtalId) != 10) {
+      if (unpacker_->getChannelValue(unpacker_->getActiveDCC(), towerId_, stripId, xtalId) != 10) {
         edm::LogWarning("IncorrectGain")
           << "Gain zero" << (isSaturation ? " with features of saturation" : "" ) << " was found in SC Block"
-          << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << mapper_->getActiveDCC()
+          << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << unpacker_->getActiveDCC()
           << " tower " << towerId_ << " strip " << stripId << " xtal " << xtalId << ")";
       }
     }
@@ -227,7 +227,7 @@ int DCCSCBlock::unpackXtalData(unsigned int expStripID, unsigned int expXtalID){
       if (! DCCDataUnpacker::silentMode_) {
         edm::LogWarning("IncorrectGain")
           << "A wrong gain transition switch was found for SC Block in strip " << stripId << " and xtal " << xtalId
-          << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << mapper_->getActiveDCC() << " tower " << towerId_ << ")";
+          << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << unpacker_->getActiveDCC() << " tower " << towerId_ << ")";
       }
       
       (*invalidGainsSwitch_)->push_back(*pDetId_);
@@ -245,14 +245,14 @@ int DCCSCBlock::unpackXtalData(unsigned int expStripID, unsigned int expXtalID){
   else {
     // in case EEDetId do not exist
     // In EE we may have crystals with no valid EEDetId
-    if (! mapper_->isGhost(mapper_->getActiveDCC(), towerId_, stripId)) { // check the VFE is not a 'ghost'
+    if (! mapper_->isGhost(unpacker_->getActiveDCC(), towerId_, stripId)) { // check the VFE is not a 'ghost'
       
       // this is real EE VFE - print warning
       if (! DCCDataUnpacker::silentMode_) {
         edm::LogWarning("IncorrectBlock")
           << "An EEDetId was requested that does not exist "
           << "(LV1 " << event_->l1A()
-          << " fed " << mapper_->getActiveDCC()
+          << " fed " << unpacker_->getActiveDCC()
           << " tower " << towerId_
           << " strip " << stripId
           << " xtal " << xtalId << ")";
@@ -269,7 +269,7 @@ int DCCSCBlock::unpackXtalData(unsigned int expStripID, unsigned int expXtalID){
 
 void DCCSCBlock::fillEcalElectronicsError( std::unique_ptr<EcalElectronicsIdCollection> * errorColection){
 
-  const int activeDCC = mapper_->getActiveSM();
+  const int activeDCC = unpacker_->getActiveSM();
 
   if ( (NUMB_SM_EE_MIN_MIN <=activeDCC && activeDCC<=NUMB_SM_EE_MIN_MAX) ||
          (NUMB_SM_EE_PLU_MIN <=activeDCC && activeDCC<=NUMB_SM_EE_PLU_MAX) ){
@@ -279,7 +279,7 @@ void DCCSCBlock::fillEcalElectronicsError( std::unique_ptr<EcalElectronicsIdColl
      if( ! DCCDataUnpacker::silentMode_ ){
        edm::LogWarning("IncorrectBlock")
          <<"For event "<<event_->l1A()<<" there's fed: "<< activeDCC
-         <<" activeDcc: "<<mapper_->getActiveSM()
+         <<" activeDcc: "<<unpacker_->getActiveSM()
          <<" but that activeDcc is not valid in EE.";
      }
   }
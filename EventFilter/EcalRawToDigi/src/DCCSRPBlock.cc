@@ -33,7 +33,7 @@ int DCCSRPBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, unsigned
     if( ! DCCDataUnpacker::silentMode_ ){ 
       edm::LogWarning("IncorrectEvent")
         <<"\n Event "<<l1_
-        <<"\n Unable to unpack SRP block for event "<<event_->l1A()<<" in fed <<"<<mapper_->getActiveDCC()
+        <<"\n Unable to unpack SRP block for event "<<event_->l1A()<<" in fed <<"<<unpacker_->getActiveDCC()
         <<"\n Only "<<((*dwToEnd_)*8)<<" bytes are available while "<<(blockLength_*8)<<" are needed!";
      }
     
@@ -72,7 +72,7 @@ int DCCSRPBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, unsigned
       if( ! DCCDataUnpacker::silentMode_ ){
         edm::LogWarning("IncorrectEvent")
           << "Synchronization error for SRP block"
-          << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << mapper_->getActiveDCC() << ")\n"
+          << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << unpacker_->getActiveDCC() << ")\n"
           << "  dccBx = " << dccBx << " bx_ = " << bx_ << " dccL1 = " << dccL1 << " l1_ = " << l1_ << "\n"
           << "  => Stop event unpacking";
       }
@@ -19,7 +19,7 @@ int DCCTCCBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, short tc
     if( ! DCCDataUnpacker::silentMode_ ){
       edm::LogWarning("IncorrectEvent")
         <<"EcalRawToDigi@SUB=DCCTCCBlock:unpack"
-        <<"\n Unable to unpack TCC block for event "<<event_->l1A()<<" in fed "<<mapper_->getActiveDCC()
+        <<"\n Unable to unpack TCC block for event "<<event_->l1A()<<" in fed "<<unpacker_->getActiveDCC()
         <<"\n Only 8 bytes are available until the end of event ..."
         <<"\n => Skipping to next fed block...";
      }
@@ -36,7 +36,7 @@ int DCCTCCBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, short tc
     if( ! DCCDataUnpacker::silentMode_ ){
       edm::LogWarning("IncorrectEvent")
         <<"EcalRawToDigi@SUB=DCCTCCBlock:unpack"
-        <<"\n Unable to unpack TCC block for event "<<event_->l1A()<<" in fed "<<mapper_->getActiveDCC()
+        <<"\n Unable to unpack TCC block for event "<<event_->l1A()<<" in fed "<<unpacker_->getActiveDCC()
         <<"\n Only "<<((*dwToEnd_)*8)<<" bytes are available until the end of event while "<<(blockLength_*8)<<" are needed!"
         <<"\n => Skipping to next fed block...";
      }
@@ -77,7 +77,7 @@ int DCCTCCBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, short tc
         if( ! DCCDataUnpacker::silentMode_ ){
           edm::LogWarning("IncorrectBlock")
             << "Synchronization error for TCC block"
-            << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << mapper_->getActiveDCC() << ")\n"
+            << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << unpacker_->getActiveDCC() << ")\n"
             << "  dccBx = " << dccBx << " bx_ = " << bx_ << " dccL1 = " << dccL1 << " l1_ = " << l1_ << "\n"
             << "  => TCC block skipped";
         }
@@ -95,7 +95,7 @@ int DCCTCCBlock::unpack(const uint64_t ** data, unsigned int * dwToEnd, short tc
     
     if( nTSamples_ != expTriggerTSamples ){
       edm::LogWarning("IncorrectBlock")
-        <<"Unable to unpack TCC block for event "<<event_->l1A()<<" in fed "<<mapper_->getActiveDCC()
+        <<"Unable to unpack TCC block for event "<<event_->l1A()<<" in fed "<<unpacker_->getActiveDCC()
         <<"\n Number of time samples is "<<nTSamples_<<" while "<<expTriggerTSamples<<" is expected"
         <<"\n TCC block skipped..."<<endl;
                 
@@ -40,12 +40,12 @@ int DCCTowerBlock::unpackXtalData(unsigned int expStripID, unsigned int expXtalI
   if( !zs_ && (expStripID != stripId || expXtalID != xtalId)){ 
     if(! DCCDataUnpacker::silentMode_){ 
       edm::LogWarning("IncorrectBlock")
-        <<"For event L1A: "<<event_->l1A()<<", fed "<<mapper_->getActiveDCC()<<" and tower "<<towerId_
+        <<"For event L1A: "<<event_->l1A()<<", fed "<<unpacker_->getActiveDCC()<<" and tower "<<towerId_
         <<"\n The expected strip is "<<expStripID<<" and "<<stripId<<" was found"
         <<"\n The expected xtal  is "<<expXtalID <<" and "<<xtalId<<" was found";        
     } 
     // using expected cry_di to raise warning about xtal_id problem
-    pDetId_ = (EBDetId*) mapper_->getDetIdPointer(towerId_,expStripID,expXtalID);
+    pDetId_ = (EBDetId*) mapper_->getDetIdPointer(unpacker_->getActiveSM(),towerId_,expStripID,expXtalID);
     (*invalidChIds_)->push_back(*pDetId_);
     
     // return here, so to skip all following checks
@@ -70,7 +70,7 @@ int DCCTowerBlock::unpackXtalData(unsigned int expStripID, unsigned int expXtalI
     if(stripId == 0 || stripId > 5 || xtalId == 0 || xtalId > 5){
       if( ! DCCDataUnpacker::silentMode_ ){
         edm::LogWarning("IncorrectBlock")
-          <<"For event L1A: "<<event_->l1A()<<", fed "<<mapper_->getActiveDCC()<<" and tower "<<towerId_
+          <<"For event L1A: "<<event_->l1A()<<", fed "<<unpacker_->getActiveDCC()<<" and tower "<<towerId_
           <<"\n Invalid strip : "<<stripId<<" or xtal : "<<xtalId
           <<" ids ( last strip was: " << lastStripId_ << " last ch was: " << lastXtalId_ << ")";
       }
@@ -106,7 +106,7 @@ int DCCTowerBlock::unpackXtalData(unsigned int expStripID, unsigned int expXtalI
           if (! DCCDataUnpacker::silentMode_) {
             edm::LogWarning("IncorrectBlock")
               << "Xtal id was expected to increase but it didn't - last valid xtal id was " << lastXtalId_ << " while current xtal is " << xtalId
-              << " (LV1 " << event_->l1A() << " fed " << mapper_->getActiveDCC() << " tower " << towerId_ << ")";
+              << " (LV1 " << event_->l1A() << " fed " << unpacker_->getActiveDCC() << " tower " << towerId_ << ")";
           }
           
           int st = lastStripId_;
@@ -141,7 +141,7 @@ int DCCTowerBlock::unpackXtalData(unsigned int expStripID, unsigned int expXtalI
   // otherwise, assume channel_id is valid and proceed with making and checking the data frame
   if(errorOnXtal) return SKIP_BLOCK_UNPACKING;
 
-  pDetId_ = (EBDetId*) mapper_->getDetIdPointer(towerId_,stripId,xtalId);
+  pDetId_ = (EBDetId*) mapper_->getDetIdPointer(unpacker_->getActiveSM(),towerId_,stripId,xtalId);
   (*digis_)->push_back(*pDetId_);
   EBDataFrame df( (*digis_)->back() );
   addedFrame=true;
@@ -190,10 +190,10 @@ int DCCTowerBlock::unpackXtalData(unsigned int expStripID, unsigned int expXtalI
     if(firstGainZeroSampID<3) {isSaturation=false; }
     
     if (! DCCDataUnpacker::silentMode_) {
-      if (unpacker_->getChannelValue(mapper_->getActiveDCC(), towerId_, stripId, xtalId) != 10) {
+      if (unpacker_->getChannelValue(unpacker_->getActiveDCC(), towerId_, stripId, xtalId) != 10) {
         edm::LogWarning("IncorrectGain")
           << "Gain zero" << (isSaturation ? " with features of saturation" : "" ) << " was found in Tower Block"
-          << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << mapper_->getActiveDCC()
+          << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << unpacker_->getActiveDCC()
           << " tower " << towerId_ << " strip " << stripId << " xtal " << xtalId << ")";
       }
     }
@@ -233,7 +233,7 @@ int DCCTowerBlock::unpackXtalData(unsigned int expStripID, unsigned int expXtalI
     if (! DCCDataUnpacker::silentMode_) {
       edm::LogWarning("IncorrectGain")
         << "A wrong gain transition switch was found for Tower Block in strip " << stripId << " and xtal " << xtalId
-        << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << mapper_->getActiveDCC() << " tower " << towerId_ << ")";
+        << " (L1A " << event_->l1A() << " bx " << event_->bx() << " fed " << unpacker_->getActiveDCC() << " tower " << towerId_ << ")";
     }
     
     (*invalidGainsSwitch_)->push_back(*pDetId_);
@@ -255,7 +255,7 @@ int DCCTowerBlock::unpackXtalData(unsigned int expStripID, unsigned int expXtalI
 
 void DCCTowerBlock::fillEcalElectronicsError( std::unique_ptr<EcalElectronicsIdCollection> * errorColection ){
 
-   const int activeDCC = mapper_->getActiveSM();
+   const int activeDCC = unpacker_->getActiveSM();
 
    if(NUMB_SM_EB_MIN_MIN<=activeDCC && activeDCC<=NUMB_SM_EB_PLU_MAX){
      EcalElectronicsId  *  eleTp = mapper_->getTTEleIdPointer(activeDCC+TCCID_SMID_SHIFT_EB,expTowerID_);
@@ -264,7 +264,7 @@ void DCCTowerBlock::fillEcalElectronicsError( std::unique_ptr<EcalElectronicsIdC
       if( ! DCCDataUnpacker::silentMode_ ){
           edm::LogWarning("IncorrectBlock")
             <<"For event "<<event_->l1A()<<" there's fed: "<< activeDCC
-            <<" activeDcc: "<<mapper_->getActiveSM()
+            <<" activeDcc: "<<unpacker_->getActiveSM()
             <<" but that activeDcc is not valid in EB.";
         }
 
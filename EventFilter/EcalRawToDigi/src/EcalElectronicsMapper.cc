@@ -208,20 +208,11 @@ void EcalElectronicsMapper::setEcalElectronicsMapping(const EcalElectronicsMappi
   fillMaps();
 }
 
-bool EcalElectronicsMapper::setActiveDCC(unsigned int dccId){
-   
-  bool ret(true);
-        
-  //Update active dcc and associated smId
-  dccId_ = dccId;
-   
-  smId_  = getSMId(dccId_);
-        
-  if(!smId_) ret = false;
-        
-  return ret;
-        
- } 
+std::vector<unsigned int> * EcalElectronicsMapper::getTccs(unsigned int smId) const {
+  // no insertion: called concurrently by the unpackers of different FEDs
+  auto it = mapSmIdToTccIds_.find(smId);
+  return it != mapSmIdToTccIds_.end() ? it->second : nullptr;
+}
  
  
 bool EcalElectronicsMapper::setDCCMapFilePath(std::string aPath_){
@@ -727,15 +718,17 @@ void EcalElectronicsMapper::setupGhostMap()
     ghost_[v[i].FED][v[i].CCU][v[i].VFE] = true;
 }
 
-bool EcalElectronicsMapper::isGhost(const int FED, const int CCU, const int VFE)
+bool EcalElectronicsMapper::isGhost(const int FED, const int CCU, const int VFE) const
 {
-  if (ghost_.find(FED) == ghost_.end())
+  const auto fed = ghost_.find(FED);
+  if (fed == ghost_.end())
     return false;
   
-  if (ghost_[FED].find(CCU) == ghost_[FED].end())
+  const auto ccu = fed->second.find(CCU);
+  if (ccu == fed->second.end())
     return false;
   
-  if (ghost_[FED][CCU].find(VFE) == ghost_[FED][CCU].end())
+  if (ccu->second.find(VFE) == ccu->second.end())
     return false;
   
   return true;
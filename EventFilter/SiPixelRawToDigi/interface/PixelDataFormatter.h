@@ -39,6 +39,7 @@
 #include "DataFormats/SiPixelRawData/interface/SiPixelRawDataError.h"
 #include "DataFormats/Common/interface/DetSetVector.h"
 #include "EventFilter/SiPixelRawToDigi/interface/ErrorChecker.h"
+#include "EventFilter/SiPixelRawToDigi/interface/PixelDigiBuffer.h"
 #include "FWCore/Utilities/interface/typedefs.h"
 
 #include <vector>
@@ -79,6 +80,8 @@ public:
   int nWords() const { return theWordCounter; }
 
   void interpretRawData(bool& errorsInEvent, int fedId,  const FEDRawData & data, Collection & digis, Errors & errors);
+  // same, appending the digis to a flat buffer in unpacking order
+  void interpretRawData(bool& errorsInEvent, int fedId,  const FEDRawData & data, PixelDigiBuffer & digis, Errors & errors);
 
   void formatRawData( unsigned int lvl1_ID, RawData & fedRawData, const Digis & digis);
 
@@ -112,6 +115,9 @@ private:
 
   int checkError(const Word32& data) const;
 
+  template<typename Sink>
+  void unpack(bool& errorsInEvent, int fedId, const FEDRawData & data, Sink & sink, Errors & errors);
+
   int digi2word(  cms_uint32_t detId, const PixelDigi& digi,
                   std::map<int, std::vector<Word32> > & words) const;
   int digi2wordPhase1Layer1(  cms_uint32_t detId, const PixelDigi& digi,
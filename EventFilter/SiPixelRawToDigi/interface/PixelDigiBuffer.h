@@ -0,0 +1,83 @@
+#ifndef EventFilter_SiPixelRawToDigi_PixelDigiBuffer_h
+#define EventFilter_SiPixelRawToDigi_PixelDigiBuffer_h
+/** \class PixelDigiBuffer
+ *
+ *  Pixel digis of one event in unpacking order, as plain arrays of
+ *  row, column and adc, together with the runs of consecutive digis
+ *  of the same module.
+ *  Filled by PixelDataFormatter::interpretRawData without any per-module
+ *  container, so that the unpacking can be fused with the clusterization:
+ *  a module can show up in several runs (one per link), sortRuns() orders
+ *  them by module keeping the unpacking order inside a module, i.e. the
+ *  order of the digis in the DetSetVector<PixelDigi> of SiPixelRawToDigi.
+ */
+
+#include "DataFormats/Common/interface/DetSet.h"
+#include "DataFormats/SiPixelDigi/interface/PixelDigi.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+class PixelDigiBuffer {
+public:
+
+  struct Run {
+    uint32_t rawId;
+    uint32_t begin;
+    uint32_t end;
+  };
+  typedef std::vector<Run>::const_iterator RunIterator;
+
+  void clear() { row_.clear(); col_.clear(); adc_.clear(); runs_.clear(); }
+
+  void reserve(unsigned int nDigis, unsigned int nRuns) {
+    row_.reserve(nDigis); col_.reserve(nDigis); adc_.reserve(nDigis); runs_.reserve(nRuns);
+  }
+
+  /// the following digis belong to module rawId
+  void newModule(uint32_t rawId) {
+    if (!runs_.empty() && runs_.back().rawId==rawId) return;  // next roc of the same module
+    if (!runs_.empty() && runs_.back().begin==runs_.back().end) runs_.pop_back();
+    runs_.push_back(Run{rawId,size(),size()});
+  }
+
+  void push_back(int row, int col, int adc) {
+    row_.push_back(row); col_.push_back(col); adc_.push_back(adc);
+    ++runs_.back().end;
+  }
+
+  /// order the runs by module (stable)
+  void sortRuns() {
+    if (!runs_.empty() && runs_.back().begin==runs_.back().end) runs_.pop_back();
+    std::stable_sort(runs_.begin(),runs_.end(),[](Run const & a, Run const & b){ return a.rawId<b.rawId; });
+  }
+
+  uint32_t size() const { return adc_.size(); }
+  std::vector<Run> const & runs() const { return runs_; }
+
+  /// end of the runs of the same module as *b (after sortRuns)
+  RunIterator moduleEnd(RunIterator b) const {
+    auto e = b;
+    while (e!=runs_.end() && e->rawId==b->rawId) ++e;
+    return e;
+  }
+
+  /// append the digis of the runs [b,e) to ds
+  void fill(edm::DetSet<PixelDigi> & ds, RunIterator b, RunIterator e) const {
+    for (auto r=b; r!=e; ++r)
+      for (auto i=r->begin; i!=r->end; ++i) ds.data.emplace_back(row_[i],col_[i],adc_[i]);
+  }
+
+  int row(uint32_t i) const { return row_[i]; }
+  int col(uint32_t i) const { return col_[i]; }
+  int adc(uint32_t i) const { return adc_[i]; }
+
+private:
+  std::vector<uint16_t> row_;
+  std::vector<uint16_t> col_;
+  std::vector<uint16_t> adc_;
+  std::vector<Run> runs_;
+};
+
+#endif
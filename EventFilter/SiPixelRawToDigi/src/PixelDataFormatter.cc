@@ -52,6 +52,23 @@ namespace {
   // constexpr PixelDataFormatter::Word32 PXID_mask = ~(~PixelDataFormatter::Word32(0) << PXID_bits);
   // constexpr PixelDataFormatter::Word32 ADC_mask  = ~(~PixelDataFormatter::Word32(0) << ADC_bits);
   //const bool DANEK = false;
+
+  // where interpretRawData puts the digis: newModule(rawId) at each new roc, then push_back
+  class DetSetVectorSink {
+  public:
+    explicit DetSetVectorSink(PixelDataFormatter::Collection & digis) : digis_(digis) {}
+    void newModule(cms_uint32_t rawId) {
+      detDigis_ = &digis_.find_or_insert(rawId);
+      if ( (*detDigis_).empty() ) (*detDigis_).data.reserve(32); // avoid the first relocations
+    }
+    void push_back(int row, int col, int adc) {
+      (*detDigis_).data.emplace_back(row, col, adc);
+      LogTrace("") << (*detDigis_).data.back();
+    }
+  private:
+    PixelDataFormatter::Collection & digis_;
+    edm::DetSet<PixelDigi> * detDigis_=nullptr;
+  };
 }
 
 PixelDataFormatter::PixelDataFormatter( const SiPixelFedCabling* map, bool phase)
@@ -125,6 +142,18 @@ void PixelDataFormatter::passFrameReverter(const SiPixelFrameReverter* reverter)
 }
 
 void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const FEDRawData& rawData, Collection & digis, Errors& errors)
+{
+  DetSetVectorSink sink(digis);
+  unpack(errorsInEvent, fedId, rawData, sink, errors);
+}
+
+void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const FEDRawData& rawData, PixelDigiBuffer & digis, Errors& errors)
+{
+  unpack(errorsInEvent, fedId, rawData, digis, errors);
+}
+
+template<typename Sink>
+void PixelDataFormatter::unpack(bool& errorsInEvent, int fedId, const FEDRawData& rawData, Sink & sink, Errors& errors)
 {
   using namespace sipixelobjects;
 
@@ -166,7 +195,6 @@ void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const
   int layer = 0;
   PixelROC const * rocp=nullptr;
   bool skipROC=false;
-  edm::DetSet<PixelDigi> * detDigis=nullptr;
 
   const  Word32 * bw =(const  Word32 *)(header+1);
   const  Word32 * ew =(const  Word32 *)(trailer);
@@ -208,8 +236,7 @@ void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const
       skipROC= modulesToUnpack && ( modulesToUnpack->find(rawId) == modulesToUnpack->end());
       if (skipROC) continue;
       
-      detDigis = &digis.find_or_insert(rawId);
-      if ( (*detDigis).empty() ) (*detDigis).data.reserve(32); // avoid the first relocations
+      sink.newModule(rawId);
     }
 
     // skip is roc to be skipped ot invalid
@@ -258,9 +285,8 @@ void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const
     }    
 
     GlobalPixel global = rocp->toGlobal( *local ); // global pixel coordinate (in module)
-    (*detDigis).data.emplace_back(global.row, global.col, adc);
+    sink.push_back(global.row, global.col, adc);
     //if(DANEK) cout<<global.row<<" "<<global.col<<" "<<adc<<endl;    
-    LogTrace("") << (*detDigis).data.back();
   }
 
 }
@@ -4,6 +4,7 @@
 #include "IOPool/Streamer/interface/FRDEventMessage.h"
 
 #include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
+#include "DataFormats/FEDRawData/interface/FEDRawDataStreamer.h"
 #include "DataFormats/FEDRawData/interface/FEDNumbering.h"
 #include "DataFormats/FEDRawData/interface/FEDHeader.h"
 #include "DataFormats/FEDRawData/interface/FEDTrailer.h"
@@ -26,6 +27,8 @@ FRDStreamSource::FRDStreamSource(edm::ParameterSet const& pset,
   itFileName_=fileNames().begin();
   openFile(*itFileName_);
   produces<FEDRawDataCollection>();
+  // the FEDRawData reference the input buffer: written out as owning copies
+  setFEDRawDataStreamerInTClass();
 }
 
 
@@ -42,38 +45,59 @@ bool FRDStreamSource::setRunAndEventInfo(edm::EventID& id, edm::TimeValue_t& the
     }
   }
 
+  // take a buffer no longer referenced by the FEDRawData of earlier events
+  buffer_.reset();
+  for (auto const& b : buffers_) {
+    if (b.use_count()==1) {
+      buffer_ = b;
+      break;
+    }
+  }
+  if (!buffer_) {
+    buffers_.push_back(std::make_shared<std::vector<char> >());
+    buffer_ = buffers_.back();
+  }
+  std::vector<char>& buffer = *buffer_;
+
+  bool firstEvent = false;
   if ( detectedFRDversion_==0) {
     fin_.read((char*)&detectedFRDversion_,sizeof(uint32_t));
     assert(detectedFRDversion_>0 && detectedFRDversion_<=5);
-    if ( buffer_.size() < FRDHeaderVersionSize[detectedFRDversion_] )
-      buffer_.resize(FRDHeaderVersionSize[detectedFRDversion_]);
-    *((uint32_t*)(&buffer_[0]))=detectedFRDversion_;
-    fin_.read(&buffer_[0] + sizeof(uint32_t),FRDHeaderVersionSize[detectedFRDversion_]-sizeof(uint32_t));
-    assert( fin_.gcount() == FRDHeaderVersionSize[detectedFRDversion_]-(unsigned int)(sizeof(uint32_t) ));
+    firstEvent = true;
+  }
+  const uint32_t headerSize = FRDHeaderVersionSize[detectedFRDversion_];
+  // place the header so that the FED fragments following it are 8-byte aligned
+  const uint32_t offset = (8 - headerSize%8)%8;
+  if ( buffer.size() < offset+headerSize )
+    buffer.resize(offset+headerSize);
+  char* header = &buffer[offset];
+  if ( firstEvent ) {
+    *((uint32_t*)header)=detectedFRDversion_;
+    fin_.read(header + sizeof(uint32_t),headerSize-sizeof(uint32_t));
+    assert( fin_.gcount() == headerSize-(unsigned int)(sizeof(uint32_t) ));
   }
   else {
-    if ( buffer_.size() < FRDHeaderVersionSize[detectedFRDversion_] )
-      buffer_.resize(FRDHeaderVersionSize[detectedFRDversion_]);
-    fin_.read(&buffer_[0],FRDHeaderVersionSize[detectedFRDversion_]);
-    assert( fin_.gcount() == FRDHeaderVersionSize[detectedFRDversion_] );
+    fin_.read(header,headerSize);
+    assert( fin_.gcount() == headerSize );
   }
 
-  std::unique_ptr<FRDEventMsgView> frdEventMsg(new FRDEventMsgView(&buffer_[0]));
+  std::unique_ptr<FRDEventMsgView> frdEventMsg(new FRDEventMsgView(header));
   if (useL1EventID_)
     id = edm::EventID(frdEventMsg->run(), frdEventMsg->lumi(), frdEventMsg->event());
 
   const uint32_t totalSize = frdEventMsg->size();
-  if ( totalSize > buffer_.size() ) {
-    buffer_.resize(totalSize);
+  if ( offset+totalSize > buffer.size() ) {
+    buffer.resize(offset+totalSize);
+    header = &buffer[offset];
   }
-  if ( totalSize > FRDHeaderVersionSize[detectedFRDversion_] ) {
-    fin_.read(&buffer_[0]+FRDHeaderVersionSize[detectedFRDversion_],totalSize-FRDHeaderVersionSize[detectedFRDversion_]);
-    if ( fin_.gcount() != totalSize-FRDHeaderVersionSize[detectedFRDversion_] ) {
+  if ( totalSize > headerSize ) {
+    fin_.read(header+headerSize,totalSize-headerSize);
+    if ( fin_.gcount() != totalSize-headerSize ) {
       throw cms::Exception("FRDStreamSource::setRunAndEventInfo") <<
         "premature end of file " << *itFileName_;
     }
-    frdEventMsg.reset(new FRDEventMsgView(&buffer_[0]));
   }
+  frdEventMsg.reset(new FRDEventMsgView(header));
 
   if ( verifyChecksum_ && frdEventMsg->version() >= 5 )
   {
@@ -149,9 +173,7 @@ bool FRDStreamSource::setRunAndEventInfo(edm::EventID& id, edm::TimeValue_t& the
         id = edm::EventID(frdEventMsg->run(), frdEventMsg->lumi(), evf::evtn::gtpe_get(event + eventSize));
       }
     }
-    FEDRawData& fedData = rawData_->FEDData(fedId);
-    fedData.resize(fedSize);
-    memcpy(fedData.data(), event + eventSize, fedSize);
+    rawData_->FEDData(fedId) = FEDRawData(event + eventSize, fedSize, buffer_);
   }
   assert(eventSize == 0);
 
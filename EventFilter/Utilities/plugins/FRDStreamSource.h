@@ -13,6 +13,7 @@
 #include "DataFormats/Provenance/interface/Timestamp.h"
 
 #include <unistd.h>
+#include <memory>
 #include <string>
 #include <vector>
 #include <fstream>
@@ -39,7 +40,10 @@ private:
   std::vector<std::string>::const_iterator itFileName_;
   std::ifstream fin_;
   std::unique_ptr<FEDRawDataCollection> rawData_;
-  std::vector<char> buffer_;
+  // the FEDRawData reference the buffer of their event (no copy), which is
+  // reused once they are all gone
+  std::shared_ptr<std::vector<char> > buffer_;
+  std::vector<std::shared_ptr<std::vector<char> > > buffers_;
   const bool verifyAdler32_;
   const bool verifyChecksum_;
   const bool useL1EventID_;
@@ -0,0 +1,45 @@
+#ifndef PhysicsTools_IsolationAlgos_CandidateEtaPhiGrid_h
+#define PhysicsTools_IsolationAlgos_CandidateEtaPhiGrid_h
+
+#include "DataFormats/Common/interface/View.h"
+#include "DataFormats/Candidate/interface/Candidate.h"
+
+#include <vector>
+
+//! Eta-phi grid of the candidates of a collection, used to find the candidates
+//! around a direction without scanning the whole collection.
+//! The candidate indices are stored cell by cell in a single array, in
+//! increasing order in each cell, so that the candidates found around a
+//! direction can be given in the order of the collection.
+class CandidateEtaPhiGrid {
+ public:
+  //! maximum number of cells in eta, wider cells are used beyond
+  static const int maxEtaBins = 256;
+  //! maximum number of cells in phi, smaller cell sizes are not used
+  static const int maxPhiBins = 256;
+  //! the cells cover at most |eta| < maxEta, the candidates beyond being in
+  //! the first or last cells
+  static constexpr double maxEta = 10.;
+
+  //! Build the grid of the candidates with cells at least cellSize wide
+  CandidateEtaPhiGrid(const edm::View<reco::Candidate>& candidates, double cellSize);
+
+  //! Append to indices the indices, in increasing order, of the candidates in
+  //! the cells within deltaR of (eta,phi): a superset of the candidates with
+  //! deltaR(eta,phi) < deltaR, including with float precision
+  void candidates(double eta, double phi, double deltaR, std::vector<unsigned int>& indices) const;
+
+  unsigned int size() const { return cells_.size(); }
+
+ private:
+  int etaBin(double eta) const;
+  int phiBin(double phi) const;
+
+  double etaMin_, etaWidth_, phiWidth_;
+  int nEta_, nPhi_;
+  std::vector<unsigned int> offsets_;
+  std::vector<unsigned int> indices_;
+  std::vector<int> cells_;
+};
+
+#endif
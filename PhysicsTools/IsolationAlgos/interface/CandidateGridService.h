@@ -0,0 +1,60 @@
+#ifndef PhysicsTools_IsolationAlgos_CandidateGridService_h
+#define PhysicsTools_IsolationAlgos_CandidateGridService_h
+
+#include "PhysicsTools/IsolationAlgos/interface/CandidateEtaPhiGrid.h"
+
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Provenance/interface/ProductID.h"
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace edm {
+  class ActivityRegistry;
+  class ConfigurationDescriptions;
+  class Event;
+  class ParameterSet;
+  class StreamContext;
+  namespace service {
+    class SystemBounds;
+  }
+}
+
+//! Service sharing the eta-phi grids of the candidate collections used for
+//! the isolation between the modules of an event.
+//! The grid of a collection is built by the first module asking for it in
+//! the event, the isolation producers of the same stream asking for the same
+//! collection then use it for all their cones and vetoes.
+class CandidateGridService {
+ public:
+  typedef std::shared_ptr<const CandidateEtaPhiGrid> GridPtr;
+
+  CandidateGridService(const edm::ParameterSet& iConfig, edm::ActivityRegistry& iRegistry);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  //! Grid of the candidates in the event, shared by the modules of the stream
+  GridPtr grid(const edm::Event& iEvent, const edm::Handle<edm::View<reco::Candidate> >& iCandidates);
+
+  //! Grid from the service when it is configured, otherwise a grid of the
+  //! module with cells of cellSize
+  static GridPtr getGrid(const edm::Event& iEvent, const edm::Handle<edm::View<reco::Candidate> >& iCandidates,
+                         double cellSize);
+
+ private:
+  //! grids of the event being processed on a stream, cleared at its end
+  struct Slot {
+    std::mutex mutex;
+    std::vector<std::pair<edm::ProductID, GridPtr> > grids;
+  };
+
+  void preallocate(const edm::service::SystemBounds& bounds);
+  void postEvent(const edm::StreamContext& iContext);
+
+  const double cellSize_;
+  std::vector<std::unique_ptr<Slot> > slots_;
+};
+
+#endif
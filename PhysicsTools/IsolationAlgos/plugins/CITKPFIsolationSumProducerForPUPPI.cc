@@ -12,12 +12,14 @@
 #include "DataFormats/Candidate/interface/CandidateFwd.h"
 #include "DataFormats/Candidate/interface/Candidate.h"
 #include "PhysicsTools/IsolationAlgos/interface/CITKIsolationConeDefinitionBase.h"
+#include "PhysicsTools/IsolationAlgos/interface/CandidateGridService.h"
 #include "DataFormats/Common/interface/OwnVector.h"
 
 #include "FWCore/Framework/interface/MakerMacros.h"
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/interface/EventSetup.h"
 
+#include <algorithm>
 #include <string>
 #include <unordered_map>
 
@@ -50,6 +52,9 @@ namespace citk {
     // indexed by pf candidate type
     std::array<IsoTypes,kNPFTypes> _isolation_types; 
     std::array<std::vector<std::string>,kNPFTypes> _product_names;
+    // largest cone of the definitions, the candidates beyond are skipped
+    double _max_cone_size = 0.;
+    std::vector<unsigned int> _in_cone;
     bool useValueMapForPUPPI = true;
     bool usePUPPINoLepton = false;// in case puppi weights are taken from packedCandidate can take weights for puppiNoLeptons
   };
@@ -86,6 +91,7 @@ namespace citk {
       const std::string& name = 
 	isodef.getParameter<std::string>("isolationAlgo");
       const float coneSize = isodef.getParameter<double>("coneSize");
+      _max_cone_size = std::max(_max_cone_size, double(coneSize));
       char buf[50];
       std::sprintf(buf,"DR%.2f",coneSize);
       std::string coneName(buf);
@@ -140,6 +146,8 @@ namespace citk {
 	isolator->getEventInfo(ev);
       }
     }
+    // all the cones of a candidate are within _max_cone_size of it
+    const auto grid = CandidateGridService::getGrid(ev, isolate_with, _max_cone_size);
     reco::PFCandidate helper; // to translate pdg id to type    
     // loop over the candidates we are isolating and fill the values
     for( size_t c = 0; c < to_isolate->size(); ++c ) {
@@ -151,7 +159,10 @@ namespace citk {
 	for( auto& value : cand_values[k] ) value = 0.0;
 	++k;
       }
-      for( size_t ic = 0; ic < isolate_with->size(); ++ic ) {
+      _in_cone.clear();
+      grid->candidates(cand_to_isolate->eta(), cand_to_isolate->phi(),
+                       _max_cone_size, _in_cone);
+      for( const unsigned int ic : _in_cone ) {
         auto isocand = isolate_with->ptrAt(ic);
         edm::Ptr<pat::PackedCandidate> aspackedCandidate(isocand);
         auto isotype = helper.translatePdgIdToType(isocand->pdgId());	
@@ -43,6 +43,7 @@ reco::IsoDeposit::Veto CandViewExtractor::veto(const reco::IsoDeposit::Direction
 void CandViewExtractor::initEvent(const edm::Event & ev, const edm::EventSetup & evSetup){
   ev.getByToken(theCandViewToken, theCandViewH);
   theCacheID = ev.cacheIdentifier();
+  theGrid = CandidateGridService::getGrid(ev, theCandViewH, theDR_Max);
 }
 
 #include "FWCore/PluginManager/interface/ModuleDef.h"
@@ -13,6 +13,7 @@
 #include "DataFormats/Candidate/interface/Candidate.h"
 #include "DataFormats/Candidate/interface/CandidateFwd.h"
 #include "PhysicsTools/IsolationAlgos/interface/IsoDepositExtractor.h"
+#include "PhysicsTools/IsolationAlgos/interface/CandidateGridService.h"
 
 namespace muonisolation {
 
@@ -59,6 +60,7 @@ private:
   std::string theDepositLabel;         // name for deposit
   edm::Handle<edm::View<reco::Candidate> > theCandViewH; //cached handle
   edm::Event::CacheIdentifier_t theCacheID;  //event cacheID
+  CandidateGridService::GridPtr theGrid;    //eta-phi grid of the cached candidates
   double theDiff_r;                    // transverse distance to vertex
   double theDiff_z;                    // z distance to vertex
   double theDR_Max;                    // Maximum cone angle for deposits
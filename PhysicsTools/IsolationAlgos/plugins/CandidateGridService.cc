@@ -0,0 +1,4 @@
+#include "PhysicsTools/IsolationAlgos/interface/CandidateGridService.h"
+#include "FWCore/ServiceRegistry/interface/ServiceMaker.h"
+
+DEFINE_FWK_SERVICE(CandidateGridService);
@@ -0,0 +1,76 @@
+#include "PhysicsTools/IsolationAlgos/interface/CandidateEtaPhiGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+CandidateEtaPhiGrid::CandidateEtaPhiGrid(const edm::View<reco::Candidate>& candidates, double cellSize)
+{
+  cellSize = std::max(cellSize, 2 * M_PI / maxPhiBins);
+  const unsigned int n = candidates.size();
+  std::vector<double> etas(n), phis(n);
+  double etaMax = -maxEta;
+  etaMin_ = maxEta;
+  for (unsigned int i = 0; i < n; ++i) {
+    etas[i] = candidates[i].eta();
+    phis[i] = candidates[i].phi();
+    if (etas[i] < etaMin_) etaMin_ = etas[i];
+    if (etas[i] > etaMax) etaMax = etas[i];
+  }
+  etaMin_ = std::min(std::max(etaMin_, -maxEta), maxEta);
+  etaMax = std::min(std::max(etaMax, etaMin_), maxEta);
+
+  etaWidth_ = std::max(cellSize, (etaMax - etaMin_) / maxEtaBins);
+  nEta_ = std::min(int((etaMax - etaMin_) / etaWidth_) + 1, int(maxEtaBins));
+  nPhi_ = std::max(int(2 * M_PI / cellSize), 1);
+  phiWidth_ = 2 * M_PI / nPhi_;
+
+  // counting sort of the candidates by cell, keeping their order in a cell
+  cells_.resize(n);
+  offsets_.assign(nEta_ * nPhi_ + 1, 0);
+  for (unsigned int i = 0; i < n; ++i) {
+    cells_[i] = etaBin(etas[i]) * nPhi_ + phiBin(phis[i]);
+    ++offsets_[cells_[i] + 1];
+  }
+  for (int c = 0; c < nEta_ * nPhi_; ++c) offsets_[c + 1] += offsets_[c];
+  indices_.resize(n);
+  std::vector<unsigned int> next(offsets_.begin(), offsets_.end() - 1);
+  for (unsigned int i = 0; i < n; ++i) indices_[next[cells_[i]]++] = i;
+}
+
+int CandidateEtaPhiGrid::etaBin(double eta) const
+{
+  // written so that nan ends up in the first cell
+  const double u = (eta - etaMin_) / etaWidth_;
+  if (!(u > 0.)) return 0;
+  if (u >= nEta_ - 1) return nEta_ - 1;
+  return int(u);
+}
+
+int CandidateEtaPhiGrid::phiBin(double phi) const
+{
+  const double u = (phi + M_PI) / phiWidth_;
+  if (!(u > 0.)) return 0;
+  if (u >= nPhi_ - 1) return nPhi_ - 1;
+  return int(u);
+}
+
+void CandidateEtaPhiGrid::candidates(double eta, double phi, double deltaR, std::vector<unsigned int>& indices) const
+{
+  // the radius is enlarged a bit for the cuts made with float precision
+  const double r = deltaR * (1. + 1e-6);
+  const int nEtaRings = int(std::min(std::ceil(r / etaWidth_), double(nEta_)));
+  const int nPhiRings = int(std::min(std::ceil(r / phiWidth_), double(nPhi_)));
+  const int ieta = etaBin(eta), iphi = phiBin(phi);
+  const bool allPhi = 2 * nPhiRings + 1 >= nPhi_;
+  const int phiLow = allPhi ? 0 : iphi - nPhiRings;
+  const int phiHigh = allPhi ? nPhi_ - 1 : iphi + nPhiRings;
+
+  const unsigned int first = indices.size();
+  for (int ie = std::max(ieta - nEtaRings, 0); ie <= std::min(ieta + nEtaRings, nEta_ - 1); ++ie) {
+    for (int ip = phiLow; ip <= phiHigh; ++ip) {
+      const int cell = ie * nPhi_ + (ip + nPhi_) % nPhi_;
+      indices.insert(indices.end(), indices_.begin() + offsets_[cell], indices_.begin() + offsets_[cell + 1]);
+    }
+  }
+  std::sort(indices.begin() + first, indices.end());
+}
@@ -0,0 +1,60 @@
+#include "PhysicsTools/IsolationAlgos/interface/CandidateGridService.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/ServiceRegistry/interface/StreamContext.h"
+#include "FWCore/ServiceRegistry/interface/SystemBounds.h"
+
+CandidateGridService::CandidateGridService(const edm::ParameterSet& iConfig, edm::ActivityRegistry& iRegistry) :
+  cellSize_(iConfig.getUntrackedParameter<double>("cellSize"))
+{
+  iRegistry.watchPreallocate(this, &CandidateGridService::preallocate);
+  iRegistry.watchPostEvent(this, &CandidateGridService::postEvent);
+}
+
+void CandidateGridService::fillDescriptions(edm::ConfigurationDescriptions& descriptions)
+{
+  edm::ParameterSetDescription desc;
+  desc.addUntracked<double>("cellSize", 0.2)
+    ->setComment("minimal size in eta and phi of the grid cells, cones larger than a cell look at several cells");
+  descriptions.add("CandidateGridService", desc);
+}
+
+void CandidateGridService::preallocate(const edm::service::SystemBounds& bounds)
+{
+  slots_.resize(bounds.maxNumberOfStreams());
+  for (auto& slot : slots_) slot = std::make_unique<Slot>();
+}
+
+void CandidateGridService::postEvent(const edm::StreamContext& iContext)
+{
+  // the product IDs, and possibly the event ID, repeat in the next event
+  Slot& slot = *slots_.at(iContext.streamID().value());
+  std::lock_guard<std::mutex> guard(slot.mutex);
+  slot.grids.clear();
+}
+
+CandidateGridService::GridPtr
+CandidateGridService::grid(const edm::Event& iEvent, const edm::Handle<edm::View<reco::Candidate> >& iCandidates)
+{
+  Slot& slot = *slots_.at(iEvent.streamID().value());
+  std::lock_guard<std::mutex> guard(slot.mutex);
+  for (const auto& grid : slot.grids) {
+    if (grid.first == iCandidates.id()) return grid.second;
+  }
+  slot.grids.emplace_back(iCandidates.id(), std::make_shared<const CandidateEtaPhiGrid>(*iCandidates, cellSize_));
+  return slot.grids.back().second;
+}
+
+CandidateGridService::GridPtr
+CandidateGridService::getGrid(const edm::Event& iEvent, const edm::Handle<edm::View<reco::Candidate> >& iCandidates,
+                              double cellSize)
+{
+  edm::Service<CandidateGridService> service;
+  if (service.isAvailable()) return service->grid(iEvent, iCandidates);
+  return std::make_shared<const CandidateEtaPhiGrid>(*iCandidates, cellSize);
+}
@@ -0,0 +1,160 @@
+/* Unit test for CandidateEtaPhiGrid: the candidates found around a direction
+   must include all the candidates within deltaR given by a scan of the
+   collection, in increasing order
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "PhysicsTools/IsolationAlgos/interface/CandidateEtaPhiGrid.h"
+#include "DataFormats/Candidate/interface/LeafCandidate.h"
+#include "DataFormats/Common/interface/FillViewHelperVector.h"
+#include "DataFormats/Math/interface/deltaR.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+class testCandidateEtaPhiGrid: public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(testCandidateEtaPhiGrid);
+  CPPUNIT_TEST(testRandom);
+  CPPUNIT_TEST(testPhiWrap);
+  CPPUNIT_TEST(testBeyondMaxEta);
+  CPPUNIT_TEST(testNaNEta);
+  CPPUNIT_TEST(testOutsideEtaRange);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp(){}
+  void tearDown(){ candidates_.clear(); }
+
+  void testRandom();
+  void testPhiWrap();
+  void testBeyondMaxEta();
+  void testNaNEta();
+  void testOutsideEtaRange();
+
+private:
+  void add(double eta, double phi);
+  edm::View<reco::Candidate> view() const;
+  // checks the candidates found around (eta,phi) with the grid of the
+  // candidates, returns the number of candidates within deltaR
+  unsigned int check(const CandidateEtaPhiGrid& grid, double eta, double phi, double deltaR) const;
+
+  std::vector<reco::LeafCandidate> candidates_;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testCandidateEtaPhiGrid);
+
+void testCandidateEtaPhiGrid::add(double eta, double phi){
+  candidates_.emplace_back(0, reco::LeafCandidate::PolarLorentzVector(10., eta, phi, 0.));
+}
+
+edm::View<reco::Candidate> testCandidateEtaPhiGrid::view() const {
+  std::vector<void const*> pointers;
+  edm::FillViewHelperVector helpers;
+  for (unsigned int i = 0; i < candidates_.size(); ++i) {
+    pointers.push_back(static_cast<const reco::Candidate*>(&candidates_[i]));
+    helpers.emplace_back(edm::ProductID(), i);
+  }
+  return edm::View<reco::Candidate>(pointers, helpers, nullptr);
+}
+
+unsigned int testCandidateEtaPhiGrid::check(const CandidateEtaPhiGrid& grid, double eta, double phi, double deltaR) const {
+  std::vector<unsigned int> found;
+  grid.candidates(eta, phi, deltaR, found);
+  for (unsigned int i = 1; i < found.size(); ++i) CPPUNIT_ASSERT(found[i-1] < found[i]);
+
+  unsigned int inCone = 0;
+  for (unsigned int i = 0; i < candidates_.size(); ++i) {
+    if (reco::deltaR2(eta, phi, candidates_[i].eta(), candidates_[i].phi()) < deltaR*deltaR) {
+      ++inCone;
+      CPPUNIT_ASSERT(std::binary_search(found.begin(), found.end(), i));
+    }
+  }
+  return inCone;
+}
+
+void testCandidateEtaPhiGrid::testRandom(){
+  std::mt19937 random(1);
+  std::uniform_real_distribution<double> eta(-5., 5.), phi(-M_PI, M_PI);
+  for (int i = 0; i < 500; ++i) add(eta(random), phi(random));
+  const edm::View<reco::Candidate> candidates = view();
+
+  for (double cellSize : {0., 0.1, 0.4, 1., 10.}) {
+    CandidateEtaPhiGrid grid(candidates, cellSize);
+    CPPUNIT_ASSERT_EQUAL(500U, grid.size());
+    for (int q = 0; q < 200; ++q) {
+      for (double deltaR : {0.1, 0.3, 0.4, 1., 4.}) {
+        check(grid, eta(random), phi(random), deltaR);
+      }
+    }
+    // cones around the candidates themselves
+    for (const auto& candidate : candidates_) CPPUNIT_ASSERT(check(grid, candidate.eta(), candidate.phi(), 0.3) >= 1);
+  }
+}
+
+void testCandidateEtaPhiGrid::testPhiWrap(){
+  for (double phi : {M_PI - 0.01, M_PI - 0.2, -M_PI + 0.01, -M_PI + 0.2, M_PI, -M_PI}) add(0.5, phi);
+  add(0., 0.);
+  const edm::View<reco::Candidate> candidates = view();
+
+  for (double cellSize : {0.1, 0.4}) {
+    CandidateEtaPhiGrid grid(candidates, cellSize);
+    // the cones around +-pi take the candidates of both sides
+    CPPUNIT_ASSERT_EQUAL(4U, check(grid, 0.5, M_PI, 0.1));
+    CPPUNIT_ASSERT_EQUAL(4U, check(grid, 0.5, -M_PI, 0.1));
+    CPPUNIT_ASSERT_EQUAL(6U, check(grid, 0.5, -M_PI + 0.05, 0.4));
+    CPPUNIT_ASSERT_EQUAL(6U, check(grid, 0.5, M_PI - 0.05, 0.4));
+  }
+}
+
+void testCandidateEtaPhiGrid::testBeyondMaxEta(){
+  for (double eta : {-30., -15., -CandidateEtaPhiGrid::maxEta, -9.9, 0., 9.9, CandidateEtaPhiGrid::maxEta, 15., 30.}) {
+    add(eta, 1.);
+    add(eta, -2.);
+  }
+  const edm::View<reco::Candidate> candidates = view();
+
+  for (double cellSize : {0.1, 0.4}) {
+    CandidateEtaPhiGrid grid(candidates, cellSize);
+    // the candidates beyond maxEta are in the first and last cells
+    CPPUNIT_ASSERT_EQUAL(1U, check(grid, 15., 1., 0.4));
+    CPPUNIT_ASSERT_EQUAL(1U, check(grid, -30., -2., 0.4));
+    CPPUNIT_ASSERT_EQUAL(2U, check(grid, 9.95, 1., 0.4));
+    CPPUNIT_ASSERT_EQUAL(0U, check(grid, 20., 1., 0.4));
+    CPPUNIT_ASSERT_EQUAL(6U, check(grid, 12., 1., 6.));
+  }
+}
+
+void testCandidateEtaPhiGrid::testNaNEta(){
+  add(std::numeric_limits<double>::quiet_NaN(), 0.);
+  add(-1., 0.);
+  add(1., 0.1);
+  add(std::numeric_limits<double>::quiet_NaN(), 2.);
+  const edm::View<reco::Candidate> candidates = view();
+
+  CandidateEtaPhiGrid grid(candidates, 0.4);
+  CPPUNIT_ASSERT_EQUAL(4U, grid.size());
+  // the nan candidates are never within a cone, but do not hide the others
+  CPPUNIT_ASSERT_EQUAL(1U, check(grid, -1., 0., 0.3));
+  CPPUNIT_ASSERT_EQUAL(1U, check(grid, 1., 0., 0.3));
+  CPPUNIT_ASSERT_EQUAL(0U, check(grid, std::numeric_limits<double>::quiet_NaN(), 0., 0.3));
+}
+
+void testCandidateEtaPhiGrid::testOutsideEtaRange(){
+  for (int i = 0; i < 21; ++i) add(-1. + 0.1*i, 0.3*i - 3.);
+  const edm::View<reco::Candidate> candidates = view();
+
+  for (double cellSize : {0.1, 0.4}) {
+    CandidateEtaPhiGrid grid(candidates, cellSize);
+    // cones overlapping the filled range from outside, and away from it
+    CPPUNIT_ASSERT_EQUAL(1U, check(grid, 1.2, 3., 0.3));
+    CPPUNIT_ASSERT_EQUAL(1U, check(grid, -1.2, -3., 0.3));
+    CPPUNIT_ASSERT_EQUAL(0U, check(grid, 3., 0., 0.4));
+    CPPUNIT_ASSERT_EQUAL(0U, check(grid, -3., 0., 0.4));
+    CPPUNIT_ASSERT_EQUAL(21U, check(grid, 5., 0., 8.));
+  }
+}
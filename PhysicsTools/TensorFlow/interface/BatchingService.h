@@ -0,0 +1,113 @@
+/*
+ * Service gathering the inference requests of several streams into batches.
+ * Modules register their graph in the constructor and submit their input tensors in the acquire
+ * method of an edm::ExternalWork stream module: the requests for the same model are concatenated
+ * along their first (batch) dimension and evaluated with a single session call, either as soon as
+ * maxBatchSize entries are pending or when the oldest pending request has waited for timeout
+ * microseconds. The outputs are split back into the requests and their tasks are released, so that
+ * they are available in produce.
+ * The batches are evaluated on the server thread of the service, outside of the framework task
+ * arena, as the external work of the streams: Session::Run blocks until the whole batch is
+ * evaluated, with the ops run by the threads of the session (or by the calling thread with the
+ * no_threads pool), so that in a task of the arena it would hold a framework thread for the
+ * requests of all the streams in the batch, while the streams waiting for their request already
+ * gave back their threads to the framework. The tasks of the requests are released through their
+ * WaitingTaskWithArenaHolder, which enqueues them in the arena of the stream that submitted them.
+ */
+
+#ifndef PHYSICSTOOLS_TENSORFLOW_BATCHINGSERVICE_H
+#define PHYSICSTOOLS_TENSORFLOW_BATCHINGSERVICE_H
+
+#include "PhysicsTools/TensorFlow/interface/TensorFlow.h"
+
+#include "FWCore/Concurrency/interface/WaitingTaskWithArenaHolder.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace edm
+{
+class ActivityRegistry;
+class ConfigurationDescriptions;
+class ParameterSet;
+}
+
+namespace tensorflow
+{
+
+class BatchingService
+{
+public:
+    typedef unsigned int ModelID;
+
+    BatchingService(const edm::ParameterSet& pset, edm::ActivityRegistry& registry);
+    ~BatchingService();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+    // registers the graph saved as a protobuf file at pbFile, to be called in the module
+    // constructors, fixedInputs (e.g. learning phase flags) are passed to each session call as they
+    // are, modules registering the same graph, fixed inputs (names and values) and output names share
+    // the model
+    ModelID registerModel(const std::string& pbFile, const NamedTensorList& fixedInputs,
+        const std::vector<std::string>& outputNames);
+
+    // evaluates the inputs with the model asynchronously, to be called in acquire
+    // all input tensors must have the same first dimension, the batch size of the request, and all
+    // requests for a model must give the same input names in the same order
+    // inputs and outputs must stay valid until the holder is done waiting, outputs are only set when
+    // no exception is passed to the holder
+    void runAsync(ModelID modelID, const NamedTensorList* inputs, std::vector<Tensor>* outputs,
+        edm::WaitingTaskWithArenaHolder holder);
+
+    void postEndJob();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Request
+    {
+        const NamedTensorList* inputs;
+        std::vector<Tensor>* outputs;
+        int64 size;
+        edm::WaitingTaskWithArenaHolder holder;
+        Clock::time_point submitted;
+    };
+
+    struct Model
+    {
+        std::string pbFile;
+        NamedTensorList fixedInputs;
+        std::vector<std::string> outputNames;
+        std::shared_ptr<Session> session;
+
+        // guarded by the service mutex
+        std::deque<Request> pending;
+        int64 pendingSize = 0;
+    };
+
+    void start();
+    void stop();
+
+    void serverDoWork();
+    void runBatch(Model& model, std::vector<Request>& batch);
+
+    const int64 maxBatchSize_;
+    const std::chrono::microseconds timeout_;
+    const int nThreads_;
+    const std::string singleThreadPool_;
+
+    std::mutex mutex_; // needed by cond_
+    std::condition_variable cond_;
+    std::vector<std::unique_ptr<Model>> models_;
+    std::unique_ptr<std::thread> thread_;
+    bool shouldStop_;
+};
+
+} // namespace tensorflow
+
+#endif // PHYSICSTOOLS_TENSORFLOW_BATCHINGSERVICE_H
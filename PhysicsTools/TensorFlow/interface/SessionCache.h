@@ -0,0 +1,48 @@
+/*
+ * Process-wide cache of graphs and sessions, shared by all modules and streams.
+ * Graphs are identified by the MD5 digest of their protobuf file content, so that a graph is parsed
+ * only once even when several modules (or copies of the file) use it. Sessions are identified by
+ * their graph and threading options: Session::Run is thread-safe, so that a single session, holding
+ * the only copy of the graph constants, can be used concurrently by all stream modules.
+ * The cache does not own its entries, they live as long as they are used.
+ */
+
+#ifndef PHYSICSTOOLS_TENSORFLOW_SESSIONCACHE_H
+#define PHYSICSTOOLS_TENSORFLOW_SESSIONCACHE_H
+
+#include "PhysicsTools/TensorFlow/interface/TensorFlow.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace tensorflow
+{
+
+class SessionCache
+{
+public:
+    static SessionCache& instance();
+
+    // returns the graph saved as a protobuf file at pbFile, loaded once per file content
+    std::shared_ptr<const GraphDef> getGraph(const std::string& pbFile);
+
+    // returns a session containing the graph saved at pbFile, shared by all callers asking for the
+    // same graph content and threading options
+    // the graph def is not kept alive by the session, use getGraph to keep it
+    std::shared_ptr<Session> getSession(const std::string& pbFile, int nThreads = 1,
+        const std::string& singleThreadPool = "no_threads");
+
+private:
+    SessionCache() = default;
+
+    std::shared_ptr<const GraphDef> getGraph(const std::string& pbFile, std::string& key);
+
+    std::mutex mutex_;
+    std::map<std::string, std::weak_ptr<const GraphDef>> graphs_;
+    std::map<std::string, std::weak_ptr<Session>> sessions_;
+};
+
+} // namespace tensorflow
+
+#endif // PHYSICSTOOLS_TENSORFLOW_SESSIONCACHE_H
@@ -70,12 +70,12 @@ Session* createSession(MetaGraphDef* metaGraph, const std::string& exportDir, in
 
 // return a new session that will contain an already loaded graph def, sessionOptions are predefined
 // transfers ownership
-Session* createSession(GraphDef* graphDef, SessionOptions& sessionOptions);
+Session* createSession(const GraphDef* graphDef, SessionOptions& sessionOptions);
 
 // return a new session that will contain an already loaded graph def, threading options are
 // inferred from nThreads
 // transfers ownership
-Session* createSession(GraphDef* graphDef, int nThreads = 1);
+Session* createSession(const GraphDef* graphDef, int nThreads = 1);
 
 // closes a session, calls its destructor, resets the pointer, and returns true on success
 bool closeSession(Session*& session);
@@ -0,0 +1,6 @@
+#include "PhysicsTools/TensorFlow/interface/BatchingService.h"
+#include "FWCore/ServiceRegistry/interface/ServiceMaker.h"
+
+typedef tensorflow::BatchingService TFBatchingService;
+
+DEFINE_FWK_SERVICE(TFBatchingService);
@@ -0,0 +1,304 @@
+/*
+ * Service gathering the inference requests of several streams into batches.
+ */
+
+#include "PhysicsTools/TensorFlow/interface/BatchingService.h"
+#include "PhysicsTools/TensorFlow/interface/SessionCache.h"
+
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+
+#include "tensorflow/core/framework/tensor_util.h"
+
+#include <exception>
+
+namespace tensorflow
+{
+
+namespace
+{
+
+// fixed inputs are the same when their types, shapes and values are
+bool sameTensor(const Tensor& a, const Tensor& b)
+{
+    if (a.dtype() != b.dtype() || a.shape() != b.shape())
+    {
+        return false;
+    }
+    if (DataTypeCanUseMemcpy(a.dtype()))
+    {
+        return a.tensor_data() == b.tensor_data();
+    }
+    return a.SummarizeValue(a.NumElements()) == b.SummarizeValue(b.NumElements());
+}
+
+} // namespace
+
+BatchingService::BatchingService(const edm::ParameterSet& pset, edm::ActivityRegistry& registry)
+    : maxBatchSize_(pset.getUntrackedParameter<unsigned int>("maxBatchSize"))
+    , timeout_(pset.getUntrackedParameter<unsigned int>("timeout"))
+    , nThreads_(pset.getUntrackedParameter<unsigned int>("nThreads"))
+    , singleThreadPool_(pset.getUntrackedParameter<std::string>("singleThreadPool"))
+    , shouldStop_(false)
+{
+    setLogging("3");
+
+    registry.watchPostEndJob(this, &BatchingService::postEndJob);
+}
+
+BatchingService::~BatchingService()
+{
+    stop();
+}
+
+void BatchingService::fillDescriptions(edm::ConfigurationDescriptions& descriptions)
+{
+    edm::ParameterSetDescription desc;
+    desc.addUntracked<unsigned int>("maxBatchSize", 256)
+        ->setComment("number of entries (e.g. jets) from which a batch is evaluated right away");
+    desc.addUntracked<unsigned int>("timeout", 1000)
+        ->setComment("maximum time in microseconds a request waits for other ones");
+    desc.addUntracked<unsigned int>("nThreads", 1);
+    desc.addUntracked<std::string>("singleThreadPool", "no_threads");
+    descriptions.add("TFBatchingService", desc);
+}
+
+BatchingService::ModelID BatchingService::registerModel(const std::string& pbFile,
+    const NamedTensorList& fixedInputs, const std::vector<std::string>& outputNames)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    // share the model with the modules using the same graph in the same way
+    for (ModelID i = 0; i < models_.size(); i++)
+    {
+        const Model& model = *models_[i];
+        if (model.pbFile != pbFile || model.outputNames != outputNames
+            || model.fixedInputs.size() != fixedInputs.size())
+        {
+            continue;
+        }
+        bool same = true;
+        for (size_t j = 0; j < fixedInputs.size(); j++)
+        {
+            same &= model.fixedInputs[j].first == fixedInputs[j].first
+                && sameTensor(model.fixedInputs[j].second, fixedInputs[j].second);
+        }
+        if (same)
+        {
+            return i;
+        }
+    }
+
+    auto model = std::make_unique<Model>();
+    model->pbFile = pbFile;
+    model->fixedInputs = fixedInputs;
+    model->outputNames = outputNames;
+    model->session = SessionCache::instance().getSession(pbFile, nThreads_, singleThreadPool_);
+    models_.push_back(std::move(model));
+
+    if (!thread_)
+    {
+        start();
+    }
+
+    return models_.size() - 1;
+}
+
+void BatchingService::runAsync(ModelID modelID, const NamedTensorList* inputs,
+    std::vector<Tensor>* outputs, edm::WaitingTaskWithArenaHolder holder)
+{
+    if (inputs->empty())
+    {
+        throw cms::Exception("InvalidTensor") << "no input tensors given for batching";
+    }
+    const int64 size = inputs->front().second.dims() > 0 ? inputs->front().second.dim_size(0) : 0;
+    for (const auto& input : *inputs)
+    {
+        if (input.second.dims() == 0 || input.second.dim_size(0) != size)
+        {
+            throw cms::Exception("InvalidTensor")
+                << "input '" << input.first << "' has shape " << input.second.shape().DebugString()
+                << ", expected a first dimension of " << size;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        Model& model = *models_.at(modelID);
+        model.pending.push_back(Request{ inputs, outputs, size, std::move(holder), Clock::now() });
+        model.pendingSize += size;
+    }
+    cond_.notify_one(); // wakes up the server thread
+}
+
+void BatchingService::postEndJob()
+{
+    stop();
+}
+
+void BatchingService::start()
+{
+    thread_ = std::make_unique<std::thread>([this]() { serverDoWork(); });
+}
+
+void BatchingService::stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        shouldStop_ = true;
+    }
+    cond_.notify_one();
+    if (thread_)
+    {
+        thread_->join();
+        thread_.reset();
+    }
+}
+
+void BatchingService::serverDoWork()
+{
+    std::unique_lock<std::mutex> lk(mutex_);
+    while (!shouldStop_)
+    {
+        // look for a model with a full batch or an expired request, otherwise for the next deadline
+        const Clock::time_point now = Clock::now();
+        Clock::time_point deadline = Clock::time_point::max();
+        Model* ready = nullptr;
+        for (auto& model : models_)
+        {
+            if (model->pending.empty())
+            {
+                continue;
+            }
+            const Clock::time_point expiry = model->pending.front().submitted + timeout_;
+            if (model->pendingSize >= maxBatchSize_ || expiry <= now)
+            {
+                ready = model.get();
+                break;
+            }
+            deadline = std::min(deadline, expiry);
+        }
+
+        if (ready == nullptr)
+        {
+            if (deadline == Clock::time_point::max())
+            {
+                cond_.wait(lk);
+            }
+            else
+            {
+                cond_.wait_until(lk, deadline);
+            }
+            continue;
+        }
+
+        // take the oldest requests up to maxBatchSize_ entries, at least one
+        std::vector<Request> batch;
+        int64 batchSize = 0;
+        auto& pending = ready->pending;
+        while (!pending.empty()
+            && (batch.empty() || batchSize + pending.front().size <= maxBatchSize_))
+        {
+            batchSize += pending.front().size;
+            batch.push_back(std::move(pending.front()));
+            pending.pop_front();
+        }
+        ready->pendingSize -= batchSize;
+
+        // let the streams submit while the batch is evaluated, on this thread (see the header)
+        lk.unlock();
+        runBatch(*ready, batch);
+        lk.lock();
+    }
+}
+
+void BatchingService::runBatch(Model& model, std::vector<Request>& batch)
+{
+    std::exception_ptr exceptionPtr;
+    try
+    {
+        const NamedTensorList& first = *batch.front().inputs;
+
+        // concatenate the inputs of the requests, tensors are shallow copies when not batched
+        NamedTensorList inputs;
+        inputs.reserve(first.size() + model.fixedInputs.size());
+        for (size_t i = 0; i < first.size(); i++)
+        {
+            if (batch.size() == 1)
+            {
+                inputs.push_back(first[i]);
+                continue;
+            }
+            std::vector<Tensor> parts;
+            parts.reserve(batch.size());
+            for (const auto& request : batch)
+            {
+                const NamedTensorList& requestInputs = *request.inputs;
+                if (requestInputs.size() != first.size() || requestInputs[i].first != first[i].first)
+                {
+                    throw cms::Exception("InvalidTensor")
+                        << "requests for graph " << model.pbFile << " have different inputs";
+                }
+                parts.push_back(requestInputs[i].second);
+            }
+            Tensor batched;
+            Status status = tensor::Concat(parts, &batched);
+            if (!status.ok())
+            {
+                throw cms::Exception("InvalidTensor")
+                    << "error while batching input '" << first[i].first << "': "
+                    << status.ToString();
+            }
+            inputs.emplace_back(first[i].first, std::move(batched));
+        }
+        inputs.insert(inputs.end(), model.fixedInputs.begin(), model.fixedInputs.end());
+
+        std::vector<Tensor> outputs;
+        run(model.session.get(), inputs, model.outputNames, &outputs);
+
+        // split the outputs back into the requests
+        if (batch.size() == 1)
+        {
+            *batch.front().outputs = std::move(outputs);
+        }
+        else
+        {
+            std::vector<int64> sizes;
+            sizes.reserve(batch.size());
+            for (auto& request : batch)
+            {
+                sizes.push_back(request.size);
+                request.outputs->clear();
+                request.outputs->reserve(outputs.size());
+            }
+            for (size_t i = 0; i < outputs.size(); i++)
+            {
+                std::vector<Tensor> parts;
+                Status status = tensor::Split(outputs[i], sizes, &parts);
+                if (!status.ok())
+                {
+                    throw cms::Exception("InvalidTensor")
+                        << "error while splitting output '" << model.outputNames[i]
+                        << "': " << status.ToString();
+                }
+                for (size_t j = 0; j < batch.size(); j++)
+                {
+                    batch[j].outputs->push_back(std::move(parts[j]));
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        exceptionPtr = std::current_exception();
+    }
+
+    for (auto& request : batch)
+    {
+        request.holder.doneWaiting(exceptionPtr);
+    }
+}
+
+} // namespace tensorflow
@@ -0,0 +1,75 @@
+/*
+ * Process-wide cache of graphs and sessions, shared by all modules and streams.
+ */
+
+#include "PhysicsTools/TensorFlow/interface/SessionCache.h"
+
+#include "FWCore/Utilities/interface/Digest.h"
+
+#include "tensorflow/core/platform/protobuf.h"
+
+namespace tensorflow
+{
+
+SessionCache& SessionCache::instance()
+{
+    static SessionCache cache;
+    return cache;
+}
+
+std::shared_ptr<const GraphDef> SessionCache::getGraph(const std::string& pbFile)
+{
+    std::string key;
+    return getGraph(pbFile, key);
+}
+
+std::shared_ptr<const GraphDef> SessionCache::getGraph(const std::string& pbFile, std::string& key)
+{
+    // the file is read in any case to identify its content
+    std::string content;
+    Status status = ReadFileToString(Env::Default(), pbFile, &content);
+    if (!status.ok())
+    {
+        throw cms::Exception("InvalidGraphDef")
+            << "error while loading graph def: " << status.ToString();
+    }
+    key = cms::Digest(content).digest().toString();
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    std::shared_ptr<const GraphDef> graphDef = graphs_[key].lock();
+    if (!graphDef)
+    {
+        auto newGraphDef = std::make_shared<GraphDef>();
+        if (!ParseProtoUnlimited(newGraphDef.get(), content))
+        {
+            throw cms::Exception("InvalidGraphDef")
+                << "error while loading graph def: cannot parse " << pbFile;
+        }
+        graphDef = newGraphDef;
+        graphs_[key] = graphDef;
+    }
+    return graphDef;
+}
+
+std::shared_ptr<Session> SessionCache::getSession(const std::string& pbFile, int nThreads,
+    const std::string& singleThreadPool)
+{
+    std::string key;
+    std::shared_ptr<const GraphDef> graphDef = getGraph(pbFile, key);
+
+    SessionOptions sessionOptions;
+    setThreading(sessionOptions, nThreads, singleThreadPool);
+    key += "/" + std::to_string(nThreads) + "/" + sessionOptions.target;
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    std::shared_ptr<Session> session = sessions_[key].lock();
+    if (!session)
+    {
+        session = std::shared_ptr<Session>(createSession(graphDef.get(), sessionOptions),
+            [](Session* s) { closeSession(s); });
+        sessions_[key] = session;
+    }
+    return session;
+}
+
+} // namespace tensorflow
@@ -162,7 +162,7 @@ Session* createSession(MetaGraphDef* metaGraph, const std::string& exportDir, in
     return createSession(metaGraph, exportDir, sessionOptions);
 }
 
-Session* createSession(GraphDef* graphDef, SessionOptions& sessionOptions)
+Session* createSession(const GraphDef* graphDef, SessionOptions& sessionOptions)
 {
     // create a new, empty session
     Session* session = createSession(sessionOptions);
@@ -181,7 +181,7 @@ Session* createSession(GraphDef* graphDef, SessionOptions& sessionOptions)
     return session;
 }
 
-Session* createSession(GraphDef* graphDef, int nThreads)
+Session* createSession(const GraphDef* graphDef, int nThreads)
 {
     // create session options and set thread options
     SessionOptions sessionOptions;
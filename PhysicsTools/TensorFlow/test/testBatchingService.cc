@@ -0,0 +1,198 @@
+/*
+ * Tests for the service gathering the inference requests of several streams into batches.
+ * Based on TensorFlow C++ API 1.3.
+ * For more info, see https://gitlab.cern.ch/mrieger/CMSSW-DNN.
+ */
+
+#include <boost/filesystem.hpp>
+#include <cppunit/extensions/HelperMacros.h>
+#include <atomic>
+#include <stdexcept>
+
+#include "PhysicsTools/TensorFlow/interface/BatchingService.h"
+
+#include "FWCore/Concurrency/interface/WaitingTask.h"
+#include "FWCore/Concurrency/interface/WaitingTaskList.h"
+#include "FWCore/Concurrency/interface/WaitingTaskWithArenaHolder.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
+
+std::string cmsswPath(std::string path)
+{
+    if (path.size() > 0 && path.substr(0, 1) != "/")
+    {
+        path = "/" + path;
+    }
+
+    std::string base = std::string(std::getenv("CMSSW_BASE"));
+    std::string releaseBase = std::string(std::getenv("CMSSW_RELEASE_BASE"));
+
+    return (boost::filesystem::exists(base.c_str()) ? base : releaseBase) + path;
+}
+
+class testBatchingService : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(testBatchingService);
+    CPPUNIT_TEST(checkAll);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    std::string dataPath;
+
+    void setUp();
+    void tearDown();
+    void checkAll();
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testBatchingService);
+
+namespace
+{
+
+// submits the inputs as the acquire method of a stream module and waits for the request to be done
+std::exception_ptr runAndWait(tensorflow::BatchingService& service,
+    tensorflow::BatchingService::ModelID modelID, const tensorflow::NamedTensorList& inputs,
+    std::vector<tensorflow::Tensor>& outputs)
+{
+    std::exception_ptr exceptionPtr;
+    auto waitTask = edm::make_empty_waiting_task();
+    waitTask->set_ref_count(2);
+    auto task = edm::make_waiting_task(waitTask->allocate_child(),
+        [&exceptionPtr](std::exception_ptr const* iPtr) {
+            if (iPtr)
+            {
+                exceptionPtr = *iPtr;
+            }
+        });
+    try
+    {
+        service.runAsync(modelID, &inputs, &outputs, edm::WaitingTaskWithArenaHolder(task));
+    }
+    catch (...)
+    {
+        exceptionPtr = std::current_exception();
+    }
+    waitTask->wait_for_all();
+    return exceptionPtr;
+}
+
+} // namespace
+
+void testBatchingService::setUp()
+{
+    dataPath = cmsswPath("/test/" + std::string(getenv("SCRAM_ARCH"))
+        + "/" + boost::filesystem::unique_path().string());
+
+    // create the graph
+    std::string testPath = cmsswPath("/src/PhysicsTools/TensorFlow/test");
+    std::string cmd = "python " + testPath + "/createconstantgraph.py " + dataPath;
+    std::array<char, 128> buffer;
+    std::string result;
+    std::shared_ptr<FILE> pipe(popen(cmd.c_str(), "r"), pclose);
+    if (!pipe)
+    {
+        throw std::runtime_error("popen() failed!");
+    }
+    while (!feof(pipe.get()))
+    {
+        if (fgets(buffer.data(), 128, pipe.get()) != NULL)
+        {
+            result += buffer.data();
+        }
+    }
+    std::cout << std::endl
+              << result << std::endl;
+}
+
+void testBatchingService::tearDown()
+{
+    if (boost::filesystem::exists(dataPath))
+    {
+        boost::filesystem::remove_all(dataPath);
+    }
+}
+
+void testBatchingService::checkAll()
+{
+    std::string pbFile = dataPath + "/constantgraph.pb";
+    tensorflow::setLogging();
+
+    // the requests wait long enough for the ones of the other streams to be batched with them
+    edm::ParameterSet pset;
+    pset.addUntrackedParameter<unsigned int>("maxBatchSize", 32);
+    pset.addUntrackedParameter<unsigned int>("timeout", 20000);
+    pset.addUntrackedParameter<unsigned int>("nThreads", 1);
+    pset.addUntrackedParameter<std::string>("singleThreadPool", "no_threads");
+    edm::ActivityRegistry registry;
+    tensorflow::BatchingService service(pset, registry);
+
+    // the model is shared for the same fixed input values only
+    tensorflow::Tensor scale(tensorflow::DT_FLOAT, {});
+    scale.scalar<float>()() = 2.0;
+    tensorflow::Tensor otherScale(tensorflow::DT_FLOAT, {});
+    otherScale.scalar<float>()() = 3.0;
+    tensorflow::BatchingService::ModelID modelID
+        = service.registerModel(pbFile, { { "scale", scale } }, { "output" });
+    CPPUNIT_ASSERT(service.registerModel(pbFile, { { "scale", scale } }, { "output" }) == modelID);
+    tensorflow::BatchingService::ModelID otherModelID
+        = service.registerModel(pbFile, { { "scale", otherScale } }, { "output" });
+    CPPUNIT_ASSERT(otherModelID != modelID);
+
+    // streams submitting requests of different sizes to both models at once, the entries of each
+    // request having their own values (integers, for exact outputs): output = scale * (sum + 1)
+    const int nStreams = 8;
+    const int nEvents = 25;
+    std::atomic<int> failures { 0 };
+    tbb::task_arena arena(nStreams);
+    arena.execute([&]() {
+        tbb::parallel_for(0, nStreams, [&](int stream) {
+            for (int event = 0; event < nEvents; event++)
+            {
+                const tensorflow::int64 size = 1 + (stream + event) % 5;
+                const bool other = (stream + event) % 3 == 0;
+                tensorflow::NamedTensorList inputs {
+                    { "input", tensorflow::Tensor(tensorflow::DT_FLOAT, { size, 10 }) }
+                };
+                auto input = inputs[0].second.matrix<float>();
+                for (tensorflow::int64 i = 0; i < size; i++)
+                {
+                    for (int j = 0; j < 10; j++)
+                    {
+                        input(i, j) = 1000 * stream + 10 * event + i + j;
+                    }
+                }
+
+                std::vector<tensorflow::Tensor> outputs;
+                std::exception_ptr exceptionPtr
+                    = runAndWait(service, other ? otherModelID : modelID, inputs, outputs);
+                if (exceptionPtr || outputs.size() != 1 || outputs[0].dims() != 2
+                    || outputs[0].dim_size(0) != size || outputs[0].dim_size(1) != 1)
+                {
+                    failures++;
+                    continue;
+                }
+                auto output = outputs[0].matrix<float>();
+                for (tensorflow::int64 i = 0; i < size; i++)
+                {
+                    float sum = 10 * (1000 * stream + 10 * event + i) + 45;
+                    if (output(i, 0) != (other ? 3.f : 2.f) * (sum + 1))
+                    {
+                        failures++;
+                    }
+                }
+            }
+        });
+    });
+    CPPUNIT_ASSERT(failures == 0);
+
+    // inputs with different first dimensions are rejected, the task being released
+    tensorflow::NamedTensorList invalid { { "input", tensorflow::Tensor(tensorflow::DT_FLOAT, { 2, 10 }) },
+        { "other", tensorflow::Tensor(tensorflow::DT_FLOAT, { 3, 10 }) } };
+    std::vector<tensorflow::Tensor> outputs;
+    CPPUNIT_ASSERT(runAndWait(service, modelID, invalid, outputs) != nullptr);
+    CPPUNIT_ASSERT(outputs.empty());
+}
@@ -0,0 +1,125 @@
+/*
+ * Tests for the process-wide cache of graphs and sessions.
+ * Based on TensorFlow C++ API 1.3.
+ * For more info, see https://gitlab.cern.ch/mrieger/CMSSW-DNN.
+ *
+ * Author: Marcel Rieger
+ */
+
+#include <boost/filesystem.hpp>
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdexcept>
+
+#include "PhysicsTools/TensorFlow/interface/SessionCache.h"
+
+std::string cmsswPath(std::string path)
+{
+    if (path.size() > 0 && path.substr(0, 1) != "/")
+    {
+        path = "/" + path;
+    }
+
+    std::string base = std::string(std::getenv("CMSSW_BASE"));
+    std::string releaseBase = std::string(std::getenv("CMSSW_RELEASE_BASE"));
+
+    return (boost::filesystem::exists(base.c_str()) ? base : releaseBase) + path;
+}
+
+class testSessionCache : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(testSessionCache);
+    CPPUNIT_TEST(checkAll);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    std::string dataPath;
+
+    void setUp();
+    void tearDown();
+    void checkAll();
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testSessionCache);
+
+void testSessionCache::setUp()
+{
+    dataPath = cmsswPath("/test/" + std::string(getenv("SCRAM_ARCH"))
+        + "/" + boost::filesystem::unique_path().string());
+
+    // create the graph
+    std::string testPath = cmsswPath("/src/PhysicsTools/TensorFlow/test");
+    std::string cmd = "python " + testPath + "/createconstantgraph.py " + dataPath;
+    std::array<char, 128> buffer;
+    std::string result;
+    std::shared_ptr<FILE> pipe(popen(cmd.c_str(), "r"), pclose);
+    if (!pipe)
+    {
+        throw std::runtime_error("popen() failed!");
+    }
+    while (!feof(pipe.get()))
+    {
+        if (fgets(buffer.data(), 128, pipe.get()) != NULL)
+        {
+            result += buffer.data();
+        }
+    }
+    std::cout << std::endl
+              << result << std::endl;
+}
+
+void testSessionCache::tearDown()
+{
+    if (boost::filesystem::exists(dataPath))
+    {
+        boost::filesystem::remove_all(dataPath);
+    }
+}
+
+void testSessionCache::checkAll()
+{
+    std::string pbFile = dataPath + "/constantgraph.pb";
+    tensorflow::setLogging();
+    tensorflow::SessionCache& cache = tensorflow::SessionCache::instance();
+
+    // the graph is loaded once
+    std::shared_ptr<const tensorflow::GraphDef> graphDef = cache.getGraph(pbFile);
+    CPPUNIT_ASSERT(graphDef != nullptr);
+    CPPUNIT_ASSERT(cache.getGraph(pbFile) == graphDef);
+
+    // a copy of the file gives the same graph
+    std::string pbFileCopy = dataPath + "/constantgraph_copy.pb";
+    boost::filesystem::copy_file(pbFile, pbFileCopy);
+    CPPUNIT_ASSERT(cache.getGraph(pbFileCopy) == graphDef);
+
+    // sessions are shared for the same threading options
+    std::shared_ptr<tensorflow::Session> session = cache.getSession(pbFile);
+    CPPUNIT_ASSERT(session != nullptr);
+    CPPUNIT_ASSERT(cache.getSession(pbFileCopy) == session);
+    CPPUNIT_ASSERT(cache.getSession(pbFile, 1, "tbb") != session);
+
+    // example evaluation
+    tensorflow::Tensor input(tensorflow::DT_FLOAT, { 1, 10 });
+    float* d = input.flat<float>().data();
+    for (size_t i = 0; i < 10; i++, d++)
+    {
+        *d = float(i);
+    }
+    tensorflow::Tensor scale(tensorflow::DT_FLOAT, {});
+    scale.scalar<float>()() = 1.0;
+
+    std::vector<tensorflow::Tensor> outputs;
+    tensorflow::run(session.get(), { { "input", input }, { "scale", scale } }, { "output" },
+        &outputs);
+    CPPUNIT_ASSERT(outputs.size() == 1);
+    std::cout << outputs[0].DebugString() << std::endl;
+    CPPUNIT_ASSERT(outputs[0].matrix<float>()(0, 0) == 46.);
+
+    // the entries are released with their last user
+    std::weak_ptr<tensorflow::Session> released = session;
+    session.reset();
+    CPPUNIT_ASSERT(released.expired());
+
+    // check for exception
+    CPPUNIT_ASSERT_THROW(cache.getGraph(dataPath + "/foo.pb"), cms::Exception);
+}
@@ -8,36 +8,36 @@
 #include "FWCore/Framework/interface/makeRefToBaseProdFrom.h"
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
 #include "FWCore/Utilities/interface/StreamID.h"
 
 #include "DataFormats/BTauReco/interface/JetTag.h"
 
 #include "DataFormats/BTauReco/interface/DeepFlavourTagInfo.h"
 
+#include "PhysicsTools/TensorFlow/interface/BatchingService.h"
+#include "PhysicsTools/TensorFlow/interface/SessionCache.h"
 #include "PhysicsTools/TensorFlow/interface/TensorFlow.h"
 
 #include "tensor_fillers.h"
 
 // Declaration of the data structure that is hold by the edm::GlobalCache.
-// In TensorFlow, the computational graph is stored in a stateless graph object which can be shared
-// by multiple session instances which handle the initialization of variables related to the graph.
-// Following this approach in CMSSW, a graph should be stored in a GlobalCache which can be accessed
-// by sessions owned by multiple stream module copies. Instead of using only the plain graph, we
-// make use of a cache struct that can be extended in the future if nedded. In addition, the graph
-// is protected via std::atomic, which should not affect the performance as it is only accessed in
-// the module constructor and not in the actual produce loop.
+// Session::Run is thread-safe, so that a single session can be used by all stream module copies:
+// it is taken from the process-wide tensorflow::SessionCache, which also shares it with the other
+// modules using the same graph with the same threading options, and the graph constants are held
+// only once. Instead of using only the plain session, we make use of a cache struct that can be
+// extended in the future if nedded.
+// When the jets are evaluated through the TFBatchingService, the service holds the session and the
+// cache stays empty.
 struct DeepFlavourTFCache {
-  DeepFlavourTFCache() : graphDef(nullptr) {
-  }
-
-  std::atomic<tensorflow::GraphDef*> graphDef;
+  std::shared_ptr<tensorflow::Session> session;
 };
 
-class DeepFlavourTFJetTagsProducer : public edm::stream::EDProducer<edm::GlobalCache<DeepFlavourTFCache>> {
+class DeepFlavourTFJetTagsProducer : public edm::stream::EDProducer<edm::GlobalCache<DeepFlavourTFCache>, edm::ExternalWork> {
 
   public:
     explicit DeepFlavourTFJetTagsProducer(const edm::ParameterSet&, const DeepFlavourTFCache*);
-    ~DeepFlavourTFJetTagsProducer() override;
+    ~DeepFlavourTFJetTagsProducer() override = default;
 
     static void fillDescriptions(edm::ConfigurationDescriptions&);
 
@@ -62,21 +62,35 @@ class DeepFlavourTFJetTagsProducer : public edm::stream::EDProducer<edm::GlobalC
     typedef reco::JetTagCollection JetTagCollection;
 
     void beginStream(edm::StreamID) override {}
+    void acquire(edm::Event const&, edm::EventSetup const&, edm::WaitingTaskWithArenaHolder) override;
     void produce(edm::Event&, const edm::EventSetup&) override;
     void endStream() override {}
 
+    // fill the input tensors at batch index jet_bn with the features of a jet
+    void fill_jet(const reco::DeepFlavourTagInfo&, std::size_t jet_bn,
+                  tensorflow::NamedTensorList& input_tensors) const;
+    // set the flavour probabilities of a jet from the outputs at batch index jet_bn
+    void set_tags(const reco::DeepFlavourTagInfo&, const tensorflow::Tensor& flavour_output,
+                  std::size_t jet_bn, std::vector<std::unique_ptr<JetTagCollection>>& output_tags) const;
+
     const edm::EDGetTokenT< TagInfoCollection > src_;
     std::vector<std::pair<std::string,std::vector<unsigned int>>> flav_pairs_;
     std::vector<std::string> input_names_;
     std::vector<std::string> output_names_;
     std::vector<std::string> lp_names_;
 
-    // session for TF evaluation
+    // session for TF evaluation, owned by the global cache
     tensorflow::Session* session_;
     // vector of learning phase tensors, i.e., boolean scalar tensors pointing to false
     std::vector<tensorflow::Tensor> lp_tensors_;
     // flag to evaluate model batch or jet by jet
     bool batch_eval_;
+
+    // all the jets of the event evaluated in batches gathered across streams by the TFBatchingService
+    const bool use_batching_service_;
+    tensorflow::BatchingService::ModelID model_id_;
+    tensorflow::NamedTensorList service_inputs_;
+    std::vector<tensorflow::Tensor> service_outputs_;
 };
 
 DeepFlavourTFJetTagsProducer::DeepFlavourTFJetTagsProducer(const edm::ParameterSet& iConfig,
@@ -85,18 +99,11 @@ DeepFlavourTFJetTagsProducer::DeepFlavourTFJetTagsProducer(const edm::ParameterS
   input_names_(iConfig.getParameter<std::vector<std::string>>("input_names")),
   output_names_(iConfig.getParameter<std::vector<std::string>>("output_names")),
   lp_names_(iConfig.getParameter<std::vector<std::string>>("lp_names")),
-  session_(nullptr),
-  batch_eval_(iConfig.getParameter<bool>("batch_eval"))
+  session_(cache->session.get()),
+  batch_eval_(iConfig.getParameter<bool>("batch_eval")),
+  use_batching_service_(iConfig.getParameter<bool>("use_batching_service")),
+  model_id_(0)
 {
-  // get threading config and build session options
-  size_t nThreads = iConfig.getParameter<unsigned int>("nThreads");
-  std::string singleThreadPool = iConfig.getParameter<std::string>("singleThreadPool");
-  tensorflow::SessionOptions sessionOptions;
-  tensorflow::setThreading(sessionOptions, nThreads, singleThreadPool);
-
-  // create the session using the meta graph from the cache
-  session_ = tensorflow::createSession(cache->graphDef, sessionOptions);
-
   // get output names from flav_table
   const auto & flav_pset = iConfig.getParameter<edm::ParameterSet>("flav_table");
   for (const auto flav_pair : flav_pset.tbl()) {
@@ -117,13 +124,15 @@ DeepFlavourTFJetTagsProducer::DeepFlavourTFJetTagsProducer(const edm::ParameterS
     t.scalar<bool>()() = false;
     lp_tensors_.push_back(t);
   }
-}
 
-DeepFlavourTFJetTagsProducer::~DeepFlavourTFJetTagsProducer()
-{
-  // close and delete the session
-  if (session_ != nullptr) {
-    tensorflow::closeSession(session_);
+  if (use_batching_service_) {
+    tensorflow::NamedTensorList lp_inputs;
+    for (size_t i = 0; i < lp_names_.size(); i++) {
+      lp_inputs.emplace_back(lp_names_[i], lp_tensors_[i]);
+    }
+    edm::Service<tensorflow::BatchingService> service;
+    model_id_ = service->registerModel(iConfig.getParameter<edm::FileInPath>("graph_path").fullPath(),
+                                       lp_inputs, output_names_);
   }
 }
 
@@ -153,6 +162,8 @@ void DeepFlavourTFJetTagsProducer::fillDescriptions(edm::ConfigurationDescriptio
   }
 
   desc.add<bool>("batch_eval", false);
+  desc.add<bool>("use_batching_service", false)->setComment(
+    "evaluate the jets with the TFBatchingService, which has to be configured, instead of a session of the module");
 
   desc.add<unsigned int>("nThreads", 1);
   desc.add<std::string>("singleThreadPool", "no_threads");
@@ -169,20 +180,109 @@ std::unique_ptr<DeepFlavourTFCache> DeepFlavourTFJetTagsProducer::initializeGlob
   // get the pb file
   std::string pbFile = iConfig.getParameter<edm::FileInPath>("graph_path").fullPath();
 
-  // load the graph def and save it in the cache
+  // get the shared session, with the graph loaded, and save it in the cache
   DeepFlavourTFCache* cache = new DeepFlavourTFCache();
-  cache->graphDef = tensorflow::loadGraphDef(pbFile);
+  if (!iConfig.getParameter<bool>("use_batching_service")) {
+    cache->session = tensorflow::SessionCache::instance().getSession(pbFile,
+      iConfig.getParameter<unsigned int>("nThreads"), iConfig.getParameter<std::string>("singleThreadPool"));
+  }
 
   return std::unique_ptr<DeepFlavourTFCache>(cache);
 }
 
 void DeepFlavourTFJetTagsProducer::globalEndJob(const DeepFlavourTFCache* cache)
 {
-  if (cache->graphDef != nullptr) {
-    delete cache->graphDef;
+  // the session is released together with the cache
+}
+
+void DeepFlavourTFJetTagsProducer::fill_jet(const reco::DeepFlavourTagInfo& tag_info, std::size_t jet_bn,
+                                            tensorflow::NamedTensorList& input_tensors) const
+{
+  // jet and other global features
+  const auto & features = tag_info.features();
+  jet_tensor_filler(input_tensors.at(kGlobal).second, jet_bn, features);
+
+  // c_pf candidates
+  auto max_c_pf_n = std::min(features.c_pf_features.size(),
+    (std::size_t) input_tensors.at(kChargedCandidates).second.dim_size(1));
+  for (std::size_t c_pf_n=0; c_pf_n < max_c_pf_n; c_pf_n++) {
+    const auto & c_pf_features = features.c_pf_features.at(c_pf_n);
+    c_pf_tensor_filler(input_tensors.at(kChargedCandidates).second,
+                       jet_bn, c_pf_n, c_pf_features);
+  }
+
+  // n_pf candidates
+  auto max_n_pf_n = std::min(features.n_pf_features.size(),
+    (std::size_t) input_tensors.at(kNeutralCandidates).second.dim_size(1));
+  for (std::size_t n_pf_n=0; n_pf_n < max_n_pf_n; n_pf_n++) {
+    const auto & n_pf_features = features.n_pf_features.at(n_pf_n);
+    n_pf_tensor_filler(input_tensors.at(kNeutralCandidates).second,
+                       jet_bn, n_pf_n, n_pf_features);
+  }
+
+  // sv candidates
+  auto max_sv_n = std::min(features.sv_features.size(),
+    (std::size_t) input_tensors.at(kVertices).second.dim_size(1));
+  for (std::size_t sv_n=0; sv_n < max_sv_n; sv_n++) {
+    const auto & sv_features = features.sv_features.at(sv_n);
+    sv_tensor_filler(input_tensors.at(kVertices).second,
+                     jet_bn, sv_n, sv_features);
+  }
+
+  // last input: jet pt
+  input_tensors.at(kJetPt).second.matrix<float>()(jet_bn, 0) = features.jet_features.pt;
+}
+
+void DeepFlavourTFJetTagsProducer::set_tags(const reco::DeepFlavourTagInfo& tag_info,
+                                            const tensorflow::Tensor& flavour_output, std::size_t jet_bn,
+                                            std::vector<std::unique_ptr<JetTagCollection>>& output_tags) const
+{
+  const auto & jet_ref = tag_info.jet();
+  for (std::size_t flav_n=0; flav_n < flav_pairs_.size(); flav_n++) {
+    const auto & flav_pair = flav_pairs_.at(flav_n);
+    float o_sum = 0.;
+    for (const unsigned int & ind : flav_pair.second) {
+      o_sum += flavour_output.matrix<float>()(jet_bn, ind);
+    }
+    (*(output_tags.at(flav_n)))[jet_ref] = o_sum;
   }
 }
 
+void DeepFlavourTFJetTagsProducer::acquire(edm::Event const& iEvent, edm::EventSetup const& iSetup,
+                                           edm::WaitingTaskWithArenaHolder holder)
+{
+  // without the service the jets are evaluated in produce
+  if (!use_batching_service_) return;
+
+  edm::Handle<TagInfoCollection> tag_infos;
+  iEvent.getByToken(src_, tag_infos);
+
+  const int64_t n_jets = tag_infos->size();
+  if (n_jets == 0) return;
+
+  // one request with all the jets, the service batches it with those of the other streams
+  std::vector<tensorflow::TensorShape> input_sizes {
+    {n_jets, 15},         // input_1 - global jet features
+    {n_jets, 25, 16},     // input_2 - charged pf
+    {n_jets, 25, 6},      // input_3 - neutral pf
+    {n_jets, 4, 12},      // input_4 - vertices
+    {n_jets, 1}           // input_5 - jet pt for reg
+  };
+  service_inputs_.resize(input_sizes.size());
+  for (std::size_t i=0; i < input_sizes.size(); i++) {
+    service_inputs_[i] = tensorflow::NamedTensor(
+      input_names_[i], tensorflow::Tensor(tensorflow::DT_FLOAT, input_sizes.at(i)));
+    service_inputs_[i].second.flat<float>().setZero();
+  }
+
+  for (std::size_t jet_n=0; jet_n < (std::size_t) n_jets; jet_n++) {
+    fill_jet(tag_infos->at(jet_n), jet_n, service_inputs_);
+  }
+
+  edm::Service<tensorflow::BatchingService> service;
+  service->runAsync(model_id_, &service_inputs_, &service_outputs_, std::move(holder));
+}
+
 void DeepFlavourTFJetTagsProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
 {
 
@@ -201,102 +301,67 @@ void DeepFlavourTFJetTagsProducer::produce(edm::Event& iEvent, const edm::EventS
     }
   }
 
-  const int64_t n_jets = tag_infos->size();
-  // either all jets or one per batch for the time being
-  const int64_t n_batch_jets = batch_eval_ ?  n_jets : 1;
-
-  std::vector<tensorflow::TensorShape> input_sizes {
-    {n_batch_jets, 15},         // input_1 - global jet features
-    {n_batch_jets, 25, 16},     // input_2 - charged pf
-    {n_batch_jets, 25, 6},      // input_3 - neutral pf
-    {n_batch_jets, 4, 12},      // input_4 - vertices 
-    {n_batch_jets, 1}           // input_5 - jet pt for reg 
-  };
-
-  // create a list of named tensors, i.e. a vector of (string, Tensor) pairs, with proper size to
-  // prevent element copying that would occur via push_back's
-  // the default Tensor constructor creates a scalar so this should be fine w.r.t. to memory
-  tensorflow::NamedTensorList input_tensors;
-  input_tensors.resize(input_sizes.size() + lp_tensors_.size());
-
-  // add actual input tensors that hold physics information
-  for (std::size_t i=0; i < input_sizes.size(); i++) {
-    input_tensors[i] = tensorflow::NamedTensor(
-      input_names_[i], tensorflow::Tensor(tensorflow::DT_FLOAT, input_sizes.at(i)));
-  }
-
-  // add learning-phase tensors behind them
-  for (std::size_t i=0; i < lp_tensors_.size(); i++) {
-    input_tensors[input_sizes.size() + i] = tensorflow::NamedTensor(lp_names_[i], lp_tensors_[i]);
-  }
+  if (use_batching_service_) {
+    // all the jets were evaluated in a single request in acquire
+    for (std::size_t jet_n=0; jet_n < tag_infos->size(); jet_n++) {
+      set_tags(tag_infos->at(jet_n), service_outputs_.at(kJetFlavour), jet_n, output_tags);
+    }
+  } else {
+    const int64_t n_jets = tag_infos->size();
+    // either all jets or one per batch for the time being
+    const int64_t n_batch_jets = batch_eval_ ?  n_jets : 1;
+
+    std::vector<tensorflow::TensorShape> input_sizes {
+      {n_batch_jets, 15},         // input_1 - global jet features
+      {n_batch_jets, 25, 16},     // input_2 - charged pf
+      {n_batch_jets, 25, 6},      // input_3 - neutral pf
+      {n_batch_jets, 4, 12},      // input_4 - vertices 
+      {n_batch_jets, 1}           // input_5 - jet pt for reg 
+    };
 
-  std::size_t n_batches = n_jets/n_batch_jets; // either 1 or n_jets
-  for (std::size_t batch_n=0; batch_n < n_batches; batch_n++) {
+    // create a list of named tensors, i.e. a vector of (string, Tensor) pairs, with proper size to
+    // prevent element copying that would occur via push_back's
+    // the default Tensor constructor creates a scalar so this should be fine w.r.t. to memory
+    tensorflow::NamedTensorList input_tensors;
+    input_tensors.resize(input_sizes.size() + lp_tensors_.size());
 
-    // tensors have to be zeroed before filling per batch
+    // add actual input tensors that hold physics information
     for (std::size_t i=0; i < input_sizes.size(); i++) {
-      input_tensors[i].second.flat<float>().setZero();
+      input_tensors[i] = tensorflow::NamedTensor(
+        input_names_[i], tensorflow::Tensor(tensorflow::DT_FLOAT, input_sizes.at(i)));
     }
 
-    // fill values of the input tensors
-    for (std::size_t jet_bn=0; jet_bn < (std::size_t) n_batch_jets; jet_bn++) {
-
-      // global jet index (jet_bn is the jet batch index)
-      std::size_t jet_n = batch_n*n_batch_jets + jet_bn;
+    // add learning-phase tensors behind them
+    for (std::size_t i=0; i < lp_tensors_.size(); i++) {
+      input_tensors[input_sizes.size() + i] = tensorflow::NamedTensor(lp_names_[i], lp_tensors_[i]);
+    }
 
-      // jet and other global features
-      const auto & features = tag_infos->at(jet_n).features();
-      jet_tensor_filler(input_tensors.at(kGlobal).second, jet_bn, features);
+    std::size_t n_batches = n_jets/n_batch_jets; // either 1 or n_jets
+    for (std::size_t batch_n=0; batch_n < n_batches; batch_n++) {
 
-      // c_pf candidates
-      auto max_c_pf_n = std::min(features.c_pf_features.size(),
-        (std::size_t) input_sizes.at(kChargedCandidates).dim_size(1));
-      for (std::size_t c_pf_n=0; c_pf_n < max_c_pf_n; c_pf_n++) {
-        const auto & c_pf_features = features.c_pf_features.at(c_pf_n);
-        c_pf_tensor_filler(input_tensors.at(kChargedCandidates).second,
-                           jet_bn, c_pf_n, c_pf_features);
+      // tensors have to be zeroed before filling per batch
+      for (std::size_t i=0; i < input_sizes.size(); i++) {
+        input_tensors[i].second.flat<float>().setZero();
       }
 
-      // n_pf candidates
-      auto max_n_pf_n = std::min(features.n_pf_features.size(),
-        (std::size_t) input_sizes.at(kNeutralCandidates).dim_size(1));
-      for (std::size_t n_pf_n=0; n_pf_n < max_n_pf_n; n_pf_n++) {
-        const auto & n_pf_features = features.n_pf_features.at(n_pf_n);
-        n_pf_tensor_filler(input_tensors.at(kNeutralCandidates).second,
-                           jet_bn, n_pf_n, n_pf_features);
-      }
+      // fill values of the input tensors
+      for (std::size_t jet_bn=0; jet_bn < (std::size_t) n_batch_jets; jet_bn++) {
 
-      // sv candidates
-      auto max_sv_n = std::min(features.sv_features.size(),
-        (std::size_t) input_sizes.at(kVertices).dim_size(1));
-      for (std::size_t sv_n=0; sv_n < max_sv_n; sv_n++) {
-        const auto & sv_features = features.sv_features.at(sv_n);
-        sv_tensor_filler(input_tensors.at(kVertices).second,
-                         jet_bn, sv_n, sv_features);
+        // global jet index (jet_bn is the jet batch index)
+        std::size_t jet_n = batch_n*n_batch_jets + jet_bn;
+        fill_jet(tag_infos->at(jet_n), jet_bn, input_tensors);
       }
 
-      // last input: jet pt
-      input_tensors.at(kJetPt).second.matrix<float>()(jet_bn, 0) = features.jet_features.pt;
-    }
-
-    // run the session
-    std::vector<tensorflow::Tensor> outputs;
-    tensorflow::run(session_, input_tensors, output_names_, &outputs);
-
-    // set output values for flavour probs
-    for (std::size_t jet_bn=0; jet_bn < (std::size_t) n_batch_jets; jet_bn++) {
+      // run the session
+      std::vector<tensorflow::Tensor> outputs;
+      tensorflow::run(session_, input_tensors, output_names_, &outputs);
 
-      // global jet index (jet_bn is the jet batch index)
-      std::size_t jet_n = batch_n*n_batch_jets + jet_bn;
+      // set output values for flavour probs
+      for (std::size_t jet_bn=0; jet_bn < (std::size_t) n_batch_jets; jet_bn++) {
 
-      const auto & jet_ref = tag_infos->at(jet_n).jet();
-      for (std::size_t flav_n=0; flav_n < flav_pairs_.size(); flav_n++) {
-        const auto & flav_pair = flav_pairs_.at(flav_n);
-        float o_sum = 0.;
-        for (const unsigned int & ind : flav_pair.second) {
-          o_sum += outputs.at(kJetFlavour).matrix<float>()(jet_bn, ind);
-        }
-        (*(output_tags.at(flav_n)))[jet_ref] = o_sum;
+        // global jet index (jet_bn is the jet batch index)
+        std::size_t jet_n = batch_n*n_batch_jets + jet_bn;
+        set_tags(tag_infos->at(jet_n), outputs.at(kJetFlavour), jet_bn, output_tags);
       }
     }
   }
@@ -0,0 +1,131 @@
+#ifndef RecoJets_JetProducers_FastjetClusteringService_h
+#define RecoJets_JetProducers_FastjetClusteringService_h
+
+/*
+ * Service clustering the same fastjet inputs with several jet definitions.
+ *
+ * Jet producers declaring the same clustering group in their configuration
+ * register their jet and area definitions in their constructor. The first
+ * module of a group asking for its clustering in an event clusters the inputs
+ * with all the definitions of the group concurrently, the other modules of the
+ * group get their cluster sequence (and the rho and sigma computed from it)
+ * without clustering again. The clusterings are run without holding the lock
+ * of the stream, a module of the group asking for its clustering meanwhile
+ * computes it for itself. The ghosts of an area definition are generated
+ * once per event and group, and shared by all the definitions using the same
+ * ghost grid. With the seeds of the producers, the ghosts are the ones each
+ * producer would have generated alone.
+ *
+ * Only explicit ghosts are supported for the areas, the jets with implicit
+ * ghosts being computed from several internal clusterings in fastjet.
+ */
+
+#include "DataFormats/Provenance/interface/EventID.h"
+#include "FWCore/Utilities/interface/StreamID.h"
+
+#include "fastjet/AreaDefinition.hh"
+#include "fastjet/ClusterSequence.hh"
+#include "fastjet/GhostedAreaSpec.hh"
+#include "fastjet/JetDefinition.hh"
+#include "fastjet/PseudoJet.hh"
+
+#include <boost/shared_ptr.hpp>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace edm {
+  class ActivityRegistry;
+  class ConfigurationDescriptions;
+  class ParameterSet;
+  class StreamContext;
+  namespace service {
+    class SystemBounds;
+  }
+}
+
+class FastjetClusteringService
+{
+public:
+  typedef boost::shared_ptr<fastjet::ClusterSequence> ClusterSequencePtr;
+
+  struct ClusteringID {
+    unsigned int group;
+    unsigned int index;
+  };
+
+  FastjetClusteringService(const edm::ParameterSet& iConfig, edm::ActivityRegistry& iRegistry);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  // registers a clustering of the inputs of the group, to be called in the
+  // module constructors; modules registering the same jet and area
+  // definitions in a group share the clustering. The stream copies of a
+  // module register with the same module label and count as one user.
+  // areaDefinition is null for clusterings without area, it must use explicit
+  // ghosts otherwise, and plugin jet algorithms are not supported.
+  ClusteringID registerClustering(const std::string& group,
+				  const std::string& moduleLabel,
+				  const fastjet::JetDefinition& jetDefinition,
+				  const fastjet::AreaDefinition* areaDefinition);
+
+  // returns the clustering of the inputs in the event, all the clusterings of
+  // the group being run at the first call of the event on the stream.
+  // All the modules of a group must give the same inputs and seeds, a module
+  // giving other ones gets its clustering computed for itself.
+  // The ghosts are generated from the seeds when they are not empty.
+  ClusterSequencePtr cluster(edm::StreamID streamID,
+			     const edm::EventID& eventID,
+			     ClusteringID id,
+			     const std::vector<fastjet::PseudoJet>& inputs,
+			     const std::vector<int>& seeds);
+
+private:
+  struct Clustering {
+    fastjet::JetDefinition jetDefinition;
+    int ghostSpec;       // index in the ghost specs of the group, -1 without area
+    std::vector<std::string> users;  // labels of the registered modules
+  };
+
+  struct Group {
+    std::string name;
+    std::vector<Clustering> clusterings;
+    std::vector<fastjet::GhostedAreaSpec> ghostSpecs;
+  };
+
+  // clusterings of a group on a stream for the event being processed, the
+  // sequences are released once all their users got them, and at the end of
+  // the event for the modules which did not run
+  struct Slot {
+    std::mutex mutex;
+    edm::EventID eventID;
+    bool running = false;  // the clusterings of the event are being run
+    std::vector<int> seeds;
+    std::vector<fastjet::PseudoJet> inputs;
+    std::vector<ClusterSequencePtr> sequences;
+    std::vector<unsigned int> pending;
+  };
+
+  void preallocate(const edm::service::SystemBounds& bounds);
+  void postEvent(const edm::StreamContext& iContext);
+
+  // hands the sequence of the clustering to one of its users, the slot being
+  // locked
+  ClusterSequencePtr take(Slot& slot, unsigned int index) const;
+
+  // runs the given clusterings of the group, concurrently if allowed
+  std::vector<ClusterSequencePtr> runClusterings(const Group& group,
+						 const std::vector<unsigned int>& indices,
+						 const std::vector<fastjet::PseudoJet>& inputs,
+						 const std::vector<int>& seeds) const;
+
+  const bool concurrent_;
+
+  std::mutex mutex_;  // guards the registration
+  std::vector<Group> groups_;
+  std::vector<std::unique_ptr<Slot>> slots_;  // groups of stream 0, of stream 1, ...
+};
+
+#endif
@@ -0,0 +1,4 @@
+#include "RecoJets/JetProducers/interface/FastjetClusteringService.h"
+#include "FWCore/ServiceRegistry/interface/ServiceMaker.h"
+
+DEFINE_FWK_SERVICE(FastjetClusteringService);
@@ -24,6 +24,7 @@
 #include "FWCore/Framework/interface/ESHandle.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
 
 #include "Geometry/CaloGeometry/interface/CaloGeometry.h"
 #include "Geometry/Records/interface/CaloGeometryRecord.h"
@@ -162,6 +163,19 @@ FastjetJetProducer::FastjetJetProducer(const edm::ParameterSet& iConfig):
 	
 	if ( ( correctShape_ ) && ( ( gridMaxRapidity_ == -1 ) || ( gridSpacing_ == -1 )) ) 
 		throw cms::Exception("correctShape") << "Parameters gridMaxRapidity and/or gridSpacing for SoftDrop are not defined." << std::endl;
+
+	// modules of the same clustering group share the clustering of their inputs
+	const std::string clusteringGroup = iConfig.getParameter<std::string>("clusteringGroup");
+	useClusteringService_ = !clusteringGroup.empty();
+	if ( useClusteringService_ ) {
+		if ( makeTrackJet(jetTypeE) || voronoiRfact_ > 0 )
+			throw cms::Exception("clusteringGroup") << "Track jets and Voronoi areas cannot be clustered by the FastjetClusteringService." << std::endl;
+		edm::Service<FastjetClusteringService> service;
+		if ( !service.isAvailable() )
+			throw cms::Exception("clusteringGroup") << "The clustering group " << clusteringGroup << " is set but the FastjetClusteringService is not configured." << std::endl;
+		clusteringID_ = service->registerClustering( clusteringGroup, moduleLabel_, *fjJetDefinition_,
+							     ( doAreaFastjet_ || doRhoFastjet_ ) ? fjAreaDefinition_.get() : nullptr );
+	}
   
 }
 
@@ -352,7 +366,10 @@ void FastjetJetProducer::runAlgorithm( edm::Event & iEvent, edm::EventSetup cons
   fin.close();
   */
 
-  if ( !doAreaFastjet_ && !doRhoFastjet_) {
+  if ( useClusteringService_ ) {
+    edm::Service<FastjetClusteringService> service;
+    fjClusterSeq_ = service->cluster( iEvent.streamID(), iEvent.id(), clusteringID_, fjInputs_, fjSeeds_ );
+  } else if ( !doAreaFastjet_ && !doRhoFastjet_) {
     fjClusterSeq_ = ClusterSequencePtr( new fastjet::ClusterSequence( fjInputs_, *fjJetDefinition_ ) );
   } else if (voronoiRfact_ <= 0) {
     fjClusterSeq_ = ClusterSequencePtr( new fastjet::ClusterSequenceArea( fjInputs_, *fjJetDefinition_ , *fjAreaDefinition_ ) );
@@ -512,6 +529,7 @@ void FastjetJetProducer::fillDescriptionsFromFastJetProducer(edm::ParameterSetDe
 	desc.add<int>("maxDepth",	-1);
 	desc.add<int>("nFilt",       	-1);
 	desc.add<int>("MinVtxNdof",	5);
+	desc.add<std::string>("clusteringGroup",	"")->setComment("modules of the same group share the clustering of their inputs through the FastjetClusteringService");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,7 @@
 #include "DataFormats/RecoCandidate/interface/RecoChargedCandidate.h"
 
 #include "RecoJets/JetProducers/plugins/VirtualJetProducer.h"
+#include "RecoJets/JetProducers/interface/FastjetClusteringService.h"
 
 #include <fastjet/tools/Transformer.hh>
 
@@ -115,6 +116,9 @@ protected:
   double dRMax_;              /// for CMSBoostedTauSeedingAlgorithm : max dR
   int    maxDepth_;           /// for CMSBoostedTauSeedingAlgorithm : max depth for descending into clustering sequence
 
+  bool useClusteringService_; /// cluster with the FastjetClusteringService, shared with the modules of the same group
+  FastjetClusteringService::ClusteringID clusteringID_; /// clustering registered in the service
+
 
   // tokens for the data access
   edm::EDGetTokenT<edm::View<reco::RecoChargedRefCandidate> > input_chrefcand_token_;
@@ -272,14 +272,16 @@ void VirtualJetProducer::produce(edm::Event& iEvent,const edm::EventSetup& iSetu
   // NOTE!!! The fastjet random number sequence is a global singleton.
   // Thus, we have to create an object and get access to the global singleton
   // in order to change it. 
+  // The seeds are kept for the ghosts generated by the FastjetClusteringService.
+  fjSeeds_.clear();
   if ( useDeterministicSeed_ ) {
     fastjet::GhostedAreaSpec gas;
-    std::vector<int> seeds(2);
+    fjSeeds_.resize(2);
     unsigned int runNum_uint = static_cast <unsigned int> (iEvent.id().run());
     unsigned int evNum_uint = static_cast <unsigned int> (iEvent.id().event()); 
-    seeds[0] = std::max(runNum_uint,minSeed_ + 3) + 3 * evNum_uint;
-    seeds[1] = std::max(runNum_uint,minSeed_ + 5) + 5 * evNum_uint;
-    gas.set_random_status(seeds);
+    fjSeeds_[0] = std::max(runNum_uint,minSeed_ + 3) + 3 * evNum_uint;
+    fjSeeds_[1] = std::max(runNum_uint,minSeed_ + 5) + 5 * evNum_uint;
+    gas.set_random_status(fjSeeds_);
   }
 
   LogDebug("VirtualJetProducer") << "Entered produce\n";
@@ -219,6 +219,7 @@ protected:
 
   bool                            useDeterministicSeed_; // If desired, use a deterministic seed to fastjet
   unsigned int                    minSeed_;              // minimum seed to use, useful for MC generation
+  std::vector<int>                fjSeeds_;              // deterministic seeds of the event, empty if not used
 
   int                   verbosity_;                 // flag to enable/disable debug output
   bool                  fromHTTTopJetProducer_ = false;   // for running the v2.0 HEPTopTagger
@@ -0,0 +1,216 @@
+#include "RecoJets/JetProducers/interface/FastjetClusteringService.h"
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+#include "FWCore/ServiceRegistry/interface/StreamContext.h"
+#include "FWCore/ServiceRegistry/interface/SystemBounds.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "fastjet/ClusterSequenceActiveAreaExplicitGhosts.hh"
+
+#include "tbb/task_arena.h"
+#include "tbb/tbb.h"
+
+#include <algorithm>
+
+namespace {
+  bool sameInputs(const std::vector<fastjet::PseudoJet>& a, const std::vector<fastjet::PseudoJet>& b)
+  {
+    if ( a.size() != b.size() ) return false;
+    for ( unsigned int i = 0; i < a.size(); ++i ) {
+      if ( a[i].px() != b[i].px() || a[i].py() != b[i].py() || a[i].pz() != b[i].pz() ||
+	   a[i].E() != b[i].E() || a[i].user_index() != b[i].user_index() ) return false;
+    }
+    return true;
+  }
+}
+
+FastjetClusteringService::FastjetClusteringService(const edm::ParameterSet& iConfig, edm::ActivityRegistry& iRegistry) :
+  concurrent_(iConfig.getUntrackedParameter<bool>("concurrent"))
+{
+  iRegistry.watchPreallocate(this, &FastjetClusteringService::preallocate);
+  iRegistry.watchPostEvent(this, &FastjetClusteringService::postEvent);
+}
+
+void FastjetClusteringService::fillDescriptions(edm::ConfigurationDescriptions& descriptions)
+{
+  edm::ParameterSetDescription desc;
+  desc.addUntracked<bool>("concurrent", true)
+    ->setComment("run the clusterings of a group concurrently");
+  descriptions.add("FastjetClusteringService", desc);
+}
+
+FastjetClusteringService::ClusteringID
+FastjetClusteringService::registerClustering(const std::string& group,
+					     const std::string& moduleLabel,
+					     const fastjet::JetDefinition& jetDefinition,
+					     const fastjet::AreaDefinition* areaDefinition)
+{
+  if ( jetDefinition.jet_algorithm() == fastjet::plugin_algorithm )
+    throw cms::Exception("Configuration") << "FastjetClusteringService does not support plugin jet algorithms ("
+					  << jetDefinition.description() << ")\n";
+  if ( areaDefinition != nullptr && areaDefinition->area_type() != fastjet::active_area_explicit_ghosts )
+    throw cms::Exception("Configuration") << "FastjetClusteringService only supports areas with explicit ghosts ("
+					  << areaDefinition->description() << ")\n";
+
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  ClusteringID id;
+  for ( id.group = 0; id.group < groups_.size(); ++id.group ) {
+    if ( groups_[id.group].name == group ) break;
+  }
+  if ( id.group == groups_.size() ) {
+    groups_.emplace_back();
+    groups_.back().name = group;
+  }
+  Group& g = groups_[id.group];
+
+  int ghostSpec = -1;
+  if ( areaDefinition != nullptr ) {
+    const fastjet::GhostedAreaSpec& spec = areaDefinition->ghost_spec();
+    for ( ghostSpec = 0; ghostSpec < int(g.ghostSpecs.size()); ++ghostSpec ) {
+      if ( g.ghostSpecs[ghostSpec].description() == spec.description() ) break;
+    }
+    if ( ghostSpec == int(g.ghostSpecs.size()) ) g.ghostSpecs.push_back(spec);
+  }
+
+  for ( id.index = 0; id.index < g.clusterings.size(); ++id.index ) {
+    Clustering& c = g.clusterings[id.index];
+    if ( c.ghostSpec == ghostSpec && c.jetDefinition.description() == jetDefinition.description() ) {
+      if ( std::find(c.users.begin(), c.users.end(), moduleLabel) == c.users.end() ) c.users.push_back(moduleLabel);
+      return id;
+    }
+  }
+  g.clusterings.push_back(Clustering{ jetDefinition, ghostSpec, std::vector<std::string>(1, moduleLabel) });
+  return id;
+}
+
+FastjetClusteringService::ClusterSequencePtr
+FastjetClusteringService::cluster(edm::StreamID streamID,
+				  const edm::EventID& eventID,
+				  ClusteringID id,
+				  const std::vector<fastjet::PseudoJet>& inputs,
+				  const std::vector<int>& seeds)
+{
+  const Group& group = groups_[id.group];
+  Slot& slot = *slots_.at(streamID.value() * groups_.size() + id.group);
+  std::vector<unsigned int> all;
+  bool running = false;
+  {
+    std::lock_guard<std::mutex> guard(slot.mutex);
+    if ( slot.eventID != eventID ) {
+      // first module of the group in this event: it runs all the clusterings
+      slot.eventID = eventID;
+      slot.running = true;
+      slot.seeds = seeds;
+      slot.inputs = inputs;
+      slot.sequences.assign(group.clusterings.size(), ClusterSequencePtr());
+      slot.pending.resize(group.clusterings.size());
+      all.resize(group.clusterings.size());
+      for ( unsigned int i = 0; i < all.size(); ++i ) {
+	all[i] = i;
+	slot.pending[i] = group.clusterings[i].users.size();
+      }
+    } else {
+      running = slot.running;
+      const bool shared = !running && slot.sequences[id.index] && slot.seeds == seeds && sameInputs(slot.inputs, inputs);
+      ClusterSequencePtr sequence = take(slot, id.index);
+      if ( shared ) return sequence;
+    }
+  }
+
+  if ( !all.empty() ) {
+    // without the lock, the other modules of the group asking for their
+    // clustering in the meantime cluster for themselves
+    std::vector<ClusterSequencePtr> sequences = runClusterings(group, all, inputs, seeds);
+    std::lock_guard<std::mutex> guard(slot.mutex);
+    slot.running = false;
+    for ( unsigned int i = 0; i < sequences.size(); ++i ) {
+      if ( slot.pending[i] > 0 ) slot.sequences[i] = sequences[i];
+    }
+    take(slot, id.index);
+    return sequences[id.index];
+  }
+
+  if ( !running ) {
+    edm::LogWarning("FastjetClusteringService") << "The inputs of group " << group.name
+						<< " differ between its modules, clustering "
+						<< group.clusterings[id.index].jetDefinition.description()
+						<< " again";
+  }
+  return runClusterings(group, std::vector<unsigned int>(1, id.index), inputs, seeds)[id.index];
+}
+
+FastjetClusteringService::ClusterSequencePtr
+FastjetClusteringService::take(Slot& slot, unsigned int index) const
+{
+  ClusterSequencePtr sequence = slot.sequences[index];
+  if ( slot.pending[index] > 0 && --slot.pending[index] == 0 ) {
+    slot.sequences[index].reset();
+  }
+  if ( std::all_of(slot.pending.begin(), slot.pending.end(), [](unsigned int n) { return n == 0; }) ) {
+    decltype(slot.inputs)().swap(slot.inputs);
+  }
+  return sequence;
+}
+
+void FastjetClusteringService::preallocate(const edm::service::SystemBounds& bounds)
+{
+  slots_.resize(bounds.maxNumberOfStreams() * groups_.size());
+  for ( auto& slot : slots_ ) slot = std::make_unique<Slot>();
+}
+
+void FastjetClusteringService::postEvent(const edm::StreamContext& iContext)
+{
+  // the sequences of the modules which did not run in the event
+  for ( unsigned int group = 0; group < groups_.size(); ++group ) {
+    Slot& slot = *slots_[iContext.streamID().value() * groups_.size() + group];
+    std::lock_guard<std::mutex> guard(slot.mutex);
+    // the next event may have the same ID (e.g. merged samples)
+    slot.eventID = edm::EventID();
+    decltype(slot.sequences)().swap(slot.sequences);
+    decltype(slot.inputs)().swap(slot.inputs);
+    slot.pending.clear();
+  }
+}
+
+std::vector<FastjetClusteringService::ClusterSequencePtr>
+FastjetClusteringService::runClusterings(const Group& group,
+					 const std::vector<unsigned int>& indices,
+					 const std::vector<fastjet::PseudoJet>& inputs,
+					 const std::vector<int>& seeds) const
+{
+  // the ghosts are generated sequentially, the fastjet random generator
+  // being shared, each grid starting from the seeds as in the producers
+  std::vector<std::vector<fastjet::PseudoJet> > ghosts(group.ghostSpecs.size());
+  for ( unsigned int index : indices ) {
+    const int s = group.clusterings[index].ghostSpec;
+    if ( s < 0 || !ghosts[s].empty() ) continue;
+    fastjet::GhostedAreaSpec spec(group.ghostSpecs[s]);
+    if ( !seeds.empty() ) spec.set_random_status(seeds);
+    spec.add_ghosts(ghosts[s]);
+  }
+
+  std::vector<ClusterSequencePtr> sequences(group.clusterings.size());
+  auto runClustering = [&](unsigned int index) {
+    const Clustering& c = group.clusterings[index];
+    if ( c.ghostSpec < 0 ) {
+      sequences[index] = ClusterSequencePtr( new fastjet::ClusterSequence( inputs, c.jetDefinition ) );
+    } else {
+      sequences[index] = ClusterSequencePtr( new fastjet::ClusterSequenceActiveAreaExplicitGhosts( inputs, c.jetDefinition, ghosts[c.ghostSpec], group.ghostSpecs[c.ghostSpec].actual_ghost_area() ) );
+    }
+  };
+
+  if ( concurrent_ && indices.size() > 1 ) {
+    // isolated, the waiting thread only takes tasks of these clusterings
+    tbb::this_task_arena::isolate([&] {
+      tbb::parallel_for(size_t(0), indices.size(), [&](size_t i) { runClustering(indices[i]); });
+    });
+  } else {
+    for ( unsigned int index : indices ) runClustering(index);
+  }
+  return sequences;
+}
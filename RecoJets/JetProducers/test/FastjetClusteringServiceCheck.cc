@@ -0,0 +1,76 @@
+// -*- C++ -*-
+//
+// Package:    RecoJets/JetProducers
+// Class:      FastjetClusteringServiceCheck
+//
+/**\class FastjetClusteringServiceCheck FastjetClusteringServiceCheck.cc RecoJets/JetProducers/test/FastjetClusteringServiceCheck.cc
+
+ Description: compares the jets clustered with the FastjetClusteringService
+ with the jets clustered by the producers themselves, throws if they differ.
+ The momenta and constituents must be the same, and with compareAreas the
+ areas too: the ghosts of the service are those a producer generates from its
+ deterministic seeds, as long as no other module uses the global fastjet
+ random generator in between (i.e. with a single thread).
+
+*/
+
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include "DataFormats/JetReco/interface/GenJetCollection.h"
+
+#include <vector>
+
+class FastjetClusteringServiceCheck : public edm::global::EDAnalyzer<> {
+public:
+  explicit FastjetClusteringServiceCheck(const edm::ParameterSet& iConfig);
+
+  void analyze(edm::StreamID, const edm::Event& iEvent, const edm::EventSetup&) const override;
+
+private:
+  std::vector<edm::EDGetTokenT<reco::GenJetCollection> > sharedTokens_;
+  std::vector<edm::EDGetTokenT<reco::GenJetCollection> > referenceTokens_;
+  const bool compareAreas_;
+};
+
+FastjetClusteringServiceCheck::FastjetClusteringServiceCheck(const edm::ParameterSet& iConfig) :
+  compareAreas_(iConfig.getParameter<bool>("compareAreas"))
+{
+  for ( const auto& tag : iConfig.getParameter<std::vector<edm::InputTag> >("shared") )
+    sharedTokens_.push_back(consumes<reco::GenJetCollection>(tag));
+  for ( const auto& tag : iConfig.getParameter<std::vector<edm::InputTag> >("reference") )
+    referenceTokens_.push_back(consumes<reco::GenJetCollection>(tag));
+  if ( sharedTokens_.size() != referenceTokens_.size() )
+    throw cms::Exception("Configuration") << "one reference collection is needed for each shared collection\n";
+}
+
+void FastjetClusteringServiceCheck::analyze(edm::StreamID, const edm::Event& iEvent, const edm::EventSetup&) const
+{
+  for ( unsigned int c = 0; c < sharedTokens_.size(); ++c ) {
+    edm::Handle<reco::GenJetCollection> shared, reference;
+    iEvent.getByToken(sharedTokens_[c], shared);
+    iEvent.getByToken(referenceTokens_[c], reference);
+    if ( shared->size() != reference->size() )
+      throw cms::Exception("FastjetClusteringServiceCheck") << "event " << iEvent.id() << ": " << shared->size()
+							   << " shared jets and " << reference->size() << " reference jets\n";
+    for ( unsigned int i = 0; i < shared->size(); ++i ) {
+      const reco::GenJet& s = (*shared)[i];
+      const reco::GenJet& r = (*reference)[i];
+      bool same = s.p4() == r.p4() && s.numberOfDaughters() == r.numberOfDaughters() &&
+	( !compareAreas_ || s.jetArea() == r.jetArea() );
+      for ( unsigned int d = 0; same && d < s.numberOfDaughters(); ++d )
+	same = s.daughterPtr(d) == r.daughterPtr(d);
+      if ( !same )
+	throw cms::Exception("FastjetClusteringServiceCheck") << "event " << iEvent.id() << ", jet " << i
+							     << ": shared pt " << s.pt() << " eta " << s.eta() << " phi " << s.phi()
+							     << " area " << s.jetArea() << ", reference pt " << r.pt()
+							     << " eta " << r.eta() << " phi " << r.phi() << " area " << r.jetArea() << "\n";
+    }
+  }
+}
+
+DEFINE_FWK_MODULE(FastjetClusteringServiceCheck);
@@ -0,0 +1,88 @@
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+# Jets clustered with the FastjetClusteringService, on 2 streams, compared
+# with the same jets clustered by the producers themselves. With one thread
+# the areas must be the same too, with more threads the modules of the other
+# stream can use the global fastjet random generator while the ghosts of a
+# module are generated.
+
+options = VarParsing()
+options.register("nThreads", 1, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "number of threads, the areas are compared with a single one")
+options.parseArguments()
+
+process = cms.Process("TEST")
+
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.load("SimGeneral.HepPDTESSource.pythiapdt_cfi")
+
+process.source = cms.Source("EmptySource")
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(20))
+
+process.options = cms.untracked.PSet(numberOfThreads = cms.untracked.uint32(options.nThreads),
+                                     numberOfStreams = cms.untracked.uint32(2))
+
+process.RandomNumberGeneratorService = cms.Service("RandomNumberGeneratorService",
+    generator = cms.PSet(initialSeed = cms.untracked.uint32(12345))
+)
+process.FastjetClusteringService = cms.Service("FastjetClusteringService")
+
+process.generator = cms.EDProducer("FlatRandomPtGunProducer",
+    PGunParameters = cms.PSet(
+        PartID = cms.vint32([211, -211, 22, 130, 321]*20),
+        MinPt = cms.double(1.),
+        MaxPt = cms.double(50.),
+        MinEta = cms.double(-4.),
+        MaxEta = cms.double(4.),
+        MinPhi = cms.double(-3.14159265359),
+        MaxPhi = cms.double(3.14159265359)
+    ),
+    Verbosity = cms.untracked.int32(0),
+    psethack = cms.string('jets for the clustering service test'),
+    AddAntiParticle = cms.bool(False),
+    firstRun = cms.untracked.uint32(1)
+)
+
+from PhysicsTools.HepMCCandAlgos.genParticles_cfi import genParticles
+process.genParticles = genParticles.clone(src = "generator:unsmeared")
+
+from RecoJets.JetProducers.ak4GenJets_cfi import ak4GenJets
+process.ak4GenJets = ak4GenJets.clone(
+    src = "genParticles",
+    doAreaFastjet = True,
+    useExplicitGhosts = cms.bool(True),
+    # the ghosts of the event are the same for the shared and reference jets
+    useDeterministicSeed = True
+)
+process.ak8GenJets = process.ak4GenJets.clone(rParam = 0.8)
+
+# ak4 twice in the group, the same clustering with two users
+process.ak4GenJetsShared = process.ak4GenJets.clone(clusteringGroup = cms.string("genJets"))
+process.ak4GenJetsSharedCopy = process.ak4GenJetsShared.clone()
+process.ak8GenJetsShared = process.ak8GenJets.clone(clusteringGroup = cms.string("genJets"))
+# a user of the group running only in the even events
+process.kt4GenJets = process.ak4GenJets.clone(jetAlgorithm = "Kt")
+process.kt4GenJetsShared = process.kt4GenJets.clone(clusteringGroup = cms.string("genJets"))
+
+process.check = cms.EDAnalyzer("FastjetClusteringServiceCheck",
+    shared = cms.VInputTag("ak4GenJetsShared", "ak4GenJetsSharedCopy", "ak8GenJetsShared"),
+    reference = cms.VInputTag("ak4GenJets", "ak4GenJets", "ak8GenJets"),
+    compareAreas = cms.bool(options.nThreads == 1)
+)
+process.checkEven = process.check.clone(
+    shared = ["kt4GenJetsShared"],
+    reference = ["kt4GenJets"]
+)
+
+process.evenEvents = cms.EDFilter("ModuloEventIDFilter",
+    modulo = cms.uint32(2),
+    offset = cms.uint32(0)
+)
+
+process.p = cms.Path(process.generator * process.genParticles *
+                     process.ak4GenJets * process.ak8GenJets *
+                     process.ak4GenJetsShared * process.ak4GenJetsSharedCopy * process.ak8GenJetsShared *
+                     process.check)
+process.pEven = cms.Path(process.generator * process.genParticles * process.evenEvents *
+                         process.kt4GenJets * process.kt4GenJetsShared * process.checkEven)
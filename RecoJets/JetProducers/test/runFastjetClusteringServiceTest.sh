@@ -0,0 +1,11 @@
+#!/bin/sh
+
+function die { echo $1: status $2; exit $2; }
+
+pushd ${LOCAL_TMP_DIR}
+
+echo FastjetClusteringService
+cmsRun ${LOCAL_TEST_DIR}/fastjetClusteringService_cfg.py || die 'failed running cmsRun fastjetClusteringService_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/fastjetClusteringService_cfg.py nThreads=4 || die 'failed running cmsRun fastjetClusteringService_cfg.py nThreads=4' $?
+
+popd
@@ -13,6 +13,7 @@
 #include "CondFormats/EcalObjects/interface/EcalPedestals.h"
 #include "CondFormats/EcalObjects/interface/EcalGainRatios.h"
 #include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLS.h"
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
 
 
 #include "TMatrixDSym.h"
@@ -25,7 +26,13 @@ class EcalUncalibRecHitMultiFitAlgo
   
   EcalUncalibRecHitMultiFitAlgo();
   ~EcalUncalibRecHitMultiFitAlgo() { };
-  EcalUncalibratedRecHit makeRecHit(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const BXVector &activeBX);
+  /// prefitIndex: index of the crystal in the prefit batch, -1 if not there
+  EcalUncalibratedRecHit makeRecHit(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const BXVector &activeBX, int prefitIndex=-1);
+  /// the one-pulse prefit of the crystals without gain switch can be done for many of them at once:
+  /// add them with addToPrefitBatch (returns the index to pass to makeRecHit, or -1), then call runPrefitBatch
+  int addToPrefitBatch(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov);
+  void clearPrefitBatch(unsigned int nexpected=0) { _prefitBatch.clear(); _prefitBatch.reserve(nexpected); }
+  void runPrefitBatch() { _prefitBatch.fit(); }
   void disableErrorCalculation() { _computeErrors = false; }
   void setDoPrefit(bool b) { _doPrefit = b; }
   void setPrefitMaxChiSq(double x) { _prefitMaxChiSq = x; }
@@ -37,7 +44,11 @@ class EcalUncalibRecHitMultiFitAlgo
   void setGainSwitchUseMaxSample(bool b) { _gainSwitchUseMaxSample = b; }
   
  private:
+   void fillAmplitudes(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, bool dynamicPedestal, SampleVector &amplitudes, SampleGainVector &gainsNoise, SampleGainVector &gainsPedestal, double &maxamplitude, double &pedval) const;
+   void fillNoiseCovariance(const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, bool hasGainSwitch, bool dynamicPedestal, const SampleGainVector &gainsNoise, SampleMatrix &noisecov) const;
+
    PulseChiSqSNNLS _pulsefunc;
+   PulseChiSqSNNLSBatch _prefitBatch;
    PulseChiSqSNNLS _pulsefuncSingle;
    bool _computeErrors;
    bool _doPrefit;
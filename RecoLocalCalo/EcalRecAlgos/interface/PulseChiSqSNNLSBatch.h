@@ -0,0 +1,54 @@
+#ifndef RecoLocalCalo_EcalRecAlgos_PulseChiSqSNNLSBatch_h
+#define RecoLocalCalo_EcalRecAlgos_PulseChiSqSNNLSBatch_h
+
+/** \class PulseChiSqSNNLSBatch
+  *  One-pulse (in-time only, static pedestal) fit of many crystals at once.
+  *  Same result as PulseChiSqSNNLS::DoFit with a single bx at 0 and one iteration
+  *  (the multifit "prefit"), but the crystals are stored in SoA blocks of
+  *  `lanes` crystals and the Cholesky decomposition of the 10x10 covariance,
+  *  the forward substitutions and the amplitude are computed lane-wise,
+  *  so that the loops vectorize across crystals.
+  */
+
+#include "RecoLocalCalo/EcalRecAlgos/interface/EigenMatrixTypes.h"
+
+#include <vector>
+
+class PulseChiSqSNNLSBatch {
+  public:
+
+    static constexpr unsigned int lanes = 8;
+
+    void clear() { _n=0; _data.clear(); _amp.clear(); _chisq.clear(); }
+    void reserve(unsigned int n);
+
+    /// add one crystal, returns its index in the batch
+    unsigned int add(const SampleVector &samples, const SampleMatrix &samplecov, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov);
+
+    /// fit all the crystals added so far
+    void fit();
+
+    unsigned int size() const { return _n; }
+    double amplitude(unsigned int i) const { return _amp[i]; }
+    double chiSq(unsigned int i) const { return _chisq[i]; }
+
+  private:
+
+    static constexpr unsigned int nsample = SampleVector::RowsAtCompileTime;
+    static constexpr unsigned int ncov = nsample*(nsample+1)/2;
+    // per crystal: lower triangle of the covariance, samples, pulse
+    static constexpr unsigned int blockSize = (ncov+2*nsample)*lanes;
+
+    static constexpr unsigned int icov(unsigned int i, unsigned int j) { return i*(i+1)/2+j; }
+
+    double * block(unsigned int ib) { return _data.data()+ib*blockSize; }
+
+    void fitBlock(double * b, double * amp, double * chisq) const;
+
+    unsigned int _n=0;
+    std::vector<double> _data;
+    std::vector<double> _amp;
+    std::vector<double> _chisq;
+};
+
+#endif
@@ -25,29 +25,12 @@ EcalUncalibRecHitMultiFitAlgo::EcalUncalibRecHitMultiFitAlgo() :
     
 }
 
-/// compute rechits
-EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const BXVector &activeBX) {
+/// pedestal subtracted samples, in units of gain 12
+void EcalUncalibRecHitMultiFitAlgo::fillAmplitudes(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, bool dynamicPedestal, SampleVector &amplitudes, SampleGainVector &gainsNoise, SampleGainVector &gainsPedestal, double &maxamplitude, double &pedval) const {
 
-  uint32_t flags = 0;
-  
   const unsigned int nsample = EcalDataFrame::MAXSAMPLES;
-  
-  double maxamplitude = -std::numeric_limits<double>::max();
   const unsigned int iSampleMax = 5;
-  const unsigned int iFullPulseMax = 9;
-  
-  double pedval = 0.;
-    
-  SampleVector amplitudes;
-  SampleGainVector gainsNoise;
-  SampleGainVector gainsPedestal;
-  SampleGainVector badSamples = SampleGainVector::Zero();
-  bool hasSaturation = dataFrame.isSaturated();
-  bool hasGainSwitch = hasSaturation || dataFrame.hasSwitchToGain6() || dataFrame.hasSwitchToGain1();
-  
-  //no dynamic pedestal in case of gain switch, since then the fit becomes too underconstrained
-  bool dynamicPedestal = _dynamicPedestals && !hasGainSwitch;
-  
+
   for(unsigned int iSample = 0; iSample < nsample; iSample++) {
         
     const EcalMGPASample &sample = dataFrame.sample(iSample);
@@ -104,35 +87,13 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
         
   }
 
-  double amplitude, amperr, chisq;
-  bool status = false;
-    
-  //special handling for gain switch, where sample before maximum is potentially affected by slew rate limitation
-  //optionally apply a stricter criteria, assuming slew rate limit is only reached in case where maximum sample has gain switched but previous sample has not
-  //option 1: use simple max-sample algorithm
-  if (hasGainSwitch && _gainSwitchUseMaxSample) {
-    double maxpulseamplitude = maxamplitude / fullpulse[iFullPulseMax];
-    EcalUncalibratedRecHit rh( dataFrame.id(), maxpulseamplitude, pedval, 0., 0., flags );
-    rh.setAmplitudeError(0.);
-    for (unsigned int ipulse=0; ipulse<_pulsefunc.BXs().rows(); ++ipulse) {
-      int bx = _pulsefunc.BXs().coeff(ipulse);
-      if (bx!=0) {
-        rh.setOutOfTimeAmplitude(bx+5, 0.0);
-      }
-    }
-    return rh;
-  }
+}
+
+/// noise covariance matrix, which depends on the sample gains
+void EcalUncalibRecHitMultiFitAlgo::fillNoiseCovariance(const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, bool hasGainSwitch, bool dynamicPedestal, const SampleGainVector &gainsNoise, SampleMatrix &noisecov) const {
+
+  const unsigned int iSampleMax = 5;
 
-  //option2: A floating negative single-sample offset is added to the fit
-  //such that the affected sample is treated only as a lower limit for the true amplitude
-  bool mitigateBadSample = _mitigateBadSamples && hasGainSwitch && iSampleMax>0;
-  mitigateBadSample &= (!_selectiveBadSampleCriteria || (gainsNoise.coeff(iSampleMax-1)!=gainsNoise.coeff(iSampleMax)) );
-  if (mitigateBadSample) {
-    badSamples[iSampleMax-1] = 1;
-  }
-  
-  //compute noise covariance matrix, which depends on the sample gains
-  SampleMatrix noisecov;
   if (hasGainSwitch) {
     std::array<double,3> pedrmss = {{aped->rms_x12, aped->rms_x6, aped->rms_x1}};
     std::array<double,3> gainratios = {{ 1., aGain->gain12Over6(), aGain->gain6Over1()*aGain->gain12Over6()}};
@@ -168,10 +129,92 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
       noisecov += _addPedestalUncertainty*_addPedestalUncertainty*SampleMatrix::Ones();
     }
   }
+
+}
+
+/// one-pulse prefit of the crystals without gain switch, done for all of them at once
+int EcalUncalibRecHitMultiFitAlgo::addToPrefitBatch(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov) {
+
+  //dynamic pedestals and gain switch (bad sample mitigation) add parameters to the fit
+  if (!_doPrefit || _dynamicPedestals) return -1;
+  if (dataFrame.isSaturated() || dataFrame.hasSwitchToGain6() || dataFrame.hasSwitchToGain1()) return -1;
+
+  SampleVector amplitudes;
+  SampleGainVector gainsNoise;
+  SampleGainVector gainsPedestal;
+  double maxamplitude, pedval;
+  fillAmplitudes(dataFrame, aped, aGain, false, amplitudes, gainsNoise, gainsPedestal, maxamplitude, pedval);
+
+  SampleMatrix noisecov;
+  fillNoiseCovariance(aped, aGain, noisecors, false, false, gainsNoise, noisecov);
+
+  return _prefitBatch.add(amplitudes, noisecov, fullpulse, fullpulsecov);
+}
+
+/// compute rechits
+EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const BXVector &activeBX, int prefitIndex) {
+
+  uint32_t flags = 0;
+  
+  double maxamplitude = -std::numeric_limits<double>::max();
+  const unsigned int iSampleMax = 5;
+  const unsigned int iFullPulseMax = 9;
+  
+  double pedval = 0.;
+    
+  SampleVector amplitudes;
+  SampleGainVector gainsNoise;
+  SampleGainVector gainsPedestal;
+  SampleGainVector badSamples = SampleGainVector::Zero();
+  bool hasSaturation = dataFrame.isSaturated();
+  bool hasGainSwitch = hasSaturation || dataFrame.hasSwitchToGain6() || dataFrame.hasSwitchToGain1();
+  
+  //no dynamic pedestal in case of gain switch, since then the fit becomes too underconstrained
+  bool dynamicPedestal = _dynamicPedestals && !hasGainSwitch;
+  
+  fillAmplitudes(dataFrame, aped, aGain, dynamicPedestal, amplitudes, gainsNoise, gainsPedestal, maxamplitude, pedval);
+
+  double amplitude, amperr, chisq;
+  bool status = false;
+
+  //one-pulse prefit already done in the batch (see addToPrefitBatch)
+  if (_doPrefit && prefitIndex>=0 && _prefitBatch.chiSq(prefitIndex) < _prefitMaxChiSq) {
+    EcalUncalibratedRecHit rh( dataFrame.id(), _prefitBatch.amplitude(prefitIndex), pedval, 0., _prefitBatch.chiSq(prefitIndex), flags );
+    rh.setAmplitudeError(0.);
+    return rh;
+  }
+    
+  //special handling for gain switch, where sample before maximum is potentially affected by slew rate limitation
+  //optionally apply a stricter criteria, assuming slew rate limit is only reached in case where maximum sample has gain switched but previous sample has not
+  //option 1: use simple max-sample algorithm
+  if (hasGainSwitch && _gainSwitchUseMaxSample) {
+    double maxpulseamplitude = maxamplitude / fullpulse[iFullPulseMax];
+    EcalUncalibratedRecHit rh( dataFrame.id(), maxpulseamplitude, pedval, 0., 0., flags );
+    rh.setAmplitudeError(0.);
+    for (unsigned int ipulse=0; ipulse<_pulsefunc.BXs().rows(); ++ipulse) {
+      int bx = _pulsefunc.BXs().coeff(ipulse);
+      if (bx!=0) {
+        rh.setOutOfTimeAmplitude(bx+5, 0.0);
+      }
+    }
+    return rh;
+  }
+
+  //option2: A floating negative single-sample offset is added to the fit
+  //such that the affected sample is treated only as a lower limit for the true amplitude
+  bool mitigateBadSample = _mitigateBadSamples && hasGainSwitch && iSampleMax>0;
+  mitigateBadSample &= (!_selectiveBadSampleCriteria || (gainsNoise.coeff(iSampleMax-1)!=gainsNoise.coeff(iSampleMax)) );
+  if (mitigateBadSample) {
+    badSamples[iSampleMax-1] = 1;
+  }
+  
+  //compute noise covariance matrix, which depends on the sample gains
+  SampleMatrix noisecov;
+  fillNoiseCovariance(aped, aGain, noisecors, hasGainSwitch, dynamicPedestal, gainsNoise, noisecov);
   
   //optimized one-pulse fit for hlt
   bool usePrefit = false;
-  if (_doPrefit) {
+  if (_doPrefit && prefitIndex<0) {
     status = _pulsefuncSingle.DoFit(amplitudes,noisecov,_singlebx,fullpulse,fullpulsecov,gainsPedestal,badSamples);
     amplitude = status ? _pulsefuncSingle.X()[0] : 0.;
     amperr = status ? _pulsefuncSingle.Errors()[0] : 0.;
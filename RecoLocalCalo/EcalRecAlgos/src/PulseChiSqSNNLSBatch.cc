@@ -0,0 +1,112 @@
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
+
+#include <algorithm>
+#include <cmath>
+
+void PulseChiSqSNNLSBatch::reserve(unsigned int n) {
+  auto nblocks = (n+lanes-1)/lanes;
+  _data.reserve(nblocks*blockSize);
+  _amp.reserve(nblocks*lanes);
+  _chisq.reserve(nblocks*lanes);
+}
+
+unsigned int PulseChiSqSNNLSBatch::add(const SampleVector &samples, const SampleMatrix &samplecov, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov) {
+
+  auto i = _n++;
+  auto lane = i%lanes;
+  if (lane==0) {
+    // new block: unused lanes get a unit covariance and no signal
+    _data.resize(_data.size()+blockSize,0.);
+    auto b = block(i/lanes);
+    for (unsigned int j=0; j<nsample; ++j)
+      for (unsigned int l=0; l<lanes; ++l) b[icov(j,j)*lanes+l] = 1.;
+  }
+  auto b = block(i/lanes);
+  auto cov = b;
+  auto s = b+ncov*lanes;
+  auto p = s+nsample*lanes;
+
+  // as in PulseChiSqSNNLS::updateCov for the in-time pulse, with the initial amplitude
+  // set to the sample at the maximum (bx=0: first sample 3, template offset 4)
+  const double amp = samples.coeff(5);
+  const double ampsq = amp*amp;
+  for (unsigned int r=0; r<nsample; ++r) {
+    for (unsigned int c=0; c<=r; ++c) {
+      double v = samplecov.coeff(r,c);
+      if (amp!=0. && c>=3) v += ampsq*fullpulsecov.coeff(r+4,c+4);
+      cov[icov(r,c)*lanes+lane] = v;
+    }
+    s[r*lanes+lane] = samples.coeff(r);
+    p[r*lanes+lane] = fullpulse.coeff(r+4);
+  }
+  return i;
+}
+
+void PulseChiSqSNNLSBatch::fit() {
+  auto nblocks = (_n+lanes-1)/lanes;
+  _amp.resize(nblocks*lanes);
+  _chisq.resize(nblocks*lanes);
+  for (unsigned int ib=0; ib<nblocks; ++ib)
+    fitBlock(block(ib), _amp.data()+ib*lanes, _chisq.data()+ib*lanes);
+}
+
+void PulseChiSqSNNLSBatch::fitBlock(double * b, double * amp, double * chisq) const {
+
+  auto L = b;
+  auto s = b+ncov*lanes;
+  auto p = s+nsample*lanes;
+
+  // Cholesky decomposition in place (lower triangle)
+  for (unsigned int j=0; j<nsample; ++j) {
+    double * Ljj = L+icov(j,j)*lanes;
+    for (unsigned int k=0; k<j; ++k) {
+      const double * Ljk = L+icov(j,k)*lanes;
+      for (unsigned int l=0; l<lanes; ++l) Ljj[l] -= Ljk[l]*Ljk[l];
+    }
+    double inv[lanes];
+    for (unsigned int l=0; l<lanes; ++l) { Ljj[l] = std::sqrt(Ljj[l]); inv[l] = 1./Ljj[l]; }
+    for (unsigned int i=j+1; i<nsample; ++i) {
+      double * Lij = L+icov(i,j)*lanes;
+      for (unsigned int k=0; k<j; ++k) {
+        const double * Lik = L+icov(i,k)*lanes;
+        const double * Ljk = L+icov(j,k)*lanes;
+        for (unsigned int l=0; l<lanes; ++l) Lij[l] -= Lik[l]*Ljk[l];
+      }
+      for (unsigned int l=0; l<lanes; ++l) Lij[l] *= inv[l];
+    }
+  }
+
+  // forward substitution of pulse and samples (in place)
+  for (unsigned int i=0; i<nsample; ++i) {
+    double * si = s+i*lanes;
+    double * pi = p+i*lanes;
+    for (unsigned int k=0; k<i; ++k) {
+      const double * Lik = L+icov(i,k)*lanes;
+      const double * sk = s+k*lanes;
+      const double * pk = p+k*lanes;
+      for (unsigned int l=0; l<lanes; ++l) { si[l] -= Lik[l]*sk[l]; pi[l] -= Lik[l]*pk[l]; }
+    }
+    const double * Lii = L+icov(i,i)*lanes;
+    for (unsigned int l=0; l<lanes; ++l) { si[l] /= Lii[l]; pi[l] /= Lii[l]; }
+  }
+
+  // amplitude (as in PulseChiSqSNNLS::OnePulseMinimize) and chi2
+  double aTa[lanes], aTb[lanes];
+  for (unsigned int l=0; l<lanes; ++l) { aTa[l]=0.; aTb[l]=0.; }
+  for (unsigned int i=0; i<nsample; ++i)
+    for (unsigned int l=0; l<lanes; ++l) {
+      aTa[l] += p[i*lanes+l]*p[i*lanes+l];
+      aTb[l] += p[i*lanes+l]*s[i*lanes+l];
+    }
+  // a lane without pulse (no active sample, or an unused lane) keeps a zero
+  // amplitude, as in the NNLS where the pulse is never released from the bound
+  for (unsigned int l=0; l<lanes; ++l) {
+    amp[l] = aTa[l]>0. ? std::max(0.,aTb[l]/aTa[l]) : 0.;
+    chisq[l] = 0.;
+  }
+  for (unsigned int i=0; i<nsample; ++i)
+    for (unsigned int l=0; l<lanes; ++l) {
+      auto r = amp[l]*p[i*lanes+l] - s[i*lanes+l];
+      chisq[l] += r*r;
+    }
+}
@@ -0,0 +1,108 @@
+/* Unit test for PulseChiSqSNNLSBatch: the batched one-pulse fit must give
+   the same amplitude and chi2 as the one-pulse PulseChiSqSNNLS fit
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLS.h"
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
+
+#include <cmath>
+#include <vector>
+
+class testPulseChiSqSNNLSBatch: public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(testPulseChiSqSNNLSBatch);
+  CPPUNIT_TEST(testAgainstScalar);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown(){}
+
+  void testAgainstScalar();
+
+private:
+  void addCrystal(const SampleVector &samples, const FullSampleVector &pulse);
+
+  SampleMatrix noisecov_;
+  FullSampleMatrix pulsecov_;
+  FullSampleVector pulse_;
+
+  std::vector<SampleVector> samples_;
+  std::vector<FullSampleVector> pulses_;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testPulseChiSqSNNLSBatch);
+
+void testPulseChiSqSNNLSBatch::setUp(){
+
+  // correlated noise, 1 ADC count
+  for (int i=0; i<SampleVectorSize; ++i)
+    for (int j=0; j<SampleVectorSize; ++j)
+      noisecov_(i,j) = std::exp(-std::abs(i-j)/3.);
+
+  // alpha-beta pulse with its maximum at sample 5 of the in-time window
+  pulse_ = FullSampleVector::Zero();
+  const double alpha = 1.2, beta = 1.7, tmax = 9.;
+  for (int i=0; i<FullSampleVectorSize; ++i) {
+    double dt = i-tmax;
+    if (dt > -alpha*beta) pulse_(i) = std::pow(1.+dt/(alpha*beta),alpha)*std::exp(-dt/beta);
+  }
+  for (int i=0; i<FullSampleVectorSize; ++i)
+    for (int j=0; j<FullSampleVectorSize; ++j)
+      pulsecov_(i,j) = 1e-5*pulse_(i)*pulse_(j) + (i==j ? 1e-6 : 0.);
+}
+
+void testPulseChiSqSNNLSBatch::addCrystal(const SampleVector &samples, const FullSampleVector &pulse) {
+  samples_.push_back(samples);
+  pulses_.push_back(pulse);
+}
+
+void testPulseChiSqSNNLSBatch::testAgainstScalar(){
+
+  // signals of various amplitudes with a small distortion
+  for (int k=0; k<12; ++k) {
+    double amp = k*k*3.7;
+    SampleVector s;
+    for (int i=0; i<SampleVectorSize; ++i) s(i) = amp*pulse_(i+4) + std::sin(1.3*i+k);
+    addCrystal(s, pulse_);
+  }
+  // negative signal: the amplitude is bound at zero
+  addCrystal(-50.*pulse_.segment<SampleVectorSize>(4), pulse_);
+  // no active sample: the pulse is empty in the window
+  addCrystal(SampleVector::Constant(2.), FullSampleVector::Zero());
+  // saturated: flat top at the ADC range
+  SampleVector sat;
+  for (int i=0; i<SampleVectorSize; ++i) sat(i) = std::min(4095., 8000.*pulse_(i+4));
+  addCrystal(sat, pulse_);
+
+  // the last block is only partly filled
+  CPPUNIT_ASSERT(samples_.size()%PulseChiSqSNNLSBatch::lanes != 0);
+
+  PulseChiSqSNNLSBatch batch;
+  batch.reserve(samples_.size());
+  for (unsigned int i=0; i<samples_.size(); ++i)
+    CPPUNIT_ASSERT(batch.add(samples_[i], noisecov_, pulses_[i], pulsecov_) == i);
+  batch.fit();
+  CPPUNIT_ASSERT(batch.size() == samples_.size());
+
+  BXVector bxs(1);
+  bxs << 0;
+  for (unsigned int i=0; i<samples_.size(); ++i) {
+    PulseChiSqSNNLS scalar;
+    scalar.disableErrorCalculation();
+    scalar.setMaxIters(1);
+    scalar.setMaxIterWarnings(false);
+    CPPUNIT_ASSERT(scalar.DoFit(samples_[i], noisecov_, bxs, pulses_[i], pulsecov_));
+
+    const double amp = scalar.X()[0], chisq = scalar.ChiSq();
+    CPPUNIT_ASSERT(std::isfinite(batch.amplitude(i)));
+    CPPUNIT_ASSERT(std::isfinite(batch.chiSq(i)));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(amp, batch.amplitude(i), 1e-9*(1.+std::abs(amp)));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(chisq, batch.chiSq(i), 1e-9*(1.+chisq));
+  }
+  // empty lane and negative signal
+  CPPUNIT_ASSERT(batch.amplitude(12) == 0.);
+  CPPUNIT_ASSERT(batch.amplitude(13) == 0.);
+}
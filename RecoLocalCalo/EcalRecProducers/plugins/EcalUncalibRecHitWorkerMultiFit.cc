@@ -284,8 +284,38 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
     FullSampleVector fullpulse(FullSampleVector::Zero());
     FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
 
+    auto fillPulse = [&](const EcalPulseShapes::Item * aPulse, const EcalPulseCovariances::Item * aPulseCov) {
+        for (int i=0; i<EcalPulseShape::TEMPLATESAMPLES; ++i)
+            fullpulse(i+7) = aPulse->pdfval[i];
+    
+        for(int i=0; i<EcalPulseShape::TEMPLATESAMPLES;i++)
+        for(int j=0; j<EcalPulseShape::TEMPLATESAMPLES;j++)
+            fullpulsecov(i+7,j+7) = aPulseCov->covval[i][j];
+    };
+
+    // the one-pulse prefit is done first for all the crystals at once
+    std::vector<int> prefitIndex(digis.size(),-1);
+    if (barrel ? doPrefitEB_ : doPrefitEE_) {
+        multiFitMethod_.clearPrefitBatch(digis.size());
+        unsigned int idg = 0;
+        for (auto itdg = digis.begin(); itdg != digis.end(); ++itdg, ++idg) {
+            DetId detid(itdg->id());
+            if (barrel) {
+                unsigned int hashedIndex = EBDetId(detid).hashedIndex();
+                fillPulse(&pulseshapes->barrel(hashedIndex), &pulsecovariances->barrel(hashedIndex));
+                prefitIndex[idg] = multiFitMethod_.addToPrefitBatch(*itdg, &peds->barrel(hashedIndex), &gains->barrel(hashedIndex), noisecor(barrel), fullpulse, fullpulsecov);
+            } else {
+                unsigned int hashedIndex = EEDetId(detid).hashedIndex();
+                fillPulse(&pulseshapes->endcap(hashedIndex), &pulsecovariances->endcap(hashedIndex));
+                prefitIndex[idg] = multiFitMethod_.addToPrefitBatch(*itdg, &peds->endcap(hashedIndex), &gains->endcap(hashedIndex), noisecor(barrel), fullpulse, fullpulsecov);
+            }
+        }
+        multiFitMethod_.runPrefitBatch();
+    }
+
     result.reserve(result.size() + digis.size());
-    for (auto itdg = digis.begin(); itdg != digis.end(); ++itdg)
+    unsigned int idg = 0;
+    for (auto itdg = digis.begin(); itdg != digis.end(); ++itdg, ++idg)
     {
         DetId detid(itdg->id());
 
@@ -322,12 +352,7 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
         double pedRMSVec[3]  = { aped->rms_x12,  aped->rms_x6,  aped->rms_x1 };
         double gainRatios[3] = { 1., aGain->gain12Over6(), aGain->gain6Over1()*aGain->gain12Over6()};
 
-        for (int i=0; i<EcalPulseShape::TEMPLATESAMPLES; ++i)
-            fullpulse(i+7) = aPulse->pdfval[i];
-    
-        for(int i=0; i<EcalPulseShape::TEMPLATESAMPLES;i++)
-        for(int j=0; j<EcalPulseShape::TEMPLATESAMPLES;j++)
-            fullpulsecov(i+7,j+7) = aPulseCov->covval[i][j];
+        fillPulse(aPulse, aPulseCov);
         
 	// compute the right bin of the pulse shape using time calibration constants
 	EcalTimeCalibConstantMap::const_iterator it = itime->find( detid );
@@ -371,7 +396,7 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
             // multifit
             const SampleMatrixGainArray &noisecors = noisecor(barrel);
             
-            result.push_back(multiFitMethod_.makeRecHit(*itdg, aped, aGain, noisecors, fullpulse, fullpulsecov, activeBX));
+            result.push_back(multiFitMethod_.makeRecHit(*itdg, aped, aGain, noisecors, fullpulse, fullpulsecov, activeBX, prefitIndex[idg]));
             auto & uncalibRecHit = result.back();
             
             // === time computation ===
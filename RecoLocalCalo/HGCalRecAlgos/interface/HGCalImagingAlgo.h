@@ -15,6 +15,7 @@
 #include "DataFormats/EgammaReco/interface/BasicCluster.h"
 
 #include "RecoLocalCalo/HGCalRecAlgos/interface/RecHitTools.h"
+#include "RecoLocalCalo/HGCalRecAlgos/interface/HGCalLayerTiles.h"
 
 // C/C++ headers
 #include <string>
@@ -161,6 +162,8 @@ static const unsigned int maxlayer = 52;
 
 
 private:
+friend class testHGCalImagingAlgo; // compares the nearest-higher search with the plain scan
+
 // last layer per subdetector
 static const unsigned int lastLayerEE = 28;
 static const unsigned int lastLayerFH = 40;
@@ -250,7 +253,6 @@ struct Hexel {
 
 };
 
-typedef KDTreeLinkerAlgo<Hexel,2> KDTree;
 typedef KDTreeNodeInfoT<Hexel,2> KDNode;
 
 
@@ -282,9 +284,11 @@ inline double distance2(const Hexel &pt1, const Hexel &pt2) const{   //distance
 inline double distance(const Hexel &pt1, const Hexel &pt2) const{   //2-d distance on the layer (x-y)
         return std::sqrt(distance2(pt1,pt2));
 }
-double calculateLocalDensity(std::vector<KDNode> &, KDTree &, const unsigned int) const;   //return max density
-double calculateDistanceToHigher(std::vector<KDNode> &) const;
-int findAndAssignClusters(std::vector<KDNode> &, KDTree &, double, KDTreeBox &, const unsigned int, std::vector<std::vector<KDNode> >&) const;
+float criticalDistance(const unsigned int) const;   //delta_c of the layer
+double calculateLocalDensity(std::vector<KDNode> &, const HGCalLayerTiles &, const unsigned int) const;   //return max density
+// the hits are passed with their indices sorted by decreasing density
+double calculateDistanceToHigher(std::vector<KDNode> &, const HGCalLayerTiles &, const std::vector<size_t> &) const;
+int findAndAssignClusters(std::vector<KDNode> &, const HGCalLayerTiles &, double, const unsigned int, const std::vector<size_t> &, std::vector<std::vector<KDNode> >&) const;
 math::XYZPoint calculatePosition(std::vector<KDNode> &) const;
 
 // attempt to find subclusters within a given set of hexels
@@ -0,0 +1,87 @@
+#ifndef RecoLocalCalo_HGCalRecAlgos_HGCalLayerTiles_h
+#define RecoLocalCalo_HGCalRecAlgos_HGCalLayerTiles_h
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Fixed 2D grid of square tiles covering the hits of one layer, used instead
+// of a KD tree for the fixed-radius searches of the imaging algorithm.
+// With tiles at least as large as the search radius, all the hits within the
+// radius of a point are in the 3x3 tiles around the tile of the point.
+// The hit indices are stored tile by tile in a single array (the offset of
+// each tile is kept), so that filling is two linear passes and the hits of a
+// tile are contiguous.
+class HGCalLayerTiles {
+public:
+  // maximum number of tiles along x and y, larger tiles are used beyond
+  static const int maxTilesPerAxis = 256;
+
+  // fills the grid covering [xmin,xmax]x[ymin,ymax] with tiles of side at
+  // least minTileSize, with the n hits at positions (x[i],y[i])
+  void fill(const std::vector<double> &x, const std::vector<double> &y,
+            float xmin, float xmax, float ymin, float ymax,
+            float minTileSize) {
+    xmin_ = xmin;
+    ymin_ = ymin;
+    tileSize_ = std::max({minTileSize, (xmax - xmin) / maxTilesPerAxis,
+                          (ymax - ymin) / maxTilesPerAxis});
+    nx_ = std::min(int((xmax - xmin) / tileSize_) + 1, maxTilesPerAxis);
+    ny_ = std::min(int((ymax - ymin) / tileSize_) + 1, maxTilesPerAxis);
+
+    const unsigned int n = x.size();
+    tileOfHit_.resize(n);
+    offsets_.assign(nx_ * ny_ + 1, 0);
+    for (unsigned int i = 0; i < n; ++i) {
+      tileOfHit_[i] = globalBin(xBin(x[i]), yBin(y[i]));
+      ++offsets_[tileOfHit_[i] + 1];
+    }
+    for (int t = 0; t < nx_ * ny_; ++t)
+      offsets_[t + 1] += offsets_[t];
+    hits_.resize(n);
+    std::vector<unsigned int> next(offsets_.begin(), offsets_.end() - 1);
+    for (unsigned int i = 0; i < n; ++i)
+      hits_[next[tileOfHit_[i]]++] = i;
+  }
+
+  int xBin(double x) const {
+    return std::min(std::max(int((x - xmin_) / tileSize_), 0), nx_ - 1);
+  }
+  int yBin(double y) const {
+    return std::min(std::max(int((y - ymin_) / tileSize_), 0), ny_ - 1);
+  }
+  int globalBin(int xb, int yb) const { return xb + yb * nx_; }
+
+  int nx() const { return nx_; }
+  int ny() const { return ny_; }
+  float tileSize() const { return tileSize_; }
+
+  // hit indices in the tile (xb,yb)
+  const unsigned int *begin(int xb, int yb) const {
+    return hits_.data() + offsets_[globalBin(xb, yb)];
+  }
+  const unsigned int *end(int xb, int yb) const {
+    return hits_.data() + offsets_[globalBin(xb, yb) + 1];
+  }
+
+  // calls f(j) for the hits j in the tiles within nTiles tiles of (x,y)
+  template <typename F>
+  void forEachAround(double x, double y, int nTiles, F &&f) const {
+    const int xb = xBin(x), yb = yBin(y);
+    for (int iy = std::max(yb - nTiles, 0);
+         iy <= std::min(yb + nTiles, ny_ - 1); ++iy)
+      for (int ix = std::max(xb - nTiles, 0);
+           ix <= std::min(xb + nTiles, nx_ - 1); ++ix)
+        for (auto j = begin(ix, iy); j != end(ix, iy); ++j)
+          f(*j);
+  }
+
+private:
+  float xmin_ = 0.f, ymin_ = 0.f, tileSize_ = 1.f;
+  int nx_ = 1, ny_ = 1;
+  std::vector<unsigned int> offsets_;
+  std::vector<unsigned int> hits_;
+  std::vector<int> tileOfHit_;
+};
+
+#endif
@@ -1,6 +1,9 @@
 #include "RecoLocalCalo/HGCalRecAlgos/interface/HGCal3DClustering.h"
 #include "DataFormats/Math/interface/deltaR.h"
 
+#include "tbb/task_arena.h"
+#include "tbb/tbb.h"
+
 
 namespace {
   std::vector<size_t> sorted_indices(const reco::HGCalMultiCluster::ClusterCollection& v) {
@@ -53,11 +56,13 @@ std::vector<reco::HGCalMultiCluster> HGCal3DClustering::makeClusters(const reco:
   std::vector<reco::HGCalMultiCluster> thePreClusters;
 
   std::vector<KDTree> hit_kdtree(2*(maxlayer+1));
-  for (unsigned int i = 0; i <= 2*maxlayer+1; ++i) {
-    KDTreeBox bounds(minpos[i][0],maxpos[i][0],
-		     minpos[i][1],maxpos[i][1]);
-    hit_kdtree[i].build(points[i],bounds);
-  }
+  tbb::this_task_arena::isolate([&] {
+    tbb::parallel_for(size_t(0), size_t(2*maxlayer+2), [&](size_t i) {
+      KDTreeBox bounds(minpos[i][0],maxpos[i][0],
+		       minpos[i][1],maxpos[i][1]);
+      hit_kdtree[i].build(points[i],bounds);
+    });
+  });
   std::vector<int> vused(es.size(),0);
   unsigned int used = 0;
 
@@ -102,20 +107,36 @@ std::vector<reco::HGCalMultiCluster> HGCal3DClustering::makeClusters(const reco:
 
       }
       if( temp.size() > minClusters ) {
-	math::XYZPoint position = clusterTools->getMultiClusterPosition(temp);
-	if (std::abs(position.z()) <= 0.) continue;
-	// only store multiclusters that pass the energy threshold in getMultiClusterPosition
-	// giving them a position inside the HGCal
 	thePreClusters.push_back(temp);
-	auto& back = thePreClusters.back();
-	back.setPosition(position);
-	back.setEnergy(clusterTools->getMultiClusterEnergy(back));
       }
 
     }
 
   }
 
+  // the positions and energies of the multiclusters are independent
+  std::vector<char> inside(thePreClusters.size(),0);
+  tbb::this_task_arena::isolate([&] {
+    tbb::parallel_for(size_t(0), thePreClusters.size(), [&](size_t i) {
+      auto& multicluster = thePreClusters[i];
+      math::XYZPoint position = clusterTools->getMultiClusterPosition(multicluster);
+      if (std::abs(position.z()) <= 0.) return;
+      inside[i] = 1;
+      multicluster.setPosition(position);
+      multicluster.setEnergy(clusterTools->getMultiClusterEnergy(multicluster));
+    });
+  });
+  // only store multiclusters that pass the energy threshold in getMultiClusterPosition
+  // giving them a position inside the HGCal
+  unsigned int nInside = 0;
+  for(unsigned int i = 0; i < thePreClusters.size(); ++i) {
+    if(inside[i]) {
+      if(i != nInside) thePreClusters[nInside] = std::move(thePreClusters[i]);
+      ++nInside;
+    }
+  }
+  thePreClusters.resize(nInside);
+
   return thePreClusters;
 
 }
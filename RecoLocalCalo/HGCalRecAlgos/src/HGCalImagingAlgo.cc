@@ -63,7 +63,7 @@ void HGCalImagingAlgo::populate(const HGCRecHitCollection &hits) {
         position.x(), position.y());
 
     // for each layer, store the minimum and maximum x and y coordinates for the
-    // KDTreeBox boundaries
+    // tile grid boundaries
     if (firstHit[layer]) {
       minpos[layer][0] = position.x();
       minpos[layer][1] = position.y();
@@ -88,23 +88,33 @@ void HGCalImagingAlgo::makeClusters() {
   // assign all hits in each layer to a cluster core or halo
   tbb::this_task_arena::isolate([&] {
     tbb::parallel_for(size_t(0), size_t(2 * maxlayer + 2), [&](size_t i) {
-      KDTreeBox bounds(minpos[i][0], maxpos[i][0], minpos[i][1], maxpos[i][1]);
-      KDTree hit_kdtree;
-      hit_kdtree.build(points[i], bounds);
-
       unsigned int actualLayer =
           i > maxlayer
               ? (i - (maxlayer + 1))
-              : i; // maps back from index used for KD trees to actual layer
+              : i; // maps back from index used for the tiles to actual layer
+
+      // tiles as large as the critical distance, the searches within it only
+      // look at the neighbouring tiles
+      const unsigned int nd_size = points[i].size();
+      std::vector<double> x(nd_size), y(nd_size);
+      for (unsigned int j = 0; j < nd_size; ++j) {
+        x[j] = points[i][j].data.x;
+        y[j] = points[i][j].data.y;
+      }
+      HGCalLayerTiles tiles;
+      tiles.fill(x, y, minpos[i][0], maxpos[i][0], minpos[i][1], maxpos[i][1],
+                 criticalDistance(actualLayer));
 
       double maxdensity = calculateLocalDensity(
-          points[i], hit_kdtree, actualLayer); // also stores rho (energy
-                                               // density) for each point (node)
+          points[i], tiles, actualLayer); // also stores rho (energy
+                                          // density) for each point (node)
+      // indices sorted by decreasing rho, computed once for both passes
+      std::vector<size_t> rs = sorted_indices(points[i]);
       // calculate distance to nearest point with higher density storing
       // distance (delta) and point's index
-      calculateDistanceToHigher(points[i]);
-      findAndAssignClusters(points[i], hit_kdtree, maxdensity, bounds,
-                            actualLayer, layerClustersPerLayer[i]);
+      calculateDistanceToHigher(points[i], tiles, rs);
+      findAndAssignClusters(points[i], tiles, maxdensity, actualLayer, rs,
+                            layerClustersPerLayer[i]);
     });
   });
 }
@@ -230,43 +240,47 @@ HGCalImagingAlgo::calculatePosition(std::vector<KDNode> &v) const {
   return math::XYZPoint(0, 0, 0);
 }
 
+float HGCalImagingAlgo::criticalDistance(const unsigned int layer) const {
+  if (layer <= lastLayerEE)
+    return vecDeltas[0];
+  else if (layer <= lastLayerFH)
+    return vecDeltas[1];
+  else
+    return vecDeltas[2];
+}
+
 double HGCalImagingAlgo::calculateLocalDensity(std::vector<KDNode> &nd,
-                                               KDTree &lp,
+                                               const HGCalLayerTiles &tiles,
                                                const unsigned int layer) const {
 
+  // maximum search distance (critical distance) for local density calculation
+  const float delta_c = criticalDistance(layer);
+
+  // for each node calculate local density rho and store it, the nodes are
+  // independent
+  tbb::parallel_for(
+      tbb::blocked_range<unsigned int>(0, nd.size()),
+      [&](const tbb::blocked_range<unsigned int> &range) {
+        for (unsigned int i = range.begin(); i < range.end(); ++i) {
+          // the hits within delta_c are in the 3x3 tiles around the hit
+          tiles.forEachAround(nd[i].data.x, nd[i].data.y, 1,
+                              [&](unsigned int j) {
+                                if (distance(nd[i].data, nd[j].data) < delta_c)
+                                  nd[i].data.rho += nd[j].data.weight;
+                              });
+        }
+      });
+
   double maxdensity = 0.;
-  float delta_c; // maximum search distance (critical distance) for local
-                 // density calculation
-  if (layer <= lastLayerEE)
-    delta_c = vecDeltas[0];
-  else if (layer <= lastLayerFH)
-    delta_c = vecDeltas[1];
-  else
-    delta_c = vecDeltas[2];
-
-  // for each node calculate local density rho and store it
-  for (unsigned int i = 0; i < nd.size(); ++i) {
-    // speec up search by looking within +/- delta_c window only
-    KDTreeBox search_box(nd[i].dims[0] - delta_c, nd[i].dims[0] + delta_c,
-                         nd[i].dims[1] - delta_c, nd[i].dims[1] + delta_c);
-    std::vector<KDNode> found;
-    lp.search(search_box, found);
-    const unsigned int found_size = found.size();
-    for (unsigned int j = 0; j < found_size; j++) {
-      if (distance(nd[i].data, found[j].data) < delta_c) {
-        nd[i].data.rho += found[j].data.weight;
-        maxdensity = std::max(maxdensity, nd[i].data.rho);
-      }
-    } // end loop found
-  }   // end loop nodes
+  for (const auto &node : nd)
+    maxdensity = std::max(maxdensity, node.data.rho);
   return maxdensity;
 }
 
 double
-HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd) const {
-
-  // sort vector of Hexels by decreasing local density
-  std::vector<size_t> rs = sorted_indices(nd);
+HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd,
+                                            const HGCalLayerTiles &tiles,
+                                            const std::vector<size_t> &rs) const {
 
   double maxdensity = 0.0;
   int nearestHigher = -1;
@@ -291,32 +305,66 @@ HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd) const {
   const double max_dist2 = dist2;
   const unsigned int nd_size = nd.size();
 
-  for (unsigned int oi = 1; oi < nd_size;
-       ++oi) { // start from second-highest density
-    dist2 = max_dist2;
-    unsigned int i = rs[oi];
-    // we only need to check up to oi since hits
-    // are ordered by decreasing density
-    // and all points coming BEFORE oi are guaranteed to have higher rho
-    // and the ones AFTER to have lower rho
-    for (unsigned int oj = 0; oj < oi; ++oj) {
-      unsigned int j = rs[oj];
-      double tmp = distance2(nd[i].data, nd[j].data);
-      if (tmp <= dist2) { // this "<=" instead of "<" addresses the (rare) case
-                          // when there are only two hits
-        dist2 = tmp;
-        nearestHigher = j;
-      }
-    }
-    nd[i].data.delta = std::sqrt(dist2);
-    nd[i].data.nearestHigher =
-        nearestHigher; // this uses the original unsorted hitlist
-  }
+  // position of each hit in the order of decreasing density
+  std::vector<unsigned int> rank(nd_size);
+  for (unsigned int oi = 0; oi < nd_size; ++oi)
+    rank[rs[oi]] = oi;
+
+  // the hits of higher density are looked for in rings of tiles of increasing
+  // size around the hit, until the ring is farther than the nearest one found
+  const int maxRing = std::max(tiles.nx(), tiles.ny());
+  tbb::parallel_for(
+      tbb::blocked_range<unsigned int>(1, nd_size),
+      [&](const tbb::blocked_range<unsigned int> &range) {
+        for (unsigned int oi = range.begin(); oi < range.end(); ++oi) {
+          const unsigned int i = rs[oi];
+          const int xb = tiles.xBin(nd[i].data.x);
+          const int yb = tiles.yBin(nd[i].data.y);
+          double dist2 = max_dist2;
+          int nearestHigher = -1;
+          auto checkTile = [&](int ix, int iy) {
+            for (auto j = tiles.begin(ix, iy); j != tiles.end(ix, iy); ++j) {
+              // only the hits before oi have a higher rho
+              if (rank[*j] >= oi)
+                continue;
+              double tmp = distance2(nd[i].data, nd[*j].data);
+              // among the nearest hits, take the last one in the rho order,
+              // as the former search by increasing rank with "<="
+              if (tmp < dist2 ||
+                  (tmp == dist2 &&
+                   (nearestHigher < 0 || rank[*j] > rank[nearestHigher]))) {
+                dist2 = tmp;
+                nearestHigher = *j;
+              }
+            }
+          };
+          for (int ring = 0; ring <= maxRing; ++ring) {
+            // the hits in the ring are at least ring-1 tiles away
+            const double minDist = (ring - 1) * tiles.tileSize();
+            if (ring > 1 && minDist * minDist > dist2)
+              break;
+            for (int iy = yb - ring; iy <= yb + ring; ++iy) {
+              if (iy < 0 || iy >= tiles.ny())
+                continue;
+              // only the first and last rows of the ring are full
+              const int step =
+                  (iy == yb - ring || iy == yb + ring) ? 1 : std::max(2 * ring, 1);
+              for (int ix = xb - ring; ix <= xb + ring; ix += step) {
+                if (ix >= 0 && ix < tiles.nx())
+                  checkTile(ix, iy);
+              }
+            }
+          }
+          nd[i].data.delta = std::sqrt(dist2);
+          nd[i].data.nearestHigher =
+              nearestHigher; // this uses the original unsorted hitlist
+        }
+      });
   return maxdensity;
 }
 int HGCalImagingAlgo::findAndAssignClusters(
-    std::vector<KDNode> &nd, KDTree &lp, double maxdensity, KDTreeBox &bounds,
-    const unsigned int layer,
+    std::vector<KDNode> &nd, const HGCalLayerTiles &tiles, double maxdensity,
+    const unsigned int layer, const std::vector<size_t> &rs,
     std::vector<std::vector<KDNode>> &clustersOnLayer) const {
 
   // this is called once per layer and endcap...
@@ -325,16 +373,8 @@ int HGCalImagingAlgo::findAndAssignClusters(
   // cluster centers...
 
   unsigned int nClustersOnLayer = 0;
-  float delta_c; // critical distance
-  if (layer <= lastLayerEE)
-    delta_c = vecDeltas[0];
-  else if (layer <= lastLayerFH)
-    delta_c = vecDeltas[1];
-  else
-    delta_c = vecDeltas[2];
+  const float delta_c = criticalDistance(layer); // critical distance
 
-  std::vector<size_t> rs =
-      sorted_indices(nd); // indices sorted by decreasing rho
   std::vector<size_t> ds =
       sort_by_delta(nd); // sort in decreasing distance to higher
 
@@ -386,49 +426,44 @@ int HGCalImagingAlgo::findAndAssignClusters(
   }
   clustersOnLayer.resize(nClustersOnLayer);
 
-  // assign points closer than dc to other clusters to border region
-  // and find critical border density
+  // assign points closer than dc to other clusters to border region:
+  // check for each hit if there are hits from another cluster within d_c, the
+  // hits are independent
+  tbb::parallel_for(
+      tbb::blocked_range<unsigned int>(0, nd_size),
+      [&](const tbb::blocked_range<unsigned int> &range) {
+        for (unsigned int i = range.begin(); i < range.end(); ++i) {
+          int ci = nd[i].data.clusterIndex;
+          if (ci == -1)
+            continue;
+          bool flag_border = false;
+          bool flag_isolated = true;
+          tiles.forEachAround(
+              nd[i].data.x, nd[i].data.y, 1, [&](unsigned int j) {
+                if (flag_border || nd[j].data.clusterIndex == -1)
+                  return;
+                float dist = distance(nd[j].data, nd[i].data);
+                // check if the hit is not within d_c of another cluster
+                if (dist < delta_c && nd[j].data.clusterIndex != ci) {
+                  // in which case we assign it to the border
+                  flag_border = true;
+                } else if (dist < delta_c && dist != 0. &&
+                           nd[j].data.clusterIndex == ci) {
+                  // in this case it is not an isolated hit
+                  // the dist!=0 is because the hit being looked at is also
+                  // among the neighbours, at dist==0
+                  flag_isolated = false;
+                }
+              });
+          // the hit is more than delta_c from any of its brethren
+          nd[i].data.isBorder = flag_border || flag_isolated;
+        }
+      });
+
+  // find critical border density
   std::vector<double> rho_b(nClustersOnLayer, 0.);
-  lp.clear();
-  lp.build(nd, bounds);
-  // now loop on all hits again :( and check: if there are hits from another
-  // cluster within d_c -> flag as border hit
   for (unsigned int i = 0; i < nd_size; ++i) {
     int ci = nd[i].data.clusterIndex;
-    bool flag_isolated = true;
-    if (ci != -1) {
-      KDTreeBox search_box(nd[i].dims[0] - delta_c, nd[i].dims[0] + delta_c,
-                           nd[i].dims[1] - delta_c, nd[i].dims[1] + delta_c);
-      std::vector<KDNode> found;
-      lp.search(search_box, found);
-
-      const unsigned int found_size = found.size();
-      for (unsigned int j = 0; j < found_size;
-           j++) { // start from 0 here instead of 1
-        // check if the hit is not within d_c of another cluster
-        if (found[j].data.clusterIndex != -1) {
-          float dist = distance(found[j].data, nd[i].data);
-          if (dist < delta_c && found[j].data.clusterIndex != ci) {
-            // in which case we assign it to the border
-            nd[i].data.isBorder = true;
-            break;
-          }
-          // because we are using two different containers, we have to make sure
-          // that we don't unflag the
-          // hit when it finds *itself* closer than delta_c
-          if (dist < delta_c && dist != 0. &&
-              found[j].data.clusterIndex == ci) {
-            // in this case it is not an isolated hit
-            // the dist!=0 is because the hit being looked at is also inside the
-            // search box and at dist==0
-            flag_isolated = false;
-          }
-        }
-      }
-      if (flag_isolated)
-        nd[i].data.isBorder =
-            true; // the hit is more than delta_c from any of its brethren
-    }
     // check if this border hit has density larger than the current rho_b and
     // update
     if (nd[i].data.isBorder && rho_b[ci] < nd[i].data.rho)
@@ -0,0 +1,107 @@
+/* Unit test for HGCalImagingAlgo: the search of the nearest hit of higher
+   density in the tiles must give the delta and nearestHigher of the plain
+   scan over all the hits of higher density, also among hits of equal
+   density and at equal distances
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "RecoLocalCalo/HGCalRecAlgos/interface/HGCalImagingAlgo.h"
+
+#include <cmath>
+#include <vector>
+
+class testHGCalImagingAlgo: public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(testHGCalImagingAlgo);
+  CPPUNIT_TEST(testDistanceToHigher);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown(){}
+
+  void testDistanceToHigher();
+
+private:
+  typedef HGCalImagingAlgo::KDNode KDNode;
+
+  void scanDistanceToHigher(std::vector<KDNode> &nd) const;
+
+  HGCalImagingAlgo algo_;
+  std::vector<KDNode> nodes_;
+  float xmin_, xmax_, ymin_, ymax_;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testHGCalImagingAlgo);
+
+void testHGCalImagingAlgo::setUp(){
+
+  // hits on a square grid, with few density values so that many hits have
+  // the same density and the same distance to several hits of higher density
+  const int n = 12;
+  for (int ix=0; ix<n; ++ix) {
+    for (int iy=0; iy<n; ++iy) {
+      HGCalImagingAlgo::Hexel hexel;
+      hexel.x = ix;
+      hexel.y = iy;
+      hexel.rho = (ix*7 + iy*3) % 4;
+      nodes_.emplace_back(hexel, float(hexel.x), float(hexel.y));
+    }
+  }
+  // two hits at the position of another one, one of them with the same density
+  nodes_.push_back(nodes_[30]);
+  nodes_.push_back(nodes_[30]);
+  nodes_.back().data.rho += 1.;
+  xmin_ = ymin_ = 0.f;
+  xmax_ = ymax_ = n-1;
+}
+
+// the former search, over all the hits before the hit in the density order
+void testHGCalImagingAlgo::scanDistanceToHigher(std::vector<KDNode> &nd) const {
+  std::vector<size_t> rs = sorted_indices(nd);
+  double dist2 = 0.;
+  for (auto &j : nd) dist2 = std::max(dist2, algo_.distance2(nd[rs[0]].data, j.data));
+  nd[rs[0]].data.delta = std::sqrt(dist2);
+  nd[rs[0]].data.nearestHigher = -1;
+  const double max_dist2 = dist2;
+  int nearestHigher = -1;
+  for (unsigned int oi = 1; oi < nd.size(); ++oi) {
+    dist2 = max_dist2;
+    unsigned int i = rs[oi];
+    for (unsigned int oj = 0; oj < oi; ++oj) {
+      unsigned int j = rs[oj];
+      double tmp = algo_.distance2(nd[i].data, nd[j].data);
+      if (tmp <= dist2) {
+        dist2 = tmp;
+        nearestHigher = j;
+      }
+    }
+    nd[i].data.delta = std::sqrt(dist2);
+    nd[i].data.nearestHigher = nearestHigher;
+  }
+}
+
+void testHGCalImagingAlgo::testDistanceToHigher(){
+
+  std::vector<KDNode> expected = nodes_;
+  scanDistanceToHigher(expected);
+
+  std::vector<double> x, y;
+  for (const auto &node : nodes_) {
+    x.push_back(node.data.x);
+    y.push_back(node.data.y);
+  }
+
+  // tiles smaller and larger than the hit spacing, up to a single tile
+  for (float tileSize : {0.5f, 1.f, 2.5f, 100.f}) {
+    std::vector<KDNode> nd = nodes_;
+    HGCalLayerTiles tiles;
+    tiles.fill(x, y, xmin_, xmax_, ymin_, ymax_, tileSize);
+    algo_.calculateDistanceToHigher(nd, tiles, sorted_indices(nd));
+    for (unsigned int i = 0; i < nd.size(); ++i) {
+      CPPUNIT_ASSERT_EQUAL(expected[i].data.nearestHigher, nd[i].data.nearestHigher);
+      CPPUNIT_ASSERT_EQUAL(expected[i].data.delta, nd[i].data.delta);
+    }
+  }
+}
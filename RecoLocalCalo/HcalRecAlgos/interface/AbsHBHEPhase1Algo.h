@@ -4,9 +4,12 @@
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "DataFormats/HcalRecHit/interface/HBHERecHit.h"
 #include "DataFormats/HcalRecHit/interface/HBHEChannelInfo.h"
+#include "DataFormats/HcalRecHit/interface/HcalRecHitCollections.h"
 #include "CalibFormats/HcalObjects/interface/HcalCalibrations.h"
 #include "CondFormats/HcalObjects/interface/HcalRecoParam.h"
 
+#include <vector>
+
 class AbsHcalAlgoData;
 
 //
@@ -51,6 +54,24 @@ public:
                                    const HcalRecoParam* params,
                                    const HcalCalibrations& calibs,
                                    bool isRealData) = 0;
+
+    // Reconstruct several channels at once. "params" and "calibs"
+    // are parallel to "infos" ("params" may be empty), and the rechits
+    // are returned in the order of "infos", with the same convention
+    // for the discarded channels. By default, the channels are simply
+    // reconstructed one after another.
+    inline virtual void reconstruct(const HBHEChannelInfoCollection& infos,
+                                    const std::vector<const HcalRecoParam*>& params,
+                                    const std::vector<const HcalCalibrations*>& calibs,
+                                    const bool isRealData,
+                                    std::vector<HBHERecHit>* rechits)
+    {
+        const unsigned n = infos.size();
+        rechits->resize(n);
+        for (unsigned i=0; i<n; ++i)
+            (*rechits)[i] = reconstruct(infos[i], params.empty() ? nullptr : params[i],
+                                        *calibs[i], isRealData);
+    }
 };
 
 #endif // RecoLocalCalo_HcalRecAlgos_AbsHBHEPhase1Algo_h_
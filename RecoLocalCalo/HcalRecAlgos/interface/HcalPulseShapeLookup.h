@@ -0,0 +1,82 @@
+#ifndef RecoLocalCalo_HcalRecAlgos_HcalPulseShapeLookup_h
+#define RecoLocalCalo_HcalRecAlgos_HcalPulseShapeLookup_h
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <vector>
+
+#include "CalibCalorimetry/HcalAlgos/interface/HcalPulseShapes.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/PulseShapeFunctor.h"
+
+//
+// Pulse shape of unit amplitude, binned in time slices, tabulated
+// as a function of the pulse time (time slew included) for one shape.
+//
+// The binned shape computed by PulseShapeFunctor is affine in the
+// pulse time between multiples of 0.5 ns, so the table keeps, for
+// each such interval, the value at its centre and the slope, plus
+// the values at the multiples themselves (where the shape can jump):
+// the functor is reproduced up to rounding.
+//
+class HcalPulseShapeTable
+{
+public:
+    typedef std::array<double,HcalConst::maxSamples> Samples;
+
+    // Tabulated range. Below tMin PulseShapeFunctor would read past
+    // the end of its accumulated shape.
+    static constexpr double tMin = -120.;
+    static constexpr double tMax = 150.;
+    static constexpr double tStep = 0.5;
+    static constexpr int nIntervals = static_cast<int>((tMax - tMin)/tStep);
+
+    explicit HcalPulseShapeTable(const HcalPulseShapes::Shape& ps);
+
+    inline bool inRange(const double t) const {return t >= tMin && t < tMax;}
+
+    // Binned pulse shape for pulse time t (must be in range)
+    // and the given amplitude
+    inline void fill(Samples& out, const double t, const double height) const
+    {
+        const double x = (t - tMin)*(1./tStep);
+        const int i = std::min(static_cast<int>(x), nIntervals - 1);
+        if (x == i)
+        {
+            const Samples& k = knot_[i];
+            for (int j=0; j<HcalConst::maxSamples; ++j)
+                out[j] = height*k[j];
+            return;
+        }
+        const double dt = t - (tMin + (i + 0.5)*tStep);
+        const Samples& v = value_[i];
+        const Samples& d = slope_[i];
+        for (int j=0; j<HcalConst::maxSamples; ++j)
+            out[j] = height*(v[j] + dt*d[j]);
+    }
+
+private:
+    std::vector<Samples> value_;
+    std::vector<Samples> slope_;
+    std::vector<Samples> knot_;
+};
+
+//
+// Tables for a set of pulse shape ids, built once per IOV by
+// HcalPulseShapeLookupESProducer and used by the pulse shape fits
+// (Method 2 and Mahi) instead of integrating the shape at every call
+//
+class HcalPulseShapeLookup
+{
+public:
+    HcalPulseShapeLookup(const HcalPulseShapes& shapes,
+                         const std::vector<int>& shapeIds);
+
+    // Returns nullptr if the shape was not tabulated
+    const HcalPulseShapeTable* table(int shapeId) const;
+
+private:
+    std::map<int, HcalPulseShapeTable> tables_;
+};
+
+#endif // RecoLocalCalo_HcalRecAlgos_HcalPulseShapeLookup_h
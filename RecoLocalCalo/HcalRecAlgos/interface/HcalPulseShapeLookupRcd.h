@@ -0,0 +1,8 @@
+#ifndef RecoLocalCalo_HcalRecAlgos_HcalPulseShapeLookupRcd_h
+#define RecoLocalCalo_HcalRecAlgos_HcalPulseShapeLookupRcd_h
+
+#include "FWCore/Framework/interface/EventSetupRecordImplementation.h"
+
+class HcalPulseShapeLookupRcd : public edm::eventsetup::EventSetupRecordImplementation<HcalPulseShapeLookupRcd> {};
+
+#endif
@@ -14,6 +14,9 @@
 
 #include <Math/Functor.h>
 
+#include <limits>
+#include <vector>
+
 struct MahiNnlsWorkspace {
 
   unsigned int nPulseTot;
@@ -140,7 +143,9 @@ class MahiFit
 
   void doFit(std::array<float,3> &correctedOutput, const int nbx) const;
 
-  void setPulseShapeTemplate  (const HcalPulseShapes::Shape& ps,const HcalTimeSlew * hcalTimeSlewDelay);
+  // "table" (optional) is the tabulated version of "ps"
+  void setPulseShapeTemplate  (const HcalPulseShapes::Shape& ps,const HcalTimeSlew * hcalTimeSlewDelay,
+			       const HcalPulseShapeTable* table=nullptr);
   void resetPulseShapeTemplate(const HcalPulseShapes::Shape& ps);
 
   typedef BXVector::Index Index;
@@ -155,6 +160,7 @@ class MahiFit
   void updatePulseShape(double itQ, FullSampleVector &pulseShape, 
 			FullSampleVector &pulseDeriv,
 			FullSampleMatrix &pulseCov) const;
+  void evalPulseShape(float t0) const;
 
   double calculateArrivalTime() const;
   double calculateChiSq() const;
@@ -204,8 +210,35 @@ class MahiFit
 
   //for pulse shapes
   int cntsetPulseShape_;
-  std::unique_ptr<FitterFuncs::PulseShapeFunctor> psfPtr_;
-  std::unique_ptr<ROOT::Math::Functor> pfunctor_;
+
+  // pulse shape evaluated at t0, t0-dt and t0+dt
+  struct PulseTemplate {
+    float t0 = std::numeric_limits<float>::quiet_NaN();
+    double dt = 0;
+    std::array<double, MaxSVSize> pulseN;
+    std::array<double, MaxSVSize> pulseM;
+    std::array<double, MaxSVSize> pulseP;
+  };
+
+  // functor of one pulse shape and the templates last evaluated with it
+  // (direct mapped on t0: the time slew depends on the charge, but
+  // the pre-fit and the full fit, and all the BXs below 1 GeV, share t0)
+  struct PulseShapeTemplates {
+    static constexpr unsigned int nTemplates = 64;
+    const HcalPulseShapes::Shape* shape = nullptr;
+    const HcalPulseShapeTable* table = nullptr;
+    std::unique_ptr<FitterFuncs::PulseShapeFunctor> psfPtr;
+    std::unique_ptr<ROOT::Math::Functor> pfunctor;
+    std::array<PulseTemplate, nTemplates> templates;
+  };
+
+  // one entry per pulse shape seen so far, so that switching between
+  // the shapes of HB and HE channels does not rebuild the functor
+  std::vector<std::unique_ptr<PulseShapeTemplates>> pulseShapeTemplates_;
+  PulseShapeTemplates* currentTemplates_=nullptr;
+
+  // entry of a pulse shape, nullptr if it was not seen yet
+  PulseShapeTemplates* findPulseShapeTemplates(const HcalPulseShapes::Shape& ps) const;
 
 }; 
 #endif
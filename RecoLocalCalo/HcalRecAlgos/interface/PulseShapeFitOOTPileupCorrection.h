@@ -44,7 +44,9 @@ public:
     const HcalTimeSlew* hcalTimeSlewDelay_=nullptr;
     double tsDelay1GeV_=0;
 
-    void setPulseShapeTemplate  (const HcalPulseShapes::Shape& ps, bool isHPD, unsigned nSamples, const HcalTimeSlew* hcalTimeSlewDelay);
+    // "table" (optional) is the tabulated version of "ps"
+    void setPulseShapeTemplate  (const HcalPulseShapes::Shape& ps, bool isHPD, unsigned nSamples, const HcalTimeSlew* hcalTimeSlewDelay,
+				 const HcalPulseShapeTable* table=nullptr);
     void resetPulseShapeTemplate(const HcalPulseShapes::Shape& ps, unsigned nSamples);
 
 private:
@@ -14,6 +14,8 @@ namespace HcalConst{
 
 }
 
+class HcalPulseShapeTable;
+
 namespace FitterFuncs{
   
    class PulseShapeFunctor {
@@ -44,6 +46,14 @@ namespace FitterFuncs{
      void getPulseShape(std::array<double,HcalConst::maxSamples>& fillPulseShape) { 
        fillPulseShape = pulse_shape_;
      }
+
+     // binned pulse shape of unit amplitude for the given pulse time
+     void computePulseShape(std::array<double,HcalConst::maxSamples>& fillPulseShape, double pulseTime) {
+       funcShape(fillPulseShape, pulseTime, 1., 0.);
+     }
+
+     // use a precomputed table (not owned, may be null) within its range
+     void setPulseShapeTable(const HcalPulseShapeTable* table) { pulseShapeTable_ = table; }
      
    private:
      std::array<float,HcalConst::maxPSshapeBin> pulse_hist;
@@ -71,6 +81,8 @@ namespace FitterFuncs{
      std::array<double,HcalConst::maxSamples> pulse_shape_;
      std::array<double,HcalConst::maxSamples> pulse_shape_sum_;
 
+     const HcalPulseShapeTable* pulseShapeTable_;
+
    };
    
 }
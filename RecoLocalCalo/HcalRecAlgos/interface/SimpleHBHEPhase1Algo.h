@@ -13,6 +13,7 @@
 #include "RecoLocalCalo/HcalRecAlgos/interface/PulseShapeFitOOTPileupCorrection.h"
 #include "RecoLocalCalo/HcalRecAlgos/interface/HcalDeterministicFit.h"
 #include "RecoLocalCalo/HcalRecAlgos/interface/MahiFit.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/HcalPulseShapeLookup.h"
 #include "CalibCalorimetry/HcalAlgos/interface/HcalTimeSlew.h"
 
 class SimpleHBHEPhase1Algo : public AbsHBHEPhase1Algo
@@ -61,6 +62,19 @@ public:
                                    const HcalRecoParam* params,
                                    const HcalCalibrations& calibs,
                                    bool isRealData) override;
+
+    // Reconstruct a whole collection. The channels are visited
+    // grouped by pulse shape, so that the pulse shape fits (Method 2
+    // and Mahi) switch templates once per shape rather than from one
+    // channel to the next. Rechits are returned in the order of "infos".
+    // "params" and "calibs" are parallel to "infos"; "params" may be
+    // empty or contain null pointers.
+    void reconstruct(const HBHEChannelInfoCollection& infos,
+                     const std::vector<const HcalRecoParam*>& params,
+                     const std::vector<const HcalCalibrations*>& calibs,
+                     bool isRealData,
+                     std::vector<HBHERecHit>* rechits) override;
+
     // Basic accessors
     inline int getFirstSampleShift() const {return firstSampleShift_;}
     inline int getSamplesToAdd() const {return samplesToAdd_;}
@@ -109,6 +123,9 @@ private:
     std::unique_ptr<MahiFit> mahiOOTpuCorr_;
 
     HcalPulseShapes theHcalPulseShapes_;
+
+    // Tabulated pulse shapes, if HcalPulseShapeLookupRcd is available
+    const HcalPulseShapeLookup* pulseShapeLookup_;
 };
 
 #endif // RecoLocalCalo_HcalRecAlgos_SimpleHBHEPhase1Algo_h_
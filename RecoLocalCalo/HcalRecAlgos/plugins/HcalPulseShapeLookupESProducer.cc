@@ -0,0 +1,63 @@
+// -*- C++ -*-
+//
+// Package:    RecoLocalCalo/HcalRecAlgos
+// Class:      HcalPulseShapeLookupESProducer
+//
+/**\class HcalPulseShapeLookupESProducer
+
+ Description: Producer for HcalPulseShapeLookup, the pulse shapes used
+ by the HBHE pulse fits tabulated as a function of the pulse time
+
+*/
+
+// system include files
+#include <memory>
+#include <vector>
+
+// user include files
+#include "FWCore/Framework/interface/ModuleFactory.h"
+#include "FWCore/Framework/interface/ESProducer.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+
+#include "CalibCalorimetry/HcalAlgos/interface/HcalPulseShapes.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/HcalPulseShapeLookup.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/HcalPulseShapeLookupRcd.h"
+
+class HcalPulseShapeLookupESProducer : public edm::ESProducer {
+   public:
+      HcalPulseShapeLookupESProducer(const edm::ParameterSet&);
+
+      static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+      typedef std::unique_ptr<HcalPulseShapeLookup> ReturnType;
+
+      ReturnType produce(const HcalPulseShapeLookupRcd&);
+   private:
+      const std::vector<int> shapeIds_;
+};
+
+HcalPulseShapeLookupESProducer::HcalPulseShapeLookupESProducer(const edm::ParameterSet& iConfig)
+    : shapeIds_(iConfig.getParameter<std::vector<int>>("shapeIds"))
+{
+   setWhatProduced(this);
+}
+
+HcalPulseShapeLookupESProducer::ReturnType
+HcalPulseShapeLookupESProducer::produce(const HcalPulseShapeLookupRcd&)
+{
+   const HcalPulseShapes shapes;
+   return std::make_unique<HcalPulseShapeLookup>(shapes, shapeIds_);
+}
+
+void HcalPulseShapeLookupESProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+    edm::ParameterSetDescription desc;
+    // HBHE reco shapes: HPD data and MC, SiPM
+    desc.add<std::vector<int>>("shapeIds", {105, 123, 125, 201, 203, 205, 206, 207});
+    descriptions.add("hcalPulseShapeLookup", desc);
+}
+
+//define this as a plug-in
+DEFINE_FWK_EVENTSETUP_MODULE(HcalPulseShapeLookupESProducer);
@@ -0,0 +1,12 @@
+import FWCore.ParameterSet.Config as cms
+
+# Tabulated pulse shapes for the HBHE pulse fits (Method 2 and Mahi).
+# When the record is not available the fits integrate the shapes on the fly.
+
+essourcePulseShapeLookup = cms.ESSource("EmptyESSource",
+                   recordName = cms.string("HcalPulseShapeLookupRcd"),
+                   firstValid = cms.vuint32(1),
+                   iovIsRunNotTime = cms.bool(True)
+)
+
+from RecoLocalCalo.HcalRecAlgos.hcalPulseShapeLookup_cfi import hcalPulseShapeLookup
@@ -0,0 +1,3 @@
+#include "FWCore/Utilities/interface/typelookup.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/HcalPulseShapeLookup.h"
+TYPELOOKUP_DATA_REG(HcalPulseShapeLookup);
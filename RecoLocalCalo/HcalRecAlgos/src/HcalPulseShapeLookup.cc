@@ -0,0 +1,36 @@
+#include "RecoLocalCalo/HcalRecAlgos/interface/HcalPulseShapeLookup.h"
+
+HcalPulseShapeTable::HcalPulseShapeTable(const HcalPulseShapes::Shape& ps)
+    : value_(nIntervals), slope_(nIntervals), knot_(nIntervals)
+{
+    // only the binned shape is used, the fit settings are irrelevant
+    FitterFuncs::PulseShapeFunctor psf(ps, false, false, false, 1, 0, 0, HcalConst::maxSamples);
+
+    // The centre and the quarter points are away from the knots at
+    // the interval edges, where the functor can be discontinuous
+    Samples lo, hi;
+    for (int i=0; i<nIntervals; ++i)
+    {
+        psf.computePulseShape(knot_[i], tMin + i*tStep);
+        const double t = tMin + (i + 0.5)*tStep;
+        psf.computePulseShape(value_[i], t);
+        psf.computePulseShape(lo, t - 0.25*tStep);
+        psf.computePulseShape(hi, t + 0.25*tStep);
+        for (int j=0; j<HcalConst::maxSamples; ++j)
+            slope_[i][j] = (hi[j] - lo[j])/(0.5*tStep);
+    }
+}
+
+HcalPulseShapeLookup::HcalPulseShapeLookup(const HcalPulseShapes& shapes,
+                                           const std::vector<int>& shapeIds)
+{
+    for (const int id : shapeIds)
+        if (tables_.find(id) == tables_.end())
+            tables_.emplace(id, HcalPulseShapeTable(shapes.getShape(id)));
+}
+
+const HcalPulseShapeTable* HcalPulseShapeLookup::table(const int shapeId) const
+{
+    auto it = tables_.find(shapeId);
+    return it == tables_.end() ? nullptr : &it->second;
+}
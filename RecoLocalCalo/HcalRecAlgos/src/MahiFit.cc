@@ -1,6 +1,9 @@
 #include "RecoLocalCalo/HcalRecAlgos/interface/MahiFit.h" 
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
+#include <algorithm>
+#include <cstring>
+
 MahiFit::MahiFit() :
   fullTSSize_(19), 
   fullTSofInterest_(8)
@@ -261,22 +264,7 @@ void MahiFit::updatePulseShape(double itQ, FullSampleVector &pulseShape, FullSam
     else t0+=hcalTimeSlewDelay_->delay(itQ,slewFlavor_);
   }
 
-  nnlsWork_.pulseN.fill(0);
-  nnlsWork_.pulseM.fill(0);
-  nnlsWork_.pulseP.fill(0);
-
-  const double xx[4]={t0, 1.0, 0.0, 3};
-  const double xxm[4]={-nnlsWork_.dt+t0, 1.0, 0.0, 3};
-  const double xxp[4]={ nnlsWork_.dt+t0, 1.0, 0.0, 3};
-
-  (*pfunctor_)(&xx[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseN);
-
-  (*pfunctor_)(&xxm[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseM);
-  
-  (*pfunctor_)(&xxp[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseP);
+  evalPulseShape(t0);
 
   //in the 2018+ case where the sample of interest (SOI) is in TS3, add an extra offset to align 
   //with previous SOI=TS4 case assumed by psfPtr_->getPulseShape()
@@ -305,6 +293,35 @@ void MahiFit::updatePulseShape(double itQ, FullSampleVector &pulseShape, FullSam
   
 }
 
+void MahiFit::evalPulseShape(float t0) const {
+
+  uint32_t bits;
+  std::memcpy(&bits, &t0, sizeof(bits));
+  auto & tmpl = currentTemplates_->templates[(bits^(bits>>16))%PulseShapeTemplates::nTemplates];
+
+  if (!(tmpl.t0==t0 && tmpl.dt==nnlsWork_.dt)) {
+    const double xx[4]={t0, 1.0, 0.0, 3};
+    const double xxm[4]={-nnlsWork_.dt+t0, 1.0, 0.0, 3};
+    const double xxp[4]={ nnlsWork_.dt+t0, 1.0, 0.0, 3};
+
+    (*currentTemplates_->pfunctor)(&xx[0]);
+    currentTemplates_->psfPtr->getPulseShape(tmpl.pulseN);
+
+    (*currentTemplates_->pfunctor)(&xxm[0]);
+    currentTemplates_->psfPtr->getPulseShape(tmpl.pulseM);
+
+    (*currentTemplates_->pfunctor)(&xxp[0]);
+    currentTemplates_->psfPtr->getPulseShape(tmpl.pulseP);
+
+    tmpl.t0 = t0;
+    tmpl.dt = nnlsWork_.dt;
+  }
+
+  nnlsWork_.pulseN = tmpl.pulseN;
+  nnlsWork_.pulseM = tmpl.pulseM;
+  nnlsWork_.pulseP = tmpl.pulseP;
+}
+
 void MahiFit::updateCov() const {
 
   nnlsWork_.invCovMat.resize(nnlsWork_.tsSize, nnlsWork_.tsSize);
@@ -472,7 +489,8 @@ double MahiFit::calculateChiSq() const {
   return (nnlsWork_.covDecomp.matrixL().solve(nnlsWork_.pulseMat*nnlsWork_.ampVec - nnlsWork_.amplitudes)).squaredNorm();
 }
 
-void MahiFit::setPulseShapeTemplate(const HcalPulseShapes::Shape& ps,const HcalTimeSlew* hcalTimeSlewDelay) {
+void MahiFit::setPulseShapeTemplate(const HcalPulseShapes::Shape& ps,const HcalTimeSlew* hcalTimeSlewDelay,
+				    const HcalPulseShapeTable* table) {
 
   if (!(&ps == currentPulseShape_ ))
     {
@@ -480,19 +498,41 @@ void MahiFit::setPulseShapeTemplate(const HcalPulseShapes::Shape& ps,const HcalT
       hcalTimeSlewDelay_ = hcalTimeSlewDelay;
       tsDelay1GeV_= hcalTimeSlewDelay->delay(1.0, slewFlavor_);
 
-      resetPulseShapeTemplate(ps);
+      currentTemplates_ = findPulseShapeTemplates(ps);
+      if (!currentTemplates_) resetPulseShapeTemplate(ps);
       currentPulseShape_ = &ps;
     }
+
+  if (currentTemplates_->table != table) {
+    currentTemplates_->table = table;
+    currentTemplates_->psfPtr->setPulseShapeTable(table);
+    currentTemplates_->templates.fill(PulseTemplate());
+  }
+}
+
+MahiFit::PulseShapeTemplates* MahiFit::findPulseShapeTemplates(const HcalPulseShapes::Shape& ps) const {
+  auto it = std::find_if(pulseShapeTemplates_.begin(), pulseShapeTemplates_.end(),
+			 [&ps](const std::unique_ptr<PulseShapeTemplates>& t){ return t->shape==&ps; });
+  return it!=pulseShapeTemplates_.end() ? it->get() : nullptr;
 }
 
 void MahiFit::resetPulseShapeTemplate(const HcalPulseShapes::Shape& ps) { 
   ++ cntsetPulseShape_;
 
+  currentTemplates_ = findPulseShapeTemplates(ps);
+  if (!currentTemplates_) {
+    pulseShapeTemplates_.emplace_back(std::make_unique<PulseShapeTemplates>());
+    currentTemplates_ = pulseShapeTemplates_.back().get();
+  }
+  currentTemplates_->shape = &ps;
+  currentTemplates_->table = nullptr;
+  currentTemplates_->templates.fill(PulseTemplate());
+
   // only the pulse shape itself from PulseShapeFunctor is used for Mahi
   // the uncertainty terms calculated inside PulseShapeFunctor are used for Method 2 only
-  psfPtr_.reset(new FitterFuncs::PulseShapeFunctor(ps,false,false,false,
-						   1,0,0,10));
-  pfunctor_ = std::unique_ptr<ROOT::Math::Functor>( new ROOT::Math::Functor(psfPtr_.get(),&FitterFuncs::PulseShapeFunctor::singlePulseShapeFunc, 3) );
+  currentTemplates_->psfPtr.reset(new FitterFuncs::PulseShapeFunctor(ps,false,false,false,
+								     1,0,0,10));
+  currentTemplates_->pfunctor = std::unique_ptr<ROOT::Math::Functor>( new ROOT::Math::Functor(currentTemplates_->psfPtr.get(),&FitterFuncs::PulseShapeFunctor::singlePulseShapeFunc, 3) );
 
 
 }
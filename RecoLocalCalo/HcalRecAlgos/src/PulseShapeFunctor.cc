@@ -2,6 +2,7 @@
 #include <cmath>
 #include <climits>
 #include "RecoLocalCalo/HcalRecAlgos/interface/PulseShapeFunctor.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/HcalPulseShapeLookup.h"
 #include "FWCore/Utilities/interface/isFinite.h"
 
 namespace FitterFuncs{
@@ -57,9 +58,15 @@ namespace FitterFuncs{
 
     nSamplesToFit_ = nSamplesToFit;
 
+    pulseShapeTable_ = nullptr;
+
   }
 
   void PulseShapeFunctor::funcShape(std::array<double,HcalConst::maxSamples> & ntmpbin, const double pulseTime, const double pulseHeight,const double slew) {
+    if( pulseShapeTable_ && pulseShapeTable_->inRange(pulseTime+slew) ){
+      pulseShapeTable_->fill(ntmpbin, pulseTime+slew, pulseHeight);
+      return;
+    }
     // pulse shape components over a range of time 0 ns to 255 ns in 1 ns steps
     constexpr int ns_per_bx = HcalConst::nsPerBX;
     constexpr int num_ns = HcalConst::nsPerBX*HcalConst::maxSamples;
@@ -73,7 +80,7 @@ namespace FitterFuncs{
     if( edm::isNotFinite(offset_start) ){ //Check for nan
       ++ cntNANinfit;
     }else{
-      if( offset_start == 1.0 ){ offset_start = 0.; i_start-=1; } //Deal with boundary
+      if( offset_start == 1.0 && i_start > 0 ){ offset_start = 0.; i_start-=1; } //Deal with boundary (not before the first bin)
 
       const int bin_start        = (int) offset_start; //bin off to integer
       const int bin_0_start      = ( offset_start < bin_start + 0.5 ? bin_start -1 : bin_start ); //Round it
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cassert>
 
 #include "CalibCalorimetry/HcalAlgos/interface/HcalTimeSlew.h"
 
@@ -10,6 +11,7 @@
 #include "DataFormats/HcalRecHit/interface/HBHERecHitAuxSetter.h"
 #include "DataFormats/METReco/interface/HcalPhase1FlagLabels.h"
 #include "CondFormats/DataRecord/interface/HcalTimeSlewRecord.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/HcalPulseShapeLookupRcd.h"
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/Framework/interface/ESHandle.h"
 
@@ -35,7 +37,8 @@ SimpleHBHEPhase1Algo::SimpleHBHEPhase1Algo(
       corrFPC_(correctForPhaseContainment),
       psFitOOTpuCorr_(std::move(m2)),
       hltOOTpuCorr_(std::move(detFit)),
-      mahiOOTpuCorr_(std::move(mahi))
+      mahiOOTpuCorr_(std::move(mahi)),
+      pulseShapeLookup_(nullptr)
 {
   hcalTimeSlew_delay_ = nullptr;
 }
@@ -46,6 +49,14 @@ void SimpleHBHEPhase1Algo::beginRun(const edm::Run& r,
     edm::ESHandle<HcalTimeSlew> delay;
     es.get<HcalTimeSlewRecord>().get("HBHE", delay);
     hcalTimeSlew_delay_ = &*delay;
+
+    pulseShapeLookup_ = nullptr;
+    if (auto rec = es.tryToGet<HcalPulseShapeLookupRcd>())
+    {
+        edm::ESHandle<HcalPulseShapeLookup> lookup;
+        rec->get(lookup);
+        pulseShapeLookup_ = &*lookup;
+    }
   
     runnum_ = r.run();
     pulseCorr_.beginRun(es);
@@ -80,6 +91,9 @@ HBHERecHit SimpleHBHEPhase1Algo::reconstruct(const HBHEChannelInfo& info,
         m0t = m0Time(info, fc_ampl, calibs, nSamplesToAdd);
     }
 
+    const HcalPulseShapeTable* psTable = pulseShapeLookup_ ?
+        pulseShapeLookup_->table(info.recoShape()) : nullptr;
+
     // Run "Method 2"
     float m2t = 0.f, m2E = 0.f, chi2 = -1.f;
     bool useTriple = false;
@@ -87,7 +101,8 @@ HBHERecHit SimpleHBHEPhase1Algo::reconstruct(const HBHEChannelInfo& info,
     if (method2)
     {
         psFitOOTpuCorr_->setPulseShapeTemplate(theHcalPulseShapes_.getShape(info.recoShape()),
-                                               !info.hasTimeInfo(),info.nSamples(),hcalTimeSlew_delay_);
+                                               !info.hasTimeInfo(),info.nSamples(),hcalTimeSlew_delay_,
+                                               psTable);
         // "phase1Apply" call below sets m2E, m2t, useTriple, and chi2.
         // These parameters are pased by non-const reference.
         method2->phase1Apply(info, m2E, m2t, useTriple, chi2);
@@ -112,7 +127,7 @@ HBHERecHit SimpleHBHEPhase1Algo::reconstruct(const HBHEChannelInfo& info,
     const MahiFit* mahi = mahiOOTpuCorr_.get();
 
     if (mahi) {
-      mahiOOTpuCorr_->setPulseShapeTemplate(theHcalPulseShapes_.getShape(info.recoShape()),hcalTimeSlew_delay_);
+      mahiOOTpuCorr_->setPulseShapeTemplate(theHcalPulseShapes_.getShape(info.recoShape()),hcalTimeSlew_delay_,psTable);
       mahi->phase1Apply(info,m4E,m4T,m4UseTriple,m4chi2);
       m4E *= hbminusCorrectionFactor(channelId, m4E, isData);
     }
@@ -156,6 +171,29 @@ HBHERecHit SimpleHBHEPhase1Algo::reconstruct(const HBHEChannelInfo& info,
     return rh;
 }
 
+void SimpleHBHEPhase1Algo::reconstruct(const HBHEChannelInfoCollection& infos,
+                                       const std::vector<const HcalRecoParam*>& params,
+                                       const std::vector<const HcalCalibrations*>& calibs,
+                                       const bool isRealData,
+                                       std::vector<HBHERecHit>* rechits)
+{
+    assert(calibs.size() == infos.size());
+    assert(params.empty() || params.size() == infos.size());
+
+    const unsigned n = infos.size();
+    std::vector<unsigned> order(n);
+    for (unsigned i=0; i<n; ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&infos](const unsigned i, const unsigned j)
+                     {return infos[i].recoShape() < infos[j].recoShape();});
+
+    rechits->resize(n);
+    for (const unsigned i : order)
+        (*rechits)[i] = reconstruct(infos[i], params.empty() ? nullptr : params[i],
+                                    *calibs[i], isRealData);
+}
+
 float SimpleHBHEPhase1Algo::hbminusCorrectionFactor(const HcalDetId& cell,
                                                     const float energy,
                                                     const bool isRealData) const
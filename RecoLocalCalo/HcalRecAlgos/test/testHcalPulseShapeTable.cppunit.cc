@@ -0,0 +1,108 @@
+/* Unit test for HcalPulseShapeTable: over the tabulated range, its inRange edges
+   included, the table must give the binned pulse shape integrated by
+   PulseShapeFunctor::funcShape, and the functor must fall back to the
+   integration outside of it
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "CalibCalorimetry/HcalAlgos/interface/HcalPulseShapes.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/HcalPulseShapeLookup.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/PulseShapeFunctor.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+class testHcalPulseShapeTable: public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(testHcalPulseShapeTable);
+  CPPUNIT_TEST(testInRange);
+  CPPUNIT_TEST(testOutOfRange);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+
+  void testInRange();
+  void testOutOfRange();
+
+private:
+  typedef HcalPulseShapeTable::Samples Samples;
+
+  // the shapes tabulated by default by HcalPulseShapeLookupESProducer
+  const std::vector<int> shapeIds_ = {105, 123, 125, 201, 203, 205, 206, 207};
+
+  // the table is affine between the knots where the functor is affine up to
+  // rounding (its accumulated shapes are single precision, the pulse time double)
+  static constexpr double tolerance_ = 1.e-12;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testHcalPulseShapeTable);
+
+namespace {
+  FitterFuncs::PulseShapeFunctor makeFunctor(const HcalPulseShapes::Shape& shape) {
+    return FitterFuncs::PulseShapeFunctor(shape, false, false, false, 1, 0, 0, HcalConst::maxSamples);
+  }
+}
+
+void testHcalPulseShapeTable::testInRange() {
+  const double tMin = HcalPulseShapeTable::tMin, tMax = HcalPulseShapeTable::tMax, tStep = HcalPulseShapeTable::tStep;
+  constexpr double inf = std::numeric_limits<double>::infinity();
+
+  // the range edges, every knot, interval centre and quarter point, each knot
+  // approached from both sides, and random times
+  std::vector<double> times{tMin, std::nextafter(tMin, inf), std::nextafter(tMax, -inf), tMax - 1.e-9};
+  for (int i=0; i<HcalPulseShapeTable::nIntervals; ++i) {
+    const double knot = tMin + i*tStep;
+    for (double dt : {0., 0.25*tStep, 0.5*tStep, 0.75*tStep, 1.e-9, tStep - 1.e-9}) times.push_back(knot + dt);
+    if (i > 0) times.push_back(std::nextafter(knot, -inf));
+  }
+  std::mt19937 rng(33);
+  std::uniform_real_distribution<double> flat(tMin, tMax);
+  for (int i=0; i<20000; ++i) times.push_back(flat(rng));
+
+  const HcalPulseShapes shapes;
+  const double height = 37.5;
+  for (int id : shapeIds_) {
+    const HcalPulseShapeTable table(shapes.getShape(id));
+    auto integrated = makeFunctor(shapes.getShape(id));
+    auto tabulated = makeFunctor(shapes.getShape(id));
+    tabulated.setPulseShapeTable(&table);
+
+    Samples reference, fromTable, fromFunctor;
+    for (double t : times) {
+      CPPUNIT_ASSERT(table.inRange(t));
+      integrated.computePulseShape(reference, t);
+      table.fill(fromTable, t, height);
+      tabulated.computePulseShape(fromFunctor, t);
+      for (int j=0; j<HcalConst::maxSamples; ++j) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(height*reference[j], fromTable[j], height*tolerance_);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(reference[j], fromFunctor[j], tolerance_);
+      }
+    }
+  }
+}
+
+void testHcalPulseShapeTable::testOutOfRange() {
+  const double tMin = HcalPulseShapeTable::tMin, tMax = HcalPulseShapeTable::tMax;
+  constexpr double inf = std::numeric_limits<double>::infinity();
+
+  const HcalPulseShapes shapes;
+  for (int id : shapeIds_) {
+    const HcalPulseShapeTable table(shapes.getShape(id));
+    auto integrated = makeFunctor(shapes.getShape(id));
+    auto tabulated = makeFunctor(shapes.getShape(id));
+    tabulated.setPulseShapeTable(&table);
+
+    Samples reference, fromFunctor;
+    for (double t : {std::nextafter(tMin, -inf), tMin - 1.e-9, tMin - 0.5, tMax, tMax + 1.e-9, tMax + 5.}) {
+      CPPUNIT_ASSERT(!table.inRange(t));
+      integrated.computePulseShape(reference, t);
+      tabulated.computePulseShape(fromFunctor, t);
+      for (int j=0; j<HcalConst::maxSamples; ++j) CPPUNIT_ASSERT_EQUAL(reference[j], fromFunctor[j]);
+    }
+  }
+}
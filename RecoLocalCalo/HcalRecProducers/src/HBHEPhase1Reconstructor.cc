@@ -21,6 +21,7 @@
 #include <cmath>
 #include <utility>
 #include <algorithm>
+#include <vector>
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
@@ -444,6 +445,21 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
     // not going to be constructed from such channels.
     const bool skipDroppedChannels = !(infos && saveDroppedInfos_);
 
+    // The rechits are reconstructed together once all the channel
+    // infos are filled, and then flagged in the order of the input.
+    // These are parallel to "recoInfos".
+    HBHEChannelInfoCollection recoInfos;
+    std::vector<const HcalRecoParam*> recoParams;
+    std::vector<const HcalCalibrations*> recoCalibs;
+    std::vector<typename Collection::const_iterator> recoFrames;
+    if (rechits)
+    {
+        recoInfos.reserve(coll.size());
+        recoParams.reserve(coll.size());
+        recoCalibs.reserve(coll.size());
+        recoFrames.reserve(coll.size());
+    }
+
     // Iterate over the input collection
     for (typename Collection::const_iterator it = coll.begin();
          it != coll.end(); ++it)
@@ -538,19 +554,38 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
         if (infos && (saveDroppedInfos_ || makeThisRechit))
             infos->push_back(*channelInfo);
 
-        // Reconstruct the rechit
+        // Remember the channel for the rechit reconstruction
         if (rechits && makeThisRechit)
         {
-            const HcalRecoParam* pptr = nullptr;
-            if (recoParamsFromDB_)
-                pptr = param_ts;
-            HBHERecHit rh = reco_->reconstruct(*channelInfo, pptr, calib, isRealData);
-            if (rh.id().rawId())
-            {
-                setAsicSpecificBits(frame, coder, *channelInfo, calib, &rh);
-                setCommonStatusBits(*channelInfo, calib, &rh);
-                rechits->push_back(rh);
-            }
+            recoInfos.push_back(*channelInfo);
+            recoParams.push_back(recoParamsFromDB_ ? param_ts : nullptr);
+            recoCalibs.push_back(&calib);
+            recoFrames.push_back(it);
+        }
+    }
+
+    if (!rechits || recoInfos.empty())
+        return;
+
+    // Reconstruct the rechits
+    std::vector<HBHERecHit> recoHits;
+    reco_->reconstruct(recoInfos, recoParams, recoCalibs, isRealData, &recoHits);
+
+    // Set the flags and fill the output collection
+    const unsigned nReco = recoInfos.size();
+    for (unsigned i=0; i<nReco; ++i)
+    {
+        HBHERecHit& rh = recoHits[i];
+        if (rh.id().rawId())
+        {
+            const DFrame& frame(*recoFrames[i]);
+            const HcalDetId cell(frame.id());
+            const HcalQIECoder* channelCoder = cond.getHcalCoder(cell);
+            const HcalQIEShape* shape = cond.getHcalShape(channelCoder);
+            const HcalCoderDb coder(*channelCoder, *shape);
+            setAsicSpecificBits(frame, coder, recoInfos[i], *recoCalibs[i], &rh);
+            setCommonStatusBits(recoInfos[i], *recoCalibs[i], &rh);
+            rechits->push_back(rh);
         }
     }
 }
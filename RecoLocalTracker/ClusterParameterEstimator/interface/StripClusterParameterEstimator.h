@@ -34,6 +34,11 @@ class StripClusterParameterEstimator
   virtual void localParameters(AClusters const & clusters, ALocalValues & retValues, const GeomDetUnit& gd, const LocalTrajectoryParameters & ltp) const {
   }
 
+  // all the clusters of one det without track information (local reconstruction)
+  virtual void localParameters(AClusters const & clusters, ALocalValues & retValues, const GeomDetUnit& gd) const {
+    for (auto i=0U; i< clusters.size(); ++i) retValues[i] = localParameters(*clusters[i],gd);
+  }
+
   
   virtual LocalValues localParameters( const SiStripCluster&,const GeomDetUnit&) const {
       return std::make_pair(LocalPoint(), LocalError());
@@ -0,0 +1,241 @@
+/** SiPixelRawToClusterProducer.cc
+ * ---------------------------------------------------------------
+ * Description: pixel raw data to clusters in one module, i.e.
+ * SiPixelRawToDigi followed by SiPixelClusterProducer without the
+ * intermediate DetSetVector<PixelDigi> (optionally still produced).
+ * The digis of all the FEDs are unpacked into a flat PixelDigiBuffer,
+ * then each module is gathered once (in the unpacking order, so the
+ * clusters are the same as in the two-step chain) and clusterized.
+ * Unpacking errors are not stored: use SiPixelRawToDigi for them.
+ * With a non-empty Regions.inputs only the modules (and FEDs) touched
+ * by the TrackingRegions of the event are unpacked and clusterized.
+ * ---------------------------------------------------------------
+ */
+
+#include "PixelThresholdClusterizer.h"
+
+#include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationService.h"
+#include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationOfflineService.h"
+#include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationForHLTService.h"
+#include "CondFormats/DataRecord/interface/SiPixelFedCablingMapRcd.h"
+#include "CondFormats/DataRecord/interface/SiPixelQualityRcd.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingMap.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingTree.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelQuality.h"
+#include "DataFormats/Common/interface/DetSetVector.h"
+#include "DataFormats/Common/interface/DetSetVectorNew.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
+#include "DataFormats/SiPixelCluster/interface/SiPixelCluster.h"
+#include "DataFormats/SiPixelDigi/interface/PixelDigi.h"
+#include "DataFormats/TrackerCommon/interface/TrackerTopology.h"
+#include "EventFilter/SiPixelRawToDigi/interface/PixelDataFormatter.h"
+#include "EventFilter/SiPixelRawToDigi/interface/PixelDigiBuffer.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/ESTransientHandle.h"
+#include "FWCore/Framework/interface/ESWatcher.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/stream/EDProducer.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "Geometry/Records/interface/TrackerDigiGeometryRecord.h"
+#include "Geometry/Records/interface/TrackerTopologyRcd.h"
+#include "Geometry/TrackerGeometryBuilder/interface/PixelGeomDetUnit.h"
+#include "Geometry/TrackerGeometryBuilder/interface/TrackerGeometry.h"
+#include "RecoTracker/TkTrackingRegions/interface/TrackingRegionModuleSelector.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class SiPixelRawToClusterProducer final : public edm::stream::EDProducer<> {
+public:
+  explicit SiPixelRawToClusterProducer(const edm::ParameterSet& conf);
+  ~SiPixelRawToClusterProducer() override = default;
+
+  void produce(edm::Event& ev, const edm::EventSetup& es) override;
+
+private:
+  edm::EDGetTokenT<FEDRawDataCollection> tFEDRawDataCollection_;
+
+  const std::string cablingMapLabel_;
+  const bool useQuality_;
+  const bool usePilotBlade_;
+  const bool usePhase1_;
+  const bool produceDigis_;
+  const int32_t maxTotalClusters_;
+
+  std::unique_ptr<SiPixelFedCablingTree> cabling_;
+  std::vector<unsigned int> fedIds_;
+  std::unordered_map<uint32_t, unsigned int> det2fed_;
+  const SiPixelQuality* badPixelInfo_ = nullptr;
+  edm::ESWatcher<SiPixelFedCablingMapRcd> recordWatcher_;
+  edm::ESWatcher<SiPixelQualityRcd> qualityWatcher_;
+
+  std::unique_ptr<SiPixelGainCalibrationServiceBase> gainCalibration_;
+  std::unique_ptr<PixelThresholdClusterizer> clusterizer_;
+
+  // regional unpacking
+  std::unique_ptr<TrackingRegionModuleSelector> regions_;
+  std::set<unsigned int> modulesToUnpack_;
+  std::set<unsigned int> fedsToUnpack_;
+
+  // per-event scratch, kept to reuse the allocations
+  PixelDigiBuffer digiBuffer_;
+  edm::DetSet<PixelDigi> moduleDigis_;
+};
+
+SiPixelRawToClusterProducer::SiPixelRawToClusterProducer(const edm::ParameterSet& conf)
+  : tFEDRawDataCollection_(consumes<FEDRawDataCollection>(conf.getParameter<edm::InputTag>("InputLabel"))),
+    cablingMapLabel_(conf.getParameter<std::string>("CablingMapLabel")),
+    useQuality_(conf.getParameter<bool>("UseQualityInfo")),
+    usePilotBlade_(conf.getParameter<bool>("UsePilotBlade")),
+    usePhase1_(conf.getParameter<bool>("UsePhase1")),
+    produceDigis_(conf.getParameter<bool>("produceDigis")),
+    maxTotalClusters_(conf.getParameter<int32_t>("maxNumberOfClusters"))
+{
+  produces<SiPixelClusterCollectionNew>();
+  if (produceDigis_) produces<edm::DetSetVector<PixelDigi>>();
+
+  const auto& payloadType = conf.getParameter<std::string>("payloadType");
+  if (payloadType=="HLT")
+    gainCalibration_ = std::make_unique<SiPixelGainCalibrationForHLTService>(conf);
+  else if (payloadType=="Offline")
+    gainCalibration_ = std::make_unique<SiPixelGainCalibrationOfflineService>(conf);
+  else if (payloadType=="Full")
+    gainCalibration_ = std::make_unique<SiPixelGainCalibrationService>(conf);
+  else
+    throw cms::Exception("Configuration") << "[SiPixelRawToClusterProducer]: invalid payloadType " << payloadType;
+
+  clusterizer_ = std::make_unique<PixelThresholdClusterizer>(conf);
+  clusterizer_->setSiPixelGainCalibrationService(gainCalibration_.get());
+
+  if (conf.exists("Regions")) {
+    const auto& regionsConf = conf.getParameter<edm::ParameterSet>("Regions");
+    if (!regionsConf.getParameter<std::vector<edm::InputTag>>("inputs").empty())
+      regions_ = std::make_unique<TrackingRegionModuleSelector>(regionsConf, consumesCollector());
+  }
+}
+
+void SiPixelRawToClusterProducer::produce(edm::Event& ev, const edm::EventSetup& es)
+{
+  // initialize cabling map or update if necessary (as in SiPixelRawToDigi)
+  if (recordWatcher_.check(es)) {
+    edm::ESTransientHandle<SiPixelFedCablingMap> cablingMap;
+    es.get<SiPixelFedCablingMapRcd>().get(cablingMapLabel_, cablingMap);
+    fedIds_  = cablingMap->fedIds();
+    cabling_ = cablingMap->cablingTree();
+    det2fed_ = cablingMap->det2fedMap();
+    LogDebug("map version:") << cabling_->version();
+  }
+  if (qualityWatcher_.check(es) && useQuality_) {
+    edm::ESHandle<SiPixelQuality> qualityInfo;
+    es.get<SiPixelQualityRcd>().get(qualityInfo);
+    badPixelInfo_ = qualityInfo.product();
+    if (!badPixelInfo_) {
+      edm::LogError("SiPixelQualityNotPresent") << " Configured to use SiPixelQuality, but SiPixelQuality not present";
+    }
+  }
+
+  gainCalibration_->setESObjects(es);
+
+  edm::ESHandle<TrackerGeometry> geom;
+  es.get<TrackerDigiGeometryRecord>().get(geom);
+  edm::ESHandle<TrackerTopology> trackerTopologyHandle;
+  es.get<TrackerTopologyRcd>().get(trackerTopologyHandle);
+  const TrackerTopology* tTopo = trackerTopologyHandle.product();
+
+  edm::Handle<FEDRawDataCollection> buffers;
+  ev.getByToken(tFEDRawDataCollection_, buffers);
+
+  // Step A: unpack the FEDs (those of the regions, if any)
+  PixelDataFormatter formatter(cabling_.get(), usePhase1_);
+  formatter.setErrorStatus(false);
+  if (useQuality_) formatter.setQualityStatus(useQuality_, badPixelInfo_);
+
+  bool regional = false;
+  if (regions_) {
+    regions_->run(ev, es);
+    regional = !regions_->all();
+    if (regional) {
+      modulesToUnpack_.clear();
+      fedsToUnpack_.clear();
+      for (auto id : regions_->pixelModules()) {
+	auto fed = det2fed_.find(id);
+	if (fed == det2fed_.end()) continue;
+	modulesToUnpack_.insert(id);
+	fedsToUnpack_.insert(fed->second);
+      }
+      formatter.setModulesToUnpack(&modulesToUnpack_);
+      LogDebug("SiPixelRawToClusterProducer") << "regions: " << regions_->nRegions()
+					      << " #feds: " << fedsToUnpack_.size() << "/" << fedIds_.size()
+					      << " #modules: " << modulesToUnpack_.size() << "/" << regions_->nPixelModulesTotal();
+    }
+  }
+
+  digiBuffer_.clear();
+  bool errorsInEvent = false;
+  for (auto fedId : fedIds_) {
+    if (!usePilotBlade_ && (fedId==40)) continue; // skip pilot blade data
+    if (regional && !fedsToUnpack_.count(fedId)) continue;
+    PixelDataFormatter::Errors errors;
+    formatter.interpretRawData(errorsInEvent, fedId, buffers->FEDData(fedId), digiBuffer_, errors);
+  }
+  digiBuffer_.sortRuns();
+  if (errorsInEvent) LogDebug("SiPixelRawToClusterProducer") << "Error words found in this event";
+
+  // Step B: gather and clusterize module by module, in DetId order
+  auto output = std::make_unique<SiPixelClusterCollectionNew>();
+  std::vector<edm::DetSet<PixelDigi>> digis;
+  int numberOfClusters = 0;
+  auto const& runs = digiBuffer_.runs();
+  for (auto b = runs.begin(); b != runs.end(); ) {
+    auto e = digiBuffer_.moduleEnd(b);
+    moduleDigis_.id = b->rawId;
+    moduleDigis_.data.clear();
+    digiBuffer_.fill(moduleDigis_, b, e);
+    b = e;
+
+    const PixelGeomDetUnit* pixDet = dynamic_cast<const PixelGeomDetUnit*>(geom->idToDetUnit(DetId(moduleDigis_.id)));
+    if (!pixDet) {
+      throw cms::Exception("InvalidDetId") << "[SiPixelRawToClusterProducer]: " << moduleDigis_.id << " is not a pixel module";
+    }
+    std::vector<short> badChannels;
+    {
+      edmNew::DetSetVector<SiPixelCluster>::FastFiller spc(*output, moduleDigis_.id);
+      clusterizer_->clusterizeDetUnit(moduleDigis_, pixDet, tTopo, badChannels, spc);
+      if (spc.empty()) {
+	spc.abort();
+      } else {
+	numberOfClusters += spc.size();
+      }
+    }
+    if (produceDigis_) digis.push_back(moduleDigis_);
+
+    if ((maxTotalClusters_ >= 0) && (numberOfClusters > maxTotalClusters_)) {
+      edm::LogError("TooManyClusters") << "Limit on the number of clusters exceeded. An empty cluster collection will be produced instead.\n";
+      SiPixelClusterCollectionNew empty;
+      empty.swap(*output);
+      // the digis are still complete
+      if (produceDigis_) {
+	for (b = e; b != runs.end(); b = e) {
+	  e = digiBuffer_.moduleEnd(b);
+	  digis.emplace_back(b->rawId);
+	  digiBuffer_.fill(digis.back(), b, e);
+	}
+      }
+      break;
+    }
+  }
+
+  output->shrink_to_fit();
+  ev.put(std::move(output));
+  if (produceDigis_) ev.put(std::make_unique<edm::DetSetVector<PixelDigi>>(digis, true));
+}
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+DEFINE_FWK_MODULE(SiPixelRawToClusterProducer);
@@ -0,0 +1,28 @@
+import FWCore.ParameterSet.Config as cms
+
+# pixel raw data to clusters in one step (siPixelDigis + siPixelClusters without the errors)
+from RecoLocalTracker.SiPixelClusterizer.SiPixelClusterizer_cfi import siPixelClusters as _siPixelClusters
+_clusterizerParameters = _siPixelClusters.parameters_()
+del _clusterizerParameters['src']
+
+siPixelRawToClusters = cms.EDProducer("SiPixelRawToClusterProducer",
+    InputLabel = cms.InputTag("siPixelRawData"),
+    CablingMapLabel = cms.string(""),
+    UseQualityInfo = cms.bool(False),
+    UsePilotBlade = cms.bool(False),
+    UsePhase1 = cms.bool(False),
+    produceDigis = cms.bool(False),
+    # empty inputs means complete unpacking
+    Regions = cms.PSet(
+        inputs = cms.VInputTag(),
+        extraEta = cms.double(0.),
+        extraPhi = cms.double(0.)
+    ),
+    **_clusterizerParameters
+)
+
+# the clusterizer parameters above are taken from siPixelClusters after its
+# phase1Pixel modifications (SiPixelClusterizer_cfi); only the unpacker
+# switch is set here, as for siPixelDigis
+from Configuration.Eras.Modifier_phase1Pixel_cff import phase1Pixel
+phase1Pixel.toModify(siPixelRawToClusters, UsePhase1 = True)
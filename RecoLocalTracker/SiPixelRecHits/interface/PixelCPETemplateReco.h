@@ -72,9 +72,15 @@ private:
    // However, we do need to implement localError().
    LocalError localError   (DetParam const & theDetParam, ClusterParam & theClusterParam) const override;
    
+   // The interpolated template kept by the current thread for template ID
+   SiPixelTemplate & threadTemplate(int ID) const;
+   
    // Template storage
    std::vector< SiPixelTemplateStore > thePixelTemp_;
    
+   // Identifies our templates in the per-thread cache
+   const unsigned int templateCacheId_;
+   
    int speed_ ;
    
    bool UseClusterSplitter_;
@@ -256,7 +256,7 @@ struct SiPixelTemplateStore { //!< template storage structure
 // ******************************************************************************************
 class SiPixelTemplate {
 public:
-   SiPixelTemplate(const std::vector< SiPixelTemplateStore > & thePixelTemp) : thePixelTemp_(thePixelTemp) { id_current_ = -1; index_id_ = -1; cota_current_ = 0.; cotb_current_ = 0.; } //!< Constructor for cases in which template store already exists
+   SiPixelTemplate(const std::vector< SiPixelTemplateStore > & thePixelTemp) : thePixelTemp_(thePixelTemp) { id_current_ = -1; index_id_ = -1; cota_current_ = 0.; cotb_current_ = 0.; locBz_current_ = 0.; locBx_current_ = 0.; ybins_current_ = -1; xbins_current_ = -1; } //!< Constructor for cases in which template store already exists
    
 
 // Load the private store with info from the file with the index (int) filenum from directory dir:
@@ -553,6 +553,10 @@ private:
    int index_id_;             //!< current index
    float cota_current_;       //!< current cot alpha
    float cotb_current_;       //!< current cot beta
+   float locBz_current_;      //!< current z-component of the field (sets the flips)
+   float locBx_current_;      //!< current x-component of the field (sets the flips)
+   int ybins_current_;        //!< template y-entries (and flips) of the copied y-parameters
+   int xbins_current_;        //!< template x-entries (and flip) of the copied x-parameters
    float abs_cotb_;           //!< absolute value of cot beta
    bool success_;             //!< true if cotalpha, cotbeta are inside of the acceptance (dynamically loaded)
    
@@ -21,6 +21,8 @@
 
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include "boost/multi_array.hpp"
 
@@ -34,6 +36,17 @@ namespace {
    constexpr float micronsToCm = 1.0e-4;
    constexpr int cluster_matrix_size_x = 13;
    constexpr int cluster_matrix_size_y = 21;
+
+   // The interpolated templates of the current thread, one per template ID, so that
+   // the hits of modules sharing a template reuse the ID lookup and the template
+   // entries copied for the previous hit (SiPixelTemplate::interpolate redoes only
+   // what depends on the new angles). They belong to one CPE (its template store).
+   struct TemplateCache {
+      unsigned int owner = 0;
+      std::vector<std::pair<int, std::unique_ptr<SiPixelTemplate> > > templates;
+   };
+   thread_local TemplateCache templateCache;
+   std::atomic<unsigned int> nTemplateCaches{0};
 }
 
 //-----------------------------------------------------------------------------
@@ -46,7 +59,8 @@ PixelCPETemplateReco::PixelCPETemplateReco(edm::ParameterSet const & conf,
                                            const TrackerTopology& ttopo,
                                            const SiPixelLorentzAngle * lorentzAngle,
                                            const SiPixelTemplateDBObject * templateDBobject)
-: PixelCPEBase(conf, mag, geom, ttopo, lorentzAngle, nullptr, templateDBobject, nullptr,1)
+: PixelCPEBase(conf, mag, geom, ttopo, lorentzAngle, nullptr, templateDBobject, nullptr,1),
+  templateCacheId_(++nTemplateCaches)
 {
    //cout << endl;
    //cout << "Constructing PixelCPETemplateReco::PixelCPETemplateReco(...)................................................." << endl;
@@ -103,6 +117,23 @@ PixelCPETemplateReco::~PixelCPETemplateReco()
    for(auto x : thePixelTemp_) x.destroy();
 }
 
+//-----------------------------------------------------------------------------
+//  The template object of this thread for template ID.
+//-----------------------------------------------------------------------------
+SiPixelTemplate &
+PixelCPETemplateReco::threadTemplate(int ID) const
+{
+   auto & cache = templateCache;
+   if ( cache.owner != templateCacheId_ ) {
+      cache.templates.clear();
+      cache.owner = templateCacheId_;
+   }
+   for ( auto & t : cache.templates )
+      if ( t.first == ID ) return *t.second;
+   cache.templates.emplace_back(ID, std::make_unique<SiPixelTemplate>(thePixelTemp_));
+   return *cache.templates.back().second;
+}
+
 PixelCPEBase::ClusterParam* PixelCPETemplateReco::createClusterParam(const SiPixelCluster & cl) const
 {
    return new ClusterParamTemplate(cl);
@@ -141,7 +172,7 @@ PixelCPETemplateReco::localPosition(DetParam const & theDetParam, ClusterParam &
    }
    //cout << "PixelCPETemplateReco : ID = " << ID << endl;
    
-   SiPixelTemplate templ(thePixelTemp_);
+   SiPixelTemplate & templ = threadTemplate(ID);
    
    // Preparing to retrieve ADC counts from the SiPixeltheClusterParam.theCluster->  In the cluster,
    // we have the following:
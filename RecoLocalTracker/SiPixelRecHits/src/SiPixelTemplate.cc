@@ -93,6 +93,7 @@
 #include <math.h>
 #endif
 #include <algorithm>
+#include <type_traits>
 #include <vector>
 #include "boost/multi_array.hpp"
 #include <iostream>
@@ -1002,17 +1003,17 @@ bool SiPixelTemplate::interpolate(int id, float cotalpha, float cotbeta, float l
    
    // Local variables
    int i, j;
-   int ilow, ihigh, iylow, iyhigh, Ny, Nxx, Nyx, imidy, imaxx;
+   int ilow, ihigh, iylow, iyhigh, Ny, Nxx, Nyx, imidy, imaxx, ybins, xbins;
    float yratio, yxratio, xxratio, sxmax, qcorrect, qxtempcor, symax, chi2xavgone, chi2xminone, cota, cotb, cotalpha0, cotbeta0;
    bool flip_x, flip_y;
    //	std::vector <float> xrms(4), xgsig(4), xrmsc2m(4);
    float chi2xavg[4], chi2xmin[4], chi2xavgc2m[4], chi2xminc2m[4];
    
    
-   // Check to see if interpolation is valid
-   if(id != id_current_ || cotalpha != cota_current_ || cotbeta != cotb_current_) {
+   // Check to see if interpolation is valid (the field direction decides the flips)
+   if(id != id_current_ || cotalpha != cota_current_ || cotbeta != cotb_current_ || locBz != locBz_current_ || locBx != locBx_current_) {
       
-      cota_current_ = cotalpha; cotb_current_ = cotbeta; success_ = true;
+      cota_current_ = cotalpha; cotb_current_ = cotbeta; locBz_current_ = locBz; locBx_current_ = locBx; success_ = true;
       
       if(id != id_current_) {
          
@@ -1181,22 +1182,52 @@ bool SiPixelTemplate::interpolate(int id, float cotalpha, float cotbeta, float l
       clsleny_ = fminf(thePixelTemp_[index_id_].enty[ilow].clsleny, thePixelTemp_[index_id_].enty[ihigh].clsleny);
       qavg_avg_ = (1.f - yratio)*thePixelTemp_[index_id_].enty[ilow].qavg_avg + yratio*thePixelTemp_[index_id_].enty[ihigh].qavg_avg;
       qavg_avg_ *= qcorrect;
-      for(i=0; i<2 ; ++i) {
-         for(j=0; j<5 ; ++j) {
-            // Charge loss switches sides when cot(beta) changes sign
-            if(flip_y) {
-               yparl_[1-i][j] = thePixelTemp_[index_id_].enty[ilow].ypar[i][j];
-               yparh_[1-i][j] = thePixelTemp_[index_id_].enty[ihigh].ypar[i][j];
-            } else {
-               yparl_[i][j] = thePixelTemp_[index_id_].enty[ilow].ypar[i][j];
-               yparh_[i][j] = thePixelTemp_[index_id_].enty[ihigh].ypar[i][j];
+      // The parameters below are plain copies of the two y-entries: skip them if these did not change
+      
+      // the keys hold the entry indices in fields of 64 (y-entries), 32 (x-entries) and 8 (y-slices)
+#ifndef SI_PIXEL_TEMPLATE_USE_BOOST
+      static_assert(std::extent<decltype(SiPixelTemplateStore::enty)>::value <= 64, "too many y-entries for the ybins key");
+      static_assert(std::extent<decltype(SiPixelTemplateStore::entx),1>::value <= 32, "too many x-entries for the xbins key");
+      static_assert(std::extent<decltype(SiPixelTemplateStore::entx)>::value <= 8, "too many y-slices for the xbins key");
+#else
+      assert(Ny <= 64 && Nxx <= 32 && Nyx <= 8);
+#endif
+      
+      ybins = 4*(ilow + 64*index_id_) + 2*flip_y + flip_x;
+      if(ybins != ybins_current_) {
+         ybins_current_ = ybins;
+         
+         for(i=0; i<2 ; ++i) {
+            for(j=0; j<5 ; ++j) {
+               // Charge loss switches sides when cot(beta) changes sign
+               if(flip_y) {
+                  yparl_[1-i][j] = thePixelTemp_[index_id_].enty[ilow].ypar[i][j];
+                  yparh_[1-i][j] = thePixelTemp_[index_id_].enty[ihigh].ypar[i][j];
+               } else {
+                  yparl_[i][j] = thePixelTemp_[index_id_].enty[ilow].ypar[i][j];
+                  yparh_[i][j] = thePixelTemp_[index_id_].enty[ihigh].ypar[i][j];
+               }
+               if(flip_x) {
+                  xparly0_[1-i][j] = thePixelTemp_[index_id_].enty[ilow].xpar[i][j];
+                  xparhy0_[1-i][j] = thePixelTemp_[index_id_].enty[ihigh].xpar[i][j];
+               } else {
+                  xparly0_[i][j] = thePixelTemp_[index_id_].enty[ilow].xpar[i][j];
+                  xparhy0_[i][j] = thePixelTemp_[index_id_].enty[ihigh].xpar[i][j];
+               }
             }
-            if(flip_x) {
-               xparly0_[1-i][j] = thePixelTemp_[index_id_].enty[ilow].xpar[i][j];
-               xparhy0_[1-i][j] = thePixelTemp_[index_id_].enty[ihigh].xpar[i][j];
-            } else {
-               xparly0_[i][j] = thePixelTemp_[index_id_].enty[ilow].xpar[i][j];
-               xparhy0_[i][j] = thePixelTemp_[index_id_].enty[ihigh].xpar[i][j];
+         }
+         
+         for(i=0; i<4; ++i) {
+            for(j=0; j<6 ; ++j) {
+               yflparl_[i][j] = thePixelTemp_[index_id_].enty[ilow].yflpar[i][j];
+               yflparh_[i][j] = thePixelTemp_[index_id_].enty[ihigh].yflpar[i][j];
+               
+               // Since Q_fl is odd under cotbeta, it flips qutomatically, change only even terms
+               
+               if(flip_y && (j == 0 || j == 2 || j == 4)) {
+                  yflparl_[i][j] = - yflparl_[i][j];
+                  yflparh_[i][j] = - yflparh_[i][j];
+               }
             }
          }
       }
@@ -1223,17 +1254,6 @@ bool SiPixelTemplate::interpolate(int id, float cotalpha, float cotbeta, float l
          //	      xrmsc2m[i]=(1.f - yratio)*thePixelTemp_[index_id_].enty[ilow].xrmsc2m[i] + yratio*thePixelTemp_[index_id_].enty[ihigh].xrmsc2m[i];
          chi2xavgc2m[i]=(1.f - yratio)*thePixelTemp_[index_id_].enty[ilow].chi2xavgc2m[i] + yratio*thePixelTemp_[index_id_].enty[ihigh].chi2xavgc2m[i];
          chi2xminc2m[i]=(1.f - yratio)*thePixelTemp_[index_id_].enty[ilow].chi2xminc2m[i] + yratio*thePixelTemp_[index_id_].enty[ihigh].chi2xminc2m[i];
-         for(j=0; j<6 ; ++j) {
-            yflparl_[i][j] = thePixelTemp_[index_id_].enty[ilow].yflpar[i][j];
-            yflparh_[i][j] = thePixelTemp_[index_id_].enty[ihigh].yflpar[i][j];
-            
-            // Since Q_fl is odd under cotbeta, it flips qutomatically, change only even terms
-            
-            if(flip_y && (j == 0 || j == 2 || j == 4)) {
-               yflparl_[i][j] = - yflparl_[i][j];
-               yflparh_[i][j] = - yflparh_[i][j];
-            }
-         }
       }
       
       //// Single pixel cluster probabilities
@@ -1256,13 +1276,19 @@ bool SiPixelTemplate::interpolate(int id, float cotalpha, float cotbeta, float l
          ytemp_[i][1] = 0.f;
          ytemp_[i][BYM2] = 0.f;
          ytemp_[i][BYM1] = 0.f;
-         for(j=0; j<TYSIZE; ++j) {
-            
-            // Flip the basic y-template when the cotbeta is negative
-            
-            if(flip_y) {
+      }
+      
+      // Flip the basic y-template when the cotbeta is negative (test outside of the loops, which then vectorize)
+      
+      if(flip_y) {
+         for(i=0; i<9; ++i) {
+            for(j=0; j<TYSIZE; ++j) {
                ytemp_[8-i][BYM3-j]=(1.f - yratio)*thePixelTemp_[index_id_].enty[ilow].ytemp[i][j] + yratio*thePixelTemp_[index_id_].enty[ihigh].ytemp[i][j];
-            } else {
+            }
+         }
+      } else {
+         for(i=0; i<9; ++i) {
+            for(j=0; j<TYSIZE; ++j) {
                ytemp_[i][j+2]=(1.f - yratio)*thePixelTemp_[index_id_].enty[ilow].ytemp[i][j] + yratio*thePixelTemp_[index_id_].enty[ihigh].ytemp[i][j];
             }
          }
@@ -1340,17 +1366,40 @@ bool SiPixelTemplate::interpolate(int id, float cotalpha, float cotbeta, float l
       sxtwo_ = (1.f - xxratio)*thePixelTemp_[index_id_].entx[0][ilow].sxtwo + xxratio*thePixelTemp_[index_id_].entx[0][ihigh].sxtwo;
       clslenx_ = fminf(thePixelTemp_[index_id_].entx[0][ilow].clslenx, thePixelTemp_[index_id_].entx[0][ihigh].clslenx);
       
-      for(i=0; i<2 ; ++i) {
-         for(j=0; j<5 ; ++j) {
-            // Charge loss switches sides when cot(alpha) changes sign
-            if(flip_x) {
-               xpar0_[1-i][j] = thePixelTemp_[index_id_].entx[imaxx][imidy].xpar[i][j];
-               xparl_[1-i][j] = thePixelTemp_[index_id_].entx[imaxx][ilow].xpar[i][j];
-               xparh_[1-i][j] = thePixelTemp_[index_id_].entx[imaxx][ihigh].xpar[i][j];
-            } else {
-               xpar0_[i][j] = thePixelTemp_[index_id_].entx[imaxx][imidy].xpar[i][j];
-               xparl_[i][j] = thePixelTemp_[index_id_].entx[imaxx][ilow].xpar[i][j];
-               xparh_[i][j] = thePixelTemp_[index_id_].entx[imaxx][ihigh].xpar[i][j];
+      // Same for the plain copies of the x-entries
+      
+      xbins = 2*(ilow + 32*(iylow + 8*index_id_)) + flip_x;
+      if(xbins != xbins_current_) {
+         xbins_current_ = xbins;
+         
+         for(i=0; i<2 ; ++i) {
+            for(j=0; j<5 ; ++j) {
+               // Charge loss switches sides when cot(alpha) changes sign
+               if(flip_x) {
+                  xpar0_[1-i][j] = thePixelTemp_[index_id_].entx[imaxx][imidy].xpar[i][j];
+                  xparl_[1-i][j] = thePixelTemp_[index_id_].entx[imaxx][ilow].xpar[i][j];
+                  xparh_[1-i][j] = thePixelTemp_[index_id_].entx[imaxx][ihigh].xpar[i][j];
+               } else {
+                  xpar0_[i][j] = thePixelTemp_[index_id_].entx[imaxx][imidy].xpar[i][j];
+                  xparl_[i][j] = thePixelTemp_[index_id_].entx[imaxx][ilow].xpar[i][j];
+                  xparh_[i][j] = thePixelTemp_[index_id_].entx[imaxx][ihigh].xpar[i][j];
+               }
+            }
+         }
+         
+         for(i=0; i<4; ++i) {
+            for(j=0; j<6 ; ++j) {
+               xflparll_[i][j] = thePixelTemp_[index_id_].entx[iylow][ilow].xflpar[i][j];
+               xflparlh_[i][j] = thePixelTemp_[index_id_].entx[iylow][ihigh].xflpar[i][j];
+               xflparhl_[i][j] = thePixelTemp_[index_id_].entx[iyhigh][ilow].xflpar[i][j];
+               xflparhh_[i][j] = thePixelTemp_[index_id_].entx[iyhigh][ihigh].xflpar[i][j];
+               // Since Q_fl is odd under cotalpha, it flips qutomatically, change only even terms
+               if(flip_x && (j == 0 || j == 2 || j == 4)) {
+                  xflparll_[i][j] = -xflparll_[i][j];
+                  xflparlh_[i][j] = -xflparlh_[i][j];
+                  xflparhl_[i][j] = -xflparhl_[i][j];
+                  xflparhh_[i][j] = -xflparhh_[i][j];
+               }
             }
          }
       }
@@ -1412,19 +1461,6 @@ bool SiPixelTemplate::interpolate(int id, float cotalpha, float cotbeta, float l
          chi2xminc2m_[i]=((1.f - xxratio)*thePixelTemp_[index_id_].entx[iyhigh][ilow].chi2xminc2m[i] + xxratio*thePixelTemp_[index_id_].entx[iyhigh][ihigh].chi2xminc2m[i]);
          if(thePixelTemp_[index_id_].entx[iyhigh][imidy].chi2xminc2m[i] != 0.f) {chi2xminc2m_[i]=chi2xminc2m_[i]/thePixelTemp_[index_id_].entx[iyhigh][imidy].chi2xminc2m[i]*chi2xminc2m[i];}
          
-         for(j=0; j<6 ; ++j) {
-            xflparll_[i][j] = thePixelTemp_[index_id_].entx[iylow][ilow].xflpar[i][j];
-            xflparlh_[i][j] = thePixelTemp_[index_id_].entx[iylow][ihigh].xflpar[i][j];
-            xflparhl_[i][j] = thePixelTemp_[index_id_].entx[iyhigh][ilow].xflpar[i][j];
-            xflparhh_[i][j] = thePixelTemp_[index_id_].entx[iyhigh][ihigh].xflpar[i][j];
-            // Since Q_fl is odd under cotalpha, it flips qutomatically, change only even terms
-            if(flip_x && (j == 0 || j == 2 || j == 4)) {
-               xflparll_[i][j] = -xflparll_[i][j];
-               xflparlh_[i][j] = -xflparlh_[i][j];
-               xflparhl_[i][j] = -xflparhl_[i][j];
-               xflparhh_[i][j] = -xflparhh_[i][j];
-            }
-         }
       }
       
       
@@ -1458,13 +1494,20 @@ bool SiPixelTemplate::interpolate(int id, float cotalpha, float cotbeta, float l
          xtemp_[i][1] = 0.f;
          xtemp_[i][BXM2] = 0.f;
          xtemp_[i][BXM1] = 0.f;
-         for(j=0; j<TXSIZE; ++j) {
-            //  Take next largest x-slice for the x-template (it reduces bias in the forward direction after irradiation)
-            //		   xtemp_[i][j+2]=(1.f - xxratio)*thePixelTemp_[index_id_].entx[imaxx][ilow].xtemp[i][j] + xxratio*thePixelTemp_[index_id_].entx[imaxx][ihigh].xtemp[i][j];
-            //		   xtemp_[i][j+2]=(1.f - xxratio)*thePixelTemp_[index_id_].entx[iyhigh][ilow].xtemp[i][j] + xxratio*thePixelTemp_[index_id_].entx[iyhigh][ihigh].xtemp[i][j];
-            if(flip_x) {
+      }
+      
+      //  Take next largest x-slice for the x-template (it reduces bias in the forward direction after irradiation)
+      //		   xtemp_[i][j+2]=(1.f - xxratio)*thePixelTemp_[index_id_].entx[imaxx][ilow].xtemp[i][j] + xxratio*thePixelTemp_[index_id_].entx[imaxx][ihigh].xtemp[i][j];
+      //		   xtemp_[i][j+2]=(1.f - xxratio)*thePixelTemp_[index_id_].entx[iyhigh][ilow].xtemp[i][j] + xxratio*thePixelTemp_[index_id_].entx[iyhigh][ihigh].xtemp[i][j];
+      if(flip_x) {
+         for(i=0; i<9; ++i) {
+            for(j=0; j<TXSIZE; ++j) {
                xtemp_[8-i][BXM3-j]=qxtempcor*((1.f - xxratio)*thePixelTemp_[index_id_].entx[iyhigh][ilow].xtemp[i][j] + xxratio*thePixelTemp_[index_id_].entx[iyhigh][ihigh].xtemp[i][j]);
-            } else {
+            }
+         }
+      } else {
+         for(i=0; i<9; ++i) {
+            for(j=0; j<TXSIZE; ++j) {
                xtemp_[i][j+2]=qxtempcor*((1.f - xxratio)*thePixelTemp_[index_id_].entx[iyhigh][ilow].xtemp[i][j] + xxratio*thePixelTemp_[index_id_].entx[iyhigh][ihigh].xtemp[i][j]);
             }
          }
@@ -84,6 +84,28 @@ static const int theVerboseLevel = 2;
 
 using namespace SiPixelTemplateReco;
 
+namespace {
+   // Sums of the chi^2 of one template bin over the pixels [lo,hi]: ssa = sum(sw*t), sa2 = sum(t*t*w2).
+   // They are accumulated in 4 partial sums so that the loop vectorizes (the order of a single float sum can not change).
+   inline void templateSums(const float* sw, const float* w2, const float* t, int lo, int hi, float& ssa, float& sa2)
+   {
+      float s[4] = {0.f, 0.f, 0.f, 0.f}, a[4] = {0.f, 0.f, 0.f, 0.f};
+      int i = lo;
+      for(; i+3 <= hi; i += 4) {
+         for(int k=0; k<4; ++k) {
+            s[k] += sw[i+k]*t[i+k];
+            a[k] += t[i+k]*t[i+k]*w2[i+k];
+         }
+      }
+      for(int k=0; i <= hi; ++i, ++k) {
+         s[k] += sw[i]*t[i];
+         a[k] += t[i]*t[i]*w2[i];
+      }
+      ssa = (s[0]+s[1]) + (s[2]+s[3]);
+      sa2 = (a[0]+a[1]) + (a[2]+a[3]);
+   }
+}
+
 // *************************************************************************************************************************************
 //! Reconstruct the best estimate of the hit position for pixel clusters.
 //! \param         id - (input) identifier of the template to use
@@ -658,12 +680,7 @@ int SiPixelTemplateReco::PixelTempReco2D(int id, float cotalpha, float cotbeta,
    while(deltaj > 0) {
       for(j=jmin; j<=jmax; j+=deltaj) {
          if(chi2ybin[j] < -100.f) {
-            ssa = 0.f;
-            sa2 = 0.f;
-            for(i=fypix-2; i<=lypix+2; ++i) {
-               ssa += ysw[i]*ytemp[j][i];
-               sa2 += ytemp[j][i]*ytemp[j][i]*yw2[i];
-            }
+            templateSums(ysw, yw2, ytemp[j], fypix-2, lypix+2, ssa, sa2);
             rat=ssa/ss2;
             if(rat <= 0.f) {LOGERROR("SiPixelTemplateReco") << "illegal chi2ymin normalization (1) = " << rat << ENDL; rat = 1.;}
             chi2ybin[j]=ss2-2.f*ssa/rat+sa2/(rat*rat);
@@ -832,15 +849,7 @@ int SiPixelTemplateReco::PixelTempReco2D(int id, float cotalpha, float cotbeta,
    while(deltaj > 0) {
       for(j=jmin; j<=jmax; j+=deltaj) {
          if(chi2xbin[j] < -100.f) {
-            ssa = 0.f;
-            sa2 = 0.f;
-            //		     std::cout << j << " ";
-            for(i=fxpix-2; i<=lxpix+2; ++i) {
-               //		        std::cout << xtemp[j][i] << ", ";
-               ssa += xsw[i]*xtemp[j][i];
-               sa2 += xtemp[j][i]*xtemp[j][i]*xw2[i];
-            }
-            //			 std::cout << std::endl;
+            templateSums(xsw, xw2, xtemp[j], fxpix-2, lxpix+2, ssa, sa2);
             rat=ssa/ss2;
             if(rat <= 0.f) {LOGERROR("SiPixelTemplateReco") << "illegal chi2xmin normalization (1) = " << rat << ENDL; rat = 1.;}
             chi2xbin[j]=ss2-2.f*ssa/rat+sa2/(rat*rat);
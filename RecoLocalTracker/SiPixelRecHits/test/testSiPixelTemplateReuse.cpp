@@ -0,0 +1,124 @@
+// SiPixelTemplate::interpolate skips the plain copies of the y- and x-entries when
+// the packed keys of the bracketing entries and flips (ybins_current_, xbins_current_)
+// did not change. On a synthetic store, a template reused across random angles and
+// field signs must give bit-identical results to a new template for each call,
+// for which all the keys miss (the per-hit template of the former CPE).
+
+#include "RecoLocalTracker/SiPixelRecHits/interface/SiPixelTemplate.h"
+
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  // every field of an entry is a 4-byte int or float: fill them with random numbers
+  void fillEntry(SiPixelTemplateEntry& entry, std::mt19937& rng) {
+    static_assert(sizeof(SiPixelTemplateEntry)%sizeof(float) == 0, "unexpected SiPixelTemplateEntry layout");
+    std::uniform_real_distribution<float> flat(0.1f, 1.f);
+    std::vector<float> values(sizeof(SiPixelTemplateEntry)/sizeof(float));
+    for (auto& v : values) v = flat(rng);
+    std::memcpy(&entry, values.data(), sizeof(SiPixelTemplateEntry));
+  }
+
+  SiPixelTemplateStore makeStore(int id, int dtype, std::mt19937& rng) {
+    SiPixelTemplateStore store;
+    std::memset(&store.head, 0, sizeof(store.head));
+    store.head.ID = id;
+    store.head.NTy = 20;
+    store.head.NTyx = 5;
+    store.head.NTxx = 29;
+    store.head.Dtype = dtype;
+    store.head.qscale = 1.f;
+    store.head.s50 = 0.25f;
+    store.head.ss50 = 0.25f;
+    store.head.fbin[0] = 1.5f; store.head.fbin[1] = 1.f; store.head.fbin[2] = 0.85f;
+    store.head.xsize = 100.f; store.head.ysize = 150.f; store.head.zsize = 285.f;
+    for (int i=0; i<store.head.NTy; ++i) {
+      fillEntry(store.enty[i], rng);
+      store.enty[i].cotbeta = 0.3f*i;
+    }
+    for (int j=0; j<store.head.NTyx; ++j) {
+      for (int i=0; i<store.head.NTxx; ++i) {
+        fillEntry(store.entx[j][i], rng);
+        store.entx[j][i].cotbeta = 1.2f*j;
+        store.entx[j][i].cotalpha = -0.5f + i/28.f;
+      }
+    }
+    return store;
+  }
+
+  // everything that depends on the interpolated state
+  std::vector<float> interpolated(SiPixelTemplate& templ, bool success) {
+    std::vector<float> result{float(success),
+        templ.qavg(), templ.pixmax(), templ.symax(), templ.dyone(), templ.syone(), templ.dytwo(), templ.sytwo(),
+        templ.sxmax(), templ.dxone(), templ.sxone(), templ.dxtwo(), templ.sxtwo(), templ.qmin(), templ.clsleny(),
+        templ.clslenx(), templ.yratio(), templ.yxratio(), templ.xxratio(), templ.chi2yavgone(), templ.chi2yminone(),
+        templ.chi2xavgone(), templ.chi2xminone(), templ.mpvvav(), templ.sigmavav(), templ.kappavav(),
+        templ.mpvvav2(), templ.sigmavav2(), templ.kappavav2()};
+
+    float sum[BYSIZE], sig2[BYSIZE];
+    for (int i=0; i<BYSIZE; ++i) sum[i] = 0.1f*(i%7);
+    templ.ysigma2(2, BYM3, 0.2f, sum, sig2);
+    result.insert(result.end(), sig2+2, sig2+BYM2);
+    templ.xsigma2(2, BXM3, 0.2f, sum, sig2);
+    result.insert(result.end(), sig2+2, sig2+BXM2);
+
+    for (int binq=0; binq<4; ++binq) {
+      for (float qfl : {-0.9f, -0.2f, 0.f, 0.4f, 1.f}) {
+        result.push_back(templ.yflcorr(binq, qfl));
+        result.push_back(templ.xflcorr(binq, qfl));
+      }
+    }
+
+    static float ytemplate[41][BYSIZE], xtemplate[41][BXSIZE];
+    templ.ytemp(0, 40, ytemplate);
+    templ.xtemp(0, 40, xtemplate);
+    result.insert(result.end(), &ytemplate[0][0], &ytemplate[0][0] + 41*BYSIZE);
+    result.insert(result.end(), &xtemplate[0][0], &xtemplate[0][0] + 41*BXSIZE);
+    return result;
+  }
+
+}
+
+int main() {
+  std::mt19937 rng(2018);
+  std::vector<SiPixelTemplateStore> store;
+  // barrel (flip from the sign of cot(beta)) and phase-1 forward (flips from the field)
+  store.push_back(makeStore(40, 0, rng));
+  store.push_back(makeStore(41, 2, rng));
+  SiPixelTemplate::postInit(store);
+
+  SiPixelTemplate reused(store);
+  std::uniform_int_distribution<int> bin(0, 4);
+  std::uniform_real_distribution<float> flat(-1.f, 1.f);
+  unsigned int failures = 0;
+  float cotalpha = 0.f, cotbeta = 0.f;
+  for (unsigned int i=0; i<20000; ++i) {
+    int id = 40 + i/100%2;
+    // mostly a few nearby angles, so that the keys often hit
+    if (i%3 != 0) {
+      cotalpha = 0.02f*bin(rng) - 0.04f + (i%5==0 ? 0.f : 0.001f*flat(rng));
+      cotbeta = (i%2 ? 1.f : -1.f)*(0.3f*bin(rng) + 0.1f*flat(rng));
+    } else if (i%6 == 0) {
+      cotalpha = 0.7f*flat(rng);
+      cotbeta = 7.f*flat(rng);
+    }
+    float locBz = flat(rng) < 0.f ? -3.8f : 3.8f;
+    float locBx = flat(rng) < 0.f ? -0.2f : 0.2f;
+
+    SiPixelTemplate fresh(store);
+    bool successReused = reused.interpolate(id, cotalpha, cotbeta, locBz, locBx);
+    bool successFresh = fresh.interpolate(id, cotalpha, cotbeta, locBz, locBx);
+    auto r = interpolated(reused, successReused);
+    auto f = interpolated(fresh, successFresh);
+    if (r.size() != f.size() || std::memcmp(r.data(), f.data(), r.size()*sizeof(float)) != 0) {
+      if (++failures <= 10) std::cout << "different state: call " << i << " id " << id << " cot(alpha) " << cotalpha
+                                      << " cot(beta) " << cotbeta << " locBz " << locBz << " locBx " << locBx << std::endl;
+    }
+  }
+
+  std::cout << failures << " differences" << std::endl;
+  return failures ? 1 : 0;
+}
@@ -16,6 +16,8 @@
 
 #include "CalibFormats/SiStripObjects/interface/SiStripDetCabling.h"
 
+#include "RecoTracker/TkTrackingRegions/interface/TrackingRegionModuleSelector.h"
+
 
 #include "FWCore/Framework/interface/stream/EDProducer.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
@@ -28,6 +30,7 @@
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include <sstream>
 #include <memory>
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 
@@ -108,17 +111,23 @@ namespace {
     ClusterFiller(const FEDRawDataCollection& irawColl,
 		  StripClusterizerAlgorithm & iclusterizer,
 		  SiStripRawProcessingAlgorithms & irawAlgos,
-		  bool idoAPVEmulatorCheck):
+		  bool idoAPVEmulatorCheck,
+		  unsigned int inDets):
       rawColl(irawColl),
       clusterizer(iclusterizer),
       rawAlgos(irawAlgos),
-      doAPVEmulatorCheck(idoAPVEmulatorCheck){
-	incTot(clusterizer.allDetIds().size());
+      doAPVEmulatorCheck(idoAPVEmulatorCheck),
+      nDets(inDets){
+	incTot(nDets);
 	for (auto & d : done) d=nullptr;
       }
     
     
-    ~ClusterFiller() override { printStat();}
+    ~ClusterFiller() override {
+      printStat();
+      LogDebug(sistrip::mlRawToCluster_) << "filled " << nFilled << " of " << nDets << " dets, "
+					  << "FED buffers: " << nFedHits << " hits " << nFedMisses << " misses";
+    }
     
     void fill(StripClusterizerAlgorithm::output_t::TSFastFiller & record) override;
     
@@ -137,6 +146,13 @@ namespace {
     
     // March 2012: add flag for disabling APVe check in configuration
     bool doAPVEmulatorCheck; 
+
+    // hit-or-miss statistics of the (regional) on-demand filling:
+    // dets that can be filled and were filled, FED buffers reused or unpacked
+    const unsigned int nDets;
+    std::atomic<unsigned int> nFilled{0};
+    std::atomic<unsigned int> nFedHits{0};
+    std::atomic<unsigned int> nFedMisses{0};
     
     
 #ifdef VIDEBUG
@@ -195,6 +211,12 @@ class SiStripClusterizerFromRaw final : public edm::stream::EDProducer<>  {
     doAPVEmulatorCheck_(conf.existsAs<bool>("DoAPVEmulatorCheck") ? conf.getParameter<bool>("DoAPVEmulatorCheck") : true)
       {
 	productToken_ = consumes<FEDRawDataCollection>(conf.getParameter<edm::InputTag>("ProductLabel"));
+	// regional clusterization: only the dets touched by the TrackingRegions of the event
+	if (conf.existsAs<edm::ParameterSet>("Regions")) {
+	  auto const & regionsConf = conf.getParameter<edm::ParameterSet>("Regions");
+	  if (!regionsConf.getParameter<std::vector<edm::InputTag> >("inputs").empty())
+	    regions_.reset(new TrackingRegionModuleSelector(regionsConf, consumesCollector()));
+	}
 	produces< edmNew::DetSetVector<SiStripCluster> > ();
 	assert(clusterizer_.get());
 	assert(rawAlgos_.get());
@@ -213,14 +235,15 @@ class SiStripClusterizerFromRaw final : public edm::stream::EDProducer<>  {
     // get raw data
     edm::Handle<FEDRawDataCollection> rawData;
     ev.getByToken( productToken_, rawData); 
-    
+
+    auto const & detIds = detIdsToCluster(ev, es);
     
     std::unique_ptr< edmNew::DetSetVector<SiStripCluster> > 
       output( onDemand ?
 	      new edmNew::DetSetVector<SiStripCluster>(std::shared_ptr<edmNew::DetSetVector<SiStripCluster>::Getter>(std::make_shared<ClusterFiller>(*rawData, *clusterizer_, 
-																	 *rawAlgos_, doAPVEmulatorCheck_)
+																	 *rawAlgos_, doAPVEmulatorCheck_, detIds.size())
 														       ), 
-						       clusterizer_->allDetIds())
+						       detIds)
 	      : new edmNew::DetSetVector<SiStripCluster>());
     
     if(onDemand) assert(output->onDemand());
@@ -229,7 +252,7 @@ class SiStripClusterizerFromRaw final : public edm::stream::EDProducer<>  {
 
 
     if (!onDemand) {
-      run(*rawData, *output);
+      run(*rawData, detIds, *output);
       output->shrink_to_fit();   
       COUT << output->dataSize() << " clusters from " 
 	   << output->size()     << " modules" 
@@ -244,7 +267,10 @@ private:
 
   void initialize(const edm::EventSetup& es);
 
-  void run(const FEDRawDataCollection& rawColl, edmNew::DetSetVector<SiStripCluster> & output);
+  void run(const FEDRawDataCollection& rawColl, std::vector<uint32_t> const & detIds, edmNew::DetSetVector<SiStripCluster> & output);
+
+  // all the dets of the cabling, or those touched by the regions
+  std::vector<uint32_t> const & detIdsToCluster(const edm::Event& ev, const edm::EventSetup& es);
 
 
  private:
@@ -262,6 +288,9 @@ private:
   // March 2012: add flag for disabling APVe check in configuration
   bool doAPVEmulatorCheck_; 
 
+  std::unique_ptr<TrackingRegionModuleSelector> regions_;
+  std::vector<uint32_t> regionalDetIds_;
+
 };
 
 #include "FWCore/Framework/interface/MakerMacros.h"
@@ -278,13 +307,30 @@ void SiStripClusterizerFromRaw::initialize(const edm::EventSetup& es) {
 
 }
 
+std::vector<uint32_t> const & SiStripClusterizerFromRaw::detIdsToCluster(const edm::Event& ev, const edm::EventSetup& es) {
+  auto const & allDetIds = clusterizer_->allDetIds();
+  if (!regions_) return allDetIds;
+
+  regions_->run(ev, es);
+  if (regions_->all()) return allDetIds;
+
+  // both sorted
+  auto const & selected = regions_->stripModules();
+  regionalDetIds_.clear();
+  std::set_intersection(allDetIds.begin(), allDetIds.end(), selected.begin(), selected.end(),
+			std::back_inserter(regionalDetIds_));
+  COUT << regions_->nRegions() << " regions: " << regionalDetIds_.size() << " of " << allDetIds.size() << " dets" << std::endl;
+  return regionalDetIds_;
+}
+
 void SiStripClusterizerFromRaw::run(const FEDRawDataCollection& rawColl,
+				     std::vector<uint32_t> const & detIds,
 				     edmNew::DetSetVector<SiStripCluster> & output) {
   
-  ClusterFiller filler(rawColl, *clusterizer_, *rawAlgos_, doAPVEmulatorCheck_);
+  ClusterFiller filler(rawColl, *clusterizer_, *rawAlgos_, doAPVEmulatorCheck_, detIds.size());
   
-  // loop over good det in cabling
-  for ( auto idet : clusterizer_->allDetIds()) {
+  // loop over good det in cabling (or in the regions)
+  for ( auto idet : detIds) {
 
     StripClusterizerAlgorithm::output_t::TSFastFiller record(output, idet);	
     
@@ -308,6 +354,7 @@ try { // edmNew::CapacityExaustedException
   StripClusterizerAlgorithm::State state(det);
 
   incSet();
+  ++nFilled;
 
   // Loop over apv-pairs of det
   for (auto const conn : clusterizer.currentConnection(det)) {
@@ -321,7 +368,9 @@ try { // edmNew::CapacityExaustedException
 
     // If Fed hasnt already been initialised, extract data and initialise
     sistrip::FEDBuffer * buffer = done[fedId];
-    if (!buffer) { 
+    if (buffer) ++nFedHits;
+    else {
+      ++nFedMisses;
       buffer = fillBuffer(fedId, rawColl).release();
       if (!buffer) { continue;}
       sistrip::FEDBuffer * exp = nullptr;
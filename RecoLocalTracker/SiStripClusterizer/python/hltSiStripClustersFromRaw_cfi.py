@@ -7,5 +7,11 @@ SiStripClustersFromRawFacility = cms.EDProducer("SiStripClusterizerFromRaw",
                                                 Clusterizer = DefaultClusterizer,
                                                 Algorithms = DefaultAlgorithms,
                                                 DoAPVEmulatorCheck = cms.bool(False),
-                                                ProductLabel = cms.InputTag('rawDataCollector')
+                                                ProductLabel = cms.InputTag('rawDataCollector'),
+                                                # TrackingRegions restricting the dets to cluster, empty inputs means all
+                                                Regions = cms.PSet(
+                                                    inputs = cms.VInputTag(),
+                                                    extraEta = cms.double(0.),
+                                                    extraPhi = cms.double(0.)
+                                                )
                                                 )
@@ -20,6 +20,7 @@ public:
   using StripClusterParameterEstimator::localParameters;
 
   StripClusterParameterEstimator::LocalValues localParameters( const SiStripCluster& cl, const GeomDetUnit&) const override;
+  void localParameters(AClusters const & clusters, ALocalValues & retValues, const GeomDetUnit&) const override;
   
   StripCPE( edm::ParameterSet & conf, 
 	    const MagneticField&, 
@@ -38,6 +39,11 @@ public:
     int nstrips;
     float backplanecorrection;
     SiStripDetId::ModuleGeometry moduleGeom;
+    // rectangular topology: x = strip*pitch+offset, and without track
+    // the Lorentz shift (in strips) and the error do not depend on the position
+    bool rectangular;
+    float pitch, offset, noTrackShift;
+    LocalError noTrackError;
     float coveredStrips(const LocalVector&, const LocalPoint&) const;
   };
 
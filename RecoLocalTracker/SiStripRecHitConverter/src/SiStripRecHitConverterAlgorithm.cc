@@ -68,15 +68,20 @@ run(edm::Handle<edmNew::DetSetVector<SiStripCluster> > inputhandle, products& ou
     bool bad128StripBlocks[6]; fillBad128StripBlocks( id, bad128StripBlocks);
     
     GeomDetUnit const & du = *(tracker->idToDetUnit(id));
+    unInitDynArray(StripClusterParameterEstimator::AClusters::value_type,DS.size(),clusters);
     for(auto const & cluster : DS) {
-
       if(isMasked(cluster,bad128StripBlocks)) continue;
+      clusters.push_back(&cluster);
+    }
 
-      StripClusterParameterEstimator::LocalValues parameters = 	parameterestimator->localParameters(cluster,du);
-      collector.push_back(SiStripRecHit2D( parameters.first, parameters.second, du, 
-                                           DS.makeRefTo(inputhandle, &cluster) 
+    // all the clusters of the det at once
+    if (clusters.empty()) { collector.abort(); continue; }
+    declareDynArray(StripClusterParameterEstimator::LocalValues,clusters.size(),parameters);
+    parameterestimator->localParameters(clusters,parameters,du);
+    for (auto i=0U; i<clusters.size(); ++i)
+      collector.push_back(SiStripRecHit2D( parameters[i].first, parameters[i].second, du, 
+                                           DS.makeRefTo(inputhandle, clusters[i]) 
                                           ));
-    }
 
     if (collector.empty()) collector.abort();
   }
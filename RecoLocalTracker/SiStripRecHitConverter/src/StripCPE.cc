@@ -1,6 +1,7 @@
 #include "RecoLocalTracker/SiStripRecHitConverter/interface/StripCPE.h"
 #include "Geometry/CommonTopologies/interface/StripTopology.h"
 #include "Geometry/CommonTopologies/interface/TkRadialStripTopology.h"
+#include "Geometry/CommonTopologies/interface/RectangularStripTopology.h"
 #include "Geometry/TrackerGeometryBuilder/interface/StripGeomDetType.h"
 #include "boost/bind.hpp"
 #include "boost/lambda/lambda.hpp"
@@ -72,6 +73,23 @@ localParameters( const SiStripCluster& cluster, const GeomDetUnit& det) const {
 			 p.topology->localError(strip, 1.f/12.f) );
 }
 
+void StripCPE::
+localParameters(AClusters const & clusters, ALocalValues & retValues, const GeomDetUnit& det) const {
+  StripCPE::Param const & p = param(det);
+  if (!p.rectangular) {
+    for (auto i=0U; i< clusters.size(); ++i) retValues[i] = localParameters(*clusters[i],det);
+    return;
+  }
+
+  // barycenters first, then positions and errors in a vectorizable loop
+  auto n = clusters.size();
+  declareDynArray(float,n,strips);
+  for (auto i=0U; i<n; ++i) strips[i] = clusters[i]->barycenter();
+  const float shift = p.noTrackShift, pitch = p.pitch, offset = p.offset;
+  for (auto i=0U; i<n; ++i) strips[i] = (strips[i] + shift)*pitch + offset;
+  for (auto i=0U; i<n; ++i) retValues[i] = std::make_pair(LocalPoint(strips[i],0.f), p.noTrackError);
+}
+
 float StripCPE::Param::
 coveredStrips(const LocalVector& lvec, const LocalPoint& lpos) const {  
   return topology->coveredStrips(lpos + 0.5f*lvec,lpos - 0.5f*lvec);
@@ -123,6 +141,15 @@ StripCPE::fillParams() {
     p.nstrips = p.topology->nstrips(); 
     p.moduleGeom = SiStripDetId(stripdet->geographicalId()).moduleGeometry();
     p.backplanecorrection = BackPlaneCorrectionMap_.getBackPlaneCorrection(stripdet->geographicalId().rawId());
+
+    const RectangularStripTopology* rectop = dynamic_cast<const RectangularStripTopology*>(&stripdet->specificType().specificTopology());
+    p.rectangular = rectop != nullptr;
+    p.pitch = p.rectangular ? rectop->pitch() : 0.f;
+    p.offset = p.rectangular ? rectop->localPosition(0.f).x() : 0.f;
+    p.noTrackShift = p.rectangular
+      ? - 0.5f * (1.f-p.backplanecorrection) * p.coveredStrips( p.drift + LocalVector(0,0,-p.thickness), LocalPoint(0,0))
+      : 0.f;
+    p.noTrackError = p.rectangular ? rectop->localError(0.f, 1.f/12.f) : LocalError();
     
     const TkRadialStripTopology* rtop = dynamic_cast<const TkRadialStripTopology*>(&stripdet->specificType().specificTopology());
     p.pitch_rel_err2 = (rtop) 
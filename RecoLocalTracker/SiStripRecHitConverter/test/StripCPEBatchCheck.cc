@@ -0,0 +1,83 @@
+/** \class StripCPEBatchCheck
+ *
+ * Checks that the positions and errors given by the strip CPE for all the
+ * clusters of a det at once are the ones of the cluster by cluster estimate.
+ *
+ ************************************************************/
+
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/ESInputTag.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include "DataFormats/Common/interface/DetSetVectorNew.h"
+#include "DataFormats/SiStripCluster/interface/SiStripCluster.h"
+#include "Geometry/Records/interface/TrackerDigiGeometryRecord.h"
+#include "Geometry/TrackerGeometryBuilder/interface/TrackerGeometry.h"
+#include "RecoLocalTracker/ClusterParameterEstimator/interface/StripClusterParameterEstimator.h"
+#include "RecoLocalTracker/Records/interface/TkStripCPERecord.h"
+
+#include <cmath>
+
+class StripCPEBatchCheck : public edm::one::EDAnalyzer<> {
+public:
+  explicit StripCPEBatchCheck(const edm::ParameterSet& conf);
+
+  void analyze(const edm::Event& e, const edm::EventSetup& es) override;
+
+private:
+  edm::EDGetTokenT<edmNew::DetSetVector<SiStripCluster> > clusterToken_;
+  edm::ESInputTag cpeTag_;
+  double positionTolerance_;
+  double errorTolerance_;
+};
+
+StripCPEBatchCheck::StripCPEBatchCheck(const edm::ParameterSet& conf) :
+  clusterToken_(consumes<edmNew::DetSetVector<SiStripCluster> >(conf.getParameter<edm::InputTag>("ClusterProducer"))),
+  cpeTag_(conf.getParameter<edm::ESInputTag>("StripCPE")),
+  positionTolerance_(conf.getParameter<double>("positionTolerance")),
+  errorTolerance_(conf.getParameter<double>("errorTolerance"))
+{}
+
+void StripCPEBatchCheck::analyze(const edm::Event& e, const edm::EventSetup& es)
+{
+  edm::Handle<edmNew::DetSetVector<SiStripCluster> > clusters;
+  e.getByToken(clusterToken_, clusters);
+  edm::ESHandle<TrackerGeometry> tracker;
+  es.get<TrackerDigiGeometryRecord>().get(tracker);
+  edm::ESHandle<StripClusterParameterEstimator> cpe;
+  es.get<TkStripCPERecord>().get(cpeTag_, cpe);
+
+  unsigned int nChecked = 0;
+  for (auto const & DS : *clusters) {
+    GeomDetUnit const & du = *(tracker->idToDetUnit(DS.id()));
+    unInitDynArray(StripClusterParameterEstimator::AClusters::value_type,DS.size(),dsClusters);
+    for (auto const & cluster : DS) dsClusters.push_back(&cluster);
+    if (dsClusters.empty()) continue;
+
+    declareDynArray(StripClusterParameterEstimator::LocalValues,dsClusters.size(),batch);
+    cpe->localParameters(dsClusters,batch,du);
+    for (auto i=0U; i<dsClusters.size(); ++i) {
+      auto const single = cpe->localParameters(*dsClusters[i],du);
+      const float dx = batch[i].first.x() - single.first.x();
+      const float dy = batch[i].first.y() - single.first.y();
+      const float dxx = batch[i].second.xx() - single.second.xx();
+      if (std::abs(dx) > positionTolerance_ || std::abs(dy) > positionTolerance_ ||
+          std::abs(dxx) > errorTolerance_*single.second.xx())
+        throw cms::Exception("StripCPEBatchCheck")
+          << "det " << DS.id() << " cluster at " << dsClusters[i]->barycenter()
+          << ": batch " << batch[i].first << " " << batch[i].second
+          << ", single " << single.first << " " << single.second;
+      ++nChecked;
+    }
+  }
+  edm::LogInfo("StripCPEBatchCheck") << nChecked << " clusters with the same batch and single estimates";
+}
+
+DEFINE_FWK_MODULE(StripCPEBatchCheck);
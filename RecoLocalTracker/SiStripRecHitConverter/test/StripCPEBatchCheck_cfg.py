@@ -0,0 +1,29 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("StripCPEBatchCheck")
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:run2_mc', '')
+
+process.load("Configuration.StandardSequences.Reconstruction_cff")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(10)
+)
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring()
+)
+
+# the batch and cluster by cluster CPE estimates differ only by float rounding
+process.checkStripCPEBatch = cms.EDAnalyzer("StripCPEBatchCheck",
+    ClusterProducer = cms.InputTag('siStripClusters'),
+    StripCPE = cms.ESInputTag('StripCPEfromTrackAngleESProducer:StripCPEfromTrackAngle'),
+    positionTolerance = cms.double(1.e-4),
+    errorTolerance = cms.double(1.e-4)
+)
+
+process.p = cms.Path(process.striptrackerlocalreco*process.checkStripCPEBatch)
@@ -0,0 +1,54 @@
+#ifndef RECOLOCALTRACKER_SISTRIPZEROSUPPRESSION_APVORDERSTATISTICS_H
+#define RECOLOCALTRACKER_SISTRIPZEROSUPPRESSION_APVORDERSTATISTICS_H
+
+#include <algorithm>
+#include <cstdint>
+
+/*
+ * Order statistics (median, percentile) of the 128 integer samples of one APV,
+ * without moving them: bisection on the value, each step counting the samples
+ * below the pivot. The counting loops have a fixed trip count and no branches,
+ * so they vectorize, and at most 16 of them are needed for 16 bit samples,
+ * against the data-dependent branches of std::nth_element.
+ * Same results as nth_element on a copy of the samples.
+ */
+namespace apvOrderStatistics {
+
+  constexpr unsigned int nStrips = 128;
+
+  inline unsigned int countNotAbove(const int16_t * __restrict__ v, int x) {
+    unsigned int n=0;
+    for (unsigned int i=0; i<nStrips; ++i) n += (v[i]<=x);
+    return n;
+  }
+
+  /// k-th smallest sample (k=0 is the minimum)
+  inline int16_t kthSmallest(const int16_t * __restrict__ v, unsigned int k) {
+    int lo = v[0], hi = v[0];
+    for (unsigned int i=1; i<nStrips; ++i) { lo = std::min(lo,int(v[i])); hi = std::max(hi,int(v[i])); }
+    while (lo<hi) {
+      int mid = lo + (hi-lo)/2;
+      if (countNotAbove(v,mid)>k) hi = mid; else lo = mid+1;
+    }
+    return lo;
+  }
+
+  /// as SiStripCommonModeNoiseSubtractor::median: mean of the two central samples
+  inline float median(const int16_t * __restrict__ v) {
+    constexpr unsigned int k = nStrips/2;
+    const int below = kthSmallest(v,k-1);
+    if (countNotAbove(v,below)>k) return below;
+    // the next sample is the smallest one above
+    int above = INT16_MAX;
+    for (unsigned int i=0; i<nStrips; ++i) above = std::min(above, v[i]>below ? int(v[i]) : int(INT16_MAX));
+    return (below+above)/2.;
+  }
+
+  /// as PercentileCMNSubtractor::percentile
+  inline float percentile(const int16_t * __restrict__ v, double pct) {
+    return kthSmallest(v, std::min(int(nStrips*pct/100.0), int(nStrips)-1));
+  }
+
+}
+
+#endif
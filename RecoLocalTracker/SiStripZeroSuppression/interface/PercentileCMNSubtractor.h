@@ -14,6 +14,8 @@ class PercentileCMNSubtractor : public SiStripCommonModeNoiseSubtractor {
  private:
   
   template<typename T> float percentile(std::vector<T>&, double);
+  float apvPercentile(const int16_t*);
+  float apvPercentile(const float*);
   template<typename T> void subtract_(const uint32_t&,const uint16_t& firstAPV, std::vector<T>&);
   PercentileCMNSubtractor(double in) : 
     percentile_(in) {};  
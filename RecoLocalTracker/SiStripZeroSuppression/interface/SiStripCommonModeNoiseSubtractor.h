@@ -2,6 +2,7 @@
 #define RECOLOCALTRACKER_SISTRIPZEROSUPPRESSION_SISTRIPCOMMONMODENOISESUBTRACTOR_H
 
 #include "FWCore/Framework/interface/EventSetup.h"
+#include "RecoLocalTracker/SiStripZeroSuppression/interface/APVOrderStatistics.h"
 #include <vector>
 #include <algorithm>
 #include <cstdint>
@@ -24,7 +25,15 @@ class SiStripCommonModeNoiseSubtractor {
   SiStripCommonModeNoiseSubtractor(){};
   template<typename T> float median(std::vector<T>&);
 
+  // median of the 128 strips of the APV starting at apv, left untouched
+  float apvMedian(const int16_t* apv) { return apvOrderStatistics::median(apv); }
+  float apvMedian(const float* apv) {
+    _apvSamples.assign(apv, apv+apvOrderStatistics::nStrips);
+    return median(_apvSamples);
+  }
+
   std::vector< std::pair<short,float> > _vmedians;
+  std::vector<float> _apvSamples;
 };
 
 
@@ -21,11 +21,17 @@ class SiStripPedestalsSubtractor {
   
  private:
   
-  SiStripPedestalsSubtractor(bool mode) : peds_cache_id(0), fedmode_(mode) {};
+  SiStripPedestalsSubtractor(bool mode) : peds_cache_id(0), fedmode_(mode), pedsDetId_(0) {};
   edm::ESHandle<SiStripPedestals> pedestalsHandle;
   std::vector<int> pedestals;
   uint32_t peds_cache_id;
   bool fedmode_;
+
+  // pedestals of the last det, decoded once for all its APVs (virgin raw
+  // comes channel by channel) with the 10 bit wrap-around already applied
+  void decodePedestals(const uint32_t&);
+  std::vector<int16_t> effPedestals_;
+  uint32_t pedsDetId_;
   
   template <class input_t> void subtract_(const uint32_t&,const uint16_t&, const input_t&, std::vector<int16_t>&);
   const int16_t& eval(const int16_t& in) { return in;}
@@ -8,7 +8,6 @@ inline
 void MedianCMNSubtractor::
 subtract_(const uint32_t& detId,const uint16_t& firstAPV, std::vector<T>& digis){
   
-  std::vector<T> tmp;  tmp.reserve(128);  
   typename std::vector<T>::iterator  
     strip( digis.begin() ), 
     end(   digis.end()   ),
@@ -17,9 +16,8 @@ subtract_(const uint32_t& detId,const uint16_t& firstAPV, std::vector<T>& digis)
   _vmedians.clear();
   
   while( strip < end ) {
-    endAPV = strip+128; tmp.clear();
-    tmp.insert(tmp.end(),strip,endAPV);
-    const float offset = median(tmp);
+    endAPV = strip+128;
+    const float offset = apvMedian(&*strip);
 
     _vmedians.push_back(std::pair<short,float>((strip-digis.begin())/128+firstAPV,offset));
     
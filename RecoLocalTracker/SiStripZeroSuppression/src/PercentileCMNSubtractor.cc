@@ -8,7 +8,6 @@ inline
 void PercentileCMNSubtractor::
 subtract_(const uint32_t& detId,const uint16_t& firstAPV, std::vector<T>& digis){
   
-  std::vector<T> tmp;  tmp.reserve(128);  
   typename std::vector<T>::iterator  
     strip( digis.begin() ), 
     end(   digis.end()   ),
@@ -17,9 +16,8 @@ subtract_(const uint32_t& detId,const uint16_t& firstAPV, std::vector<T>& digis)
   _vmedians.clear();
 
   while( strip < end ) {
-    endAPV = strip+128; tmp.clear();
-    tmp.insert(tmp.end(),strip,endAPV);
-    const float offset = percentile(tmp,percentile_);
+    endAPV = strip+128;
+    const float offset = apvPercentile(&*strip);
 
     _vmedians.push_back(std::pair<short,float>((strip-digis.begin())/128+firstAPV,offset));
 
@@ -32,6 +30,15 @@ subtract_(const uint32_t& detId,const uint16_t& firstAPV, std::vector<T>& digis)
 }
 
 
+float PercentileCMNSubtractor::apvPercentile(const int16_t* apv) {
+  return apvOrderStatistics::percentile(apv, percentile_);
+}
+
+float PercentileCMNSubtractor::apvPercentile(const float* apv) {
+  _apvSamples.assign(apv, apv+apvOrderStatistics::nStrips);
+  return percentile(_apvSamples, percentile_);
+}
+
 template<typename T>
 inline
 float PercentileCMNSubtractor::
@@ -3,14 +3,29 @@
 #include "CondFormats/DataRecord/interface/SiStripPedestalsRcd.h"
 #include "FWCore/Utilities/interface/Exception.h"
 
+#include <algorithm>
+
 void SiStripPedestalsSubtractor::init(const edm::EventSetup& es){
   uint32_t p_cache_id = es.get<SiStripPedestalsRcd>().cacheIdentifier();
   if(p_cache_id != peds_cache_id) {
     es.get<SiStripPedestalsRcd>().get(pedestalsHandle);
     peds_cache_id = p_cache_id;
+    pedsDetId_ = 0;
   }
 }
 
+void SiStripPedestalsSubtractor::decodePedestals(const uint32_t& id) {
+  if (id == pedsDetId_) return;
+  pedsDetId_ = 0;
+  SiStripPedestals::Range pedestalsRange = pedestalsHandle->getRange(id);
+  pedestals.resize(((pedestalsRange.second-pedestalsRange.first) << 3) / 10);
+  pedestalsHandle->allPeds(pedestals, pedestalsRange);
+  effPedestals_.resize(pedestals.size());
+  for (unsigned int i=0; i<pedestals.size(); ++i)
+    effPedestals_[i] = pedestals[i] > 895 ? pedestals[i] - 1024 : pedestals[i];
+  pedsDetId_ = id;
+}
+
 void SiStripPedestalsSubtractor::subtract(const uint32_t& id, const uint16_t& firstStrip, std::vector<int16_t>& digis) {subtract_(id, firstStrip, digis, digis);}
 void SiStripPedestalsSubtractor::subtract(const edm::DetSet<SiStripRawDigi>& input, std::vector<int16_t>& output) {subtract_(input.id, 0, input, output);}
 
@@ -20,28 +35,18 @@ void SiStripPedestalsSubtractor::
 subtract_(const uint32_t& id, const uint16_t& firstStrip, const input_t& input, std::vector<int16_t>& output) {
   try {
 
-    pedestals.resize(firstStrip + input.size());
-    SiStripPedestals::Range pedestalsRange = pedestalsHandle->getRange(id);
-    pedestalsHandle->allPeds(pedestals, pedestalsRange);
-
-    typename input_t::const_iterator inDigi = input.begin();
-    std::vector<int>::const_iterator ped = pedestals.begin() + firstStrip;  
-    std::vector<int16_t>::iterator   outDigi = output.begin();
-
-    while( inDigi != input.end() ) {
-      
-      *outDigi = ( *ped > 895 )        
-	? eval(*inDigi) - *ped + 1024
-	: eval(*inDigi) - *ped;
-      
-      if(fedmode_ && *outDigi < 0) //FED bottoms out at 0
-	*outDigi=0;
-      
-      ++inDigi; 
-      ++ped; 
-      ++outDigi;
-    }
-
+    decodePedestals(id);
+    if (firstStrip + input.size() > effPedestals_.size())
+      throw cms::Exception("CorruptedData") << "Requested pedestals for " << firstStrip + input.size()
+					    << " strips, have them only for " << effPedestals_.size() << " strips";
+
+    // branch-free, so that it vectorizes
+    const int16_t * __restrict__ ped = effPedestals_.data() + firstStrip;
+    int16_t * outDigi = output.data();  // may be the input
+    const unsigned int n = input.size();
+    for (unsigned int i=0; i<n; ++i) outDigi[i] = eval(input[i]) - ped[i];
+    if (fedmode_) //FED bottoms out at 0
+      for (unsigned int i=0; i<n; ++i) outDigi[i] = std::max(outDigi[i], int16_t(0));
 
   } catch(cms::Exception& e){
     edm::LogError("SiStripPedestalsSubtractor")  
@@ -0,0 +1,84 @@
+// apvOrderStatistics against std::nth_element on a copy of the samples (as the
+// float paths of SiStripCommonModeNoiseSubtractor::median and
+// PercentileCMNSubtractor::percentile) on random APVs
+
+#include "RecoLocalTracker/SiStripZeroSuppression/interface/APVOrderStatistics.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  constexpr unsigned int nStrips = apvOrderStatistics::nStrips;
+
+  float referenceMedian(std::vector<int16_t> sample) {
+    auto mid = sample.begin() + sample.size()/2;
+    std::nth_element(sample.begin(), mid, sample.end());
+    return ( *std::max_element(sample.begin(), mid) + *mid ) / 2.;
+  }
+
+  float referencePercentile(std::vector<int16_t> sample, double pct) {
+    auto mid = sample.begin() + int(sample.size()*pct/100.0);
+    std::nth_element(sample.begin(), mid, sample.end());
+    return *mid;
+  }
+
+  int16_t referenceKth(std::vector<int16_t> sample, unsigned int k) {
+    std::nth_element(sample.begin(), sample.begin()+k, sample.end());
+    return sample[k];
+  }
+
+}
+
+int main() {
+  std::mt19937 rng(42);
+  const std::array<double,6> percentiles{{0., 5., 25., 50., 75., 99.9}};
+  unsigned int failures = 0, nAPVs = 0;
+
+  auto check = [&](const std::vector<int16_t>& apv) {
+    ++nAPVs;
+    for (unsigned int k=0; k<nStrips; ++k) {
+      if (apvOrderStatistics::kthSmallest(apv.data(), k) != referenceKth(apv, k)) {
+	if (++failures<10) std::cout << "kthSmallest differs, APV " << nAPVs << " k " << k << std::endl;
+      }
+    }
+    if (apvOrderStatistics::median(apv.data()) != referenceMedian(apv)) {
+      if (++failures<10) std::cout << "median differs, APV " << nAPVs << ": " << apvOrderStatistics::median(apv.data())
+				   << " " << referenceMedian(apv) << std::endl;
+    }
+    for (auto pct : percentiles) {
+      if (apvOrderStatistics::percentile(apv.data(), pct) != referencePercentile(apv, pct)) {
+	if (++failures<10) std::cout << "percentile " << pct << " differs, APV " << nAPVs << std::endl;
+      }
+    }
+  };
+
+  std::vector<int16_t> apv(nStrips);
+  for (unsigned int i=0; i<2000; ++i) {
+    // pedestal-subtracted like, narrow (many ties) and full 16 bit range
+    std::normal_distribution<float> noise(i%3 ? 0.f : 500.f, i%2 ? 3.f : 40.f);
+    std::uniform_int_distribution<int> full(INT16_MIN, INT16_MAX);
+    for (auto& s : apv) s = i%5==4 ? full(rng) : std::max(-1024.f, std::min(1023.f, noise(rng)));
+    // a few signal strips and saturated ones
+    if (i%4==1) for (unsigned int j=0; j<10; ++j) apv[rng()%nStrips] = INT16_MAX;
+    if (i%4==2) for (unsigned int j=0; j<70; ++j) apv[rng()%nStrips] = 1023;
+    check(apv);
+  }
+
+  // constant APVs and extreme values
+  for (int16_t value : {int16_t(INT16_MIN), int16_t(-1), int16_t(0), int16_t(INT16_MAX)}) {
+    std::fill(apv.begin(), apv.end(), value);
+    check(apv);
+  }
+  for (unsigned int i=0; i<nStrips; ++i) apv[i] = i<nStrips/2 ? INT16_MIN : INT16_MAX;
+  check(apv);
+  std::shuffle(apv.begin(), apv.end(), rng);
+  check(apv);
+
+  std::cout << nAPVs << " APVs, " << failures << " differences" << std::endl;
+  return failures ? 1 : 0;
+}
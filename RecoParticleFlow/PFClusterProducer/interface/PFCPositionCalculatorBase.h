@@ -29,6 +29,10 @@ class PFCPositionCalculatorBase {
   // here you call a loop inside to transform the whole vector
   virtual void calculateAndSetPositions(reco::PFClusterCollection&) = 0;
 
+  // true if the positions of different clusters can be calculated
+  // concurrently, i.e. if the calculation does not modify the calculator
+  virtual bool isThreadSafe() const { return false; }
+
   const std::string& name() const { return _algoName; }
   
  protected:  
@@ -0,0 +1,65 @@
+#ifndef __PFRecHitNavigationSoA_H__
+#define __PFRecHitNavigationSoA_H__
+
+#include "DataFormats/ParticleFlowReco/interface/PFRecHit.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecHitFwd.h"
+
+#include <vector>
+
+/*
+ * Structure-of-arrays copy of the rechit energies and neighbour lists used by
+ * the clustering steps. The neighbours of each rechit are stored in a flat
+ * table with a fixed number of slots per rechit, filled with the indices given
+ * by the navigators and padded with the index of a sentinel entry placed after
+ * the last rechit (size()). Loops over the neighbours then have a fixed trip
+ * count and no bound checks: per-rechit arrays indexed through the table need
+ * size()+1 entries, the sentinel one being neutral for the loop (e.g. lowest
+ * energy, masked).
+ */
+class PFRecHitNavigationSoA {
+ public:
+  PFRecHitNavigationSoA() : _size(0), _stride(0) { }
+  PFRecHitNavigationSoA(const PFRecHitNavigationSoA&) = delete;
+  PFRecHitNavigationSoA& operator=(const PFRecHitNavigationSoA&) = delete;
+
+  // nNeighbours as in the clustering configurations: 4 and 8 for the
+  // neighbours sharing a side or a side or a corner, -1 for all neighbours
+  // (including the ones in depth), 0 for none
+  void build(const reco::PFRecHitCollection& hits, int nNeighbours);
+
+  unsigned size() const { return _size; }
+  unsigned sentinel() const { return _size; }
+  unsigned stride() const { return _stride; }
+
+  // energies of the rechits, the sentinel one being the lowest float
+  const float* energies() const { return _energies.data(); }
+
+  // stride() neighbour indices of rechit i
+  const unsigned* neighbours(unsigned i) const {
+    return _neighbours.data() + i*_stride;
+  }
+
+  // seeds among the usable rechits: the local maxima of energies, a seed
+  // making its neighbours unusable, by decreasing energy (increasing index for
+  // equal energies). energies and usable have size()+1 entries, the sentinel
+  // ones being the lowest float and false
+  void findLocalMaxima(const float* energies, bool* usable,
+		       std::vector<bool>& seedable) const;
+
+  // topo cluster labels (size()+1 entries) of the gatherable rechits (size()+1
+  // entries, the sentinel one false): the rank of the first of the (gatherable)
+  // seeds, given by decreasing energy, reaching the rechit through gatherable
+  // neighbours, noLabel for the rechits reached by none
+  static constexpr unsigned noLabel = 0xffffffff;
+  void labelTopoClusters(const bool* gatherable,
+			 const std::vector<unsigned>& seeds,
+			 unsigned* labels);
+
+ private:
+  unsigned _size, _stride;
+  std::vector<float> _energies;
+  std::vector<unsigned> _neighbours;
+  std::vector<unsigned> _worklist; // rechits to be expanded by labelTopoClusters
+};
+
+#endif
@@ -7,7 +7,12 @@
 
 #include "vdt/vdtMath.h"
 
+#include <atomic>
 #include <iterator>
+#include <numeric>
+
+#include "tbb/task_arena.h"
+#include "tbb/tbb.h"
 
 #ifdef PFLOW_DEBUG
 #define LOGVERB(x) edm::LogVerbatim(x)
@@ -98,13 +103,16 @@ void Basic2DGenericPFlowClusterizer::
 buildClusters(const reco::PFClusterCollection& input,
 	      const std::vector<bool>& seedable,
 	      reco::PFClusterCollection& output) {
-  reco::PFClusterCollection clustersInTopo;
-  for( const auto& topocluster : input ) {
-    clustersInTopo.clear();
+  // the topo clusters are independent, each one is fitted into its own
+  // collection and the collections are merged in the topo cluster order
+  std::vector<reco::PFClusterCollection> clustersInTopos(input.size());
+  auto buildClustersInTopo = [&](unsigned itopo) {
+    const auto& topocluster = input[itopo];
+    reco::PFClusterCollection& clustersInTopo = clustersInTopos[itopo];
     seedPFClustersFromTopo(topocluster,seedable,clustersInTopo);
     const unsigned tolScal = 
       std::pow(std::max(1.0,clustersInTopo.size()-1.0),2.0);
-    growPFClusters(topocluster,seedable,tolScal,0,tolScal,clustersInTopo);
+    growPFClusters(topocluster,seedable,tolScal,clustersInTopo);
     // step added by Josh Bendavid, removes low-fraction clusters
     // did not impact position resolution with fraction cut of 1e-7
     // decreases the size of each pf cluster considerably
@@ -120,6 +128,33 @@ buildClusters(const reco::PFClusterCollection& input,
 	_positionCalc->calculateAndSetPositions(clustersInTopo);
       }   
     }
+  };
+
+  auto isThreadSafe = [](const std::unique_ptr<PosCalc>& calc) {
+    return !calc || calc->isThreadSafe();
+  };
+  if( input.size() > 1 && isThreadSafe(_positionCalc) && 
+      isThreadSafe(_allCellsPosCalc) && isThreadSafe(_convergencePosCalc) ) {
+    // a few large topo clusters dominate the time: start with them
+    std::vector<unsigned> bySize(input.size());
+    std::iota(bySize.begin(), bySize.end(), 0);
+    std::stable_sort(bySize.begin(), bySize.end(), [&](unsigned a, unsigned b) {
+      return input[a].recHitFractions().size() > input[b].recHitFractions().size();
+    });
+    std::atomic<unsigned> next(0);
+    tbb::this_task_arena::isolate([&] {
+      tbb::parallel_for(size_t(0), bySize.size(), [&](size_t) {
+	// each task takes the largest topo cluster not yet started
+	buildClustersInTopo(bySize[next++]);
+      });
+    });
+  } else {
+    for( unsigned itopo = 0; itopo < input.size(); ++itopo ) {
+      buildClustersInTopo(itopo);
+    }
+  }
+
+  for( auto& clustersInTopo : clustersInTopos ) {
     for( auto& clusterout : clustersInTopo ) {
       output.insert(output.end(),std::move(clusterout));
     }
@@ -146,46 +181,29 @@ seedPFClustersFromTopo(const reco::PFCluster& topo,
 }
 
 void Basic2DGenericPFlowClusterizer::
-growPFClusters(const reco::PFCluster& topo,
-	       const std::vector<bool>& seedable,
-	       const unsigned toleranceScaling,
-	       const unsigned iter,
-	       double diff,
-	       reco::PFClusterCollection& clusters) const {
-  if( iter >= _maxIterations ) {
-    LOGDRESSED("Basic2DGenericPFlowClusterizer:growAndStabilizePFClusters")
-      <<"reached " << _maxIterations << " iterations, terminated position "
-      << "fit with diff = " << diff;
-  }      
-  if( iter >= _maxIterations || 
-      diff <= _stoppingTolerance*toleranceScaling) return;
-  // reset the rechits in this cluster, keeping the previous position    
-  std::vector<reco::PFCluster::REPPoint> clus_prev_pos;  
-  for( auto& cluster : clusters) {
-    const reco::PFCluster::REPPoint& repp = cluster.positionREP();
-    clus_prev_pos.emplace_back(repp.rho(),repp.eta(),repp.phi());
-    if( _convergencePosCalc ) {
-      if( clusters.size() == 1 && _allCellsPosCalc ) {
-	_allCellsPosCalc->calculateAndSetPosition(cluster);
-      } else {
-	_positionCalc->calculateAndSetPosition(cluster);
-      }
-    }
-    cluster.resetHitsAndFractions();
-  }
-  // loop over topo cluster and grow current PFCluster hypothesis 
-  std::vector<double> dist2, frac;
-  double fractot = 0;
-  for( const reco::PFRecHitFraction& rhf : topo.recHitFractions() ) {
-    const reco::PFRecHitRef& refhit = rhf.recHitRef();
+fillTopoClusterSoA(const reco::PFCluster& topo,
+		   const std::vector<bool>& seedable,
+		   const reco::PFClusterCollection& clusters,
+		   TopoClusterSoA& soa) const {
+  const auto& recHitFractions = topo.recHitFractions();
+  const unsigned nhits = recHitFractions.size();
+  const unsigned nclusters = clusters.size();
+  soa.x.resize(nhits); soa.y.resize(nhits); soa.z.resize(nhits);
+  soa.energyNorms.resize(nhits);
+  soa.seedable.resize(nhits);
+  soa.seedClusters.resize(nhits);
+  for( unsigned h = 0; h < nhits; ++h ) {
+    const reco::PFRecHitRef& refhit = recHitFractions[h].recHitRef();
     int cell_layer = (int)refhit->layer();
     if( cell_layer == PFLayer::HCAL_BARREL2 && 
 	std::abs(refhit->positionREP().eta()) > 0.34 ) {
       cell_layer *= 100;
     }  
 
-    math::XYZPoint topocellpos_xyz(refhit->position());
-    dist2.clear(); frac.clear(); fractot = 0;
+    const math::XYZPoint topocellpos_xyz(refhit->position());
+    soa.x[h] = topocellpos_xyz.x();
+    soa.y[h] = topocellpos_xyz.y();
+    soa.z[h] = topocellpos_xyz.z();
 
     double recHitEnergyNorm=0.;
     auto const& recHitEnergyNormDepthPair = _recHitEnergyNorms.find(cell_layer)->second;
@@ -198,73 +216,136 @@ growPFClusters(const reco::PFCluster& topo,
 	  || ( cell_layer != PFLayer::HCAL_ENDCAP && cell_layer != PFLayer::HCAL_BARREL1)
 	  ) recHitEnergyNorm = recHitEnergyNormDepthPair.second[j];
     }
+    soa.energyNorms[h] = recHitEnergyNorm;
 
-    // add rechits to clusters, calculating fraction based on distance
-    for( auto& cluster : clusters ) {      
-      const math::XYZPoint& clusterpos_xyz = cluster.position();
-      const math::XYZVector deltav = clusterpos_xyz - topocellpos_xyz;
-      const double d2 = deltav.Mag2()/_showerSigma2;
-      dist2.emplace_back( d2 );
-      if( d2 > 100 ) {
-	LOGDRESSED("Basic2DGenericPFlowClusterizer:growAndStabilizePFClusters")
-	  << "Warning! :: pfcluster-topocell distance is too large! d= "
-	  << d2;
-      }
+    soa.seedable[h] = seedable[refhit.key()];
+    soa.seedClusters[h] = -1;
+    for( unsigned c = 0; c < nclusters; ++c ) {
+      if( refhit->detId() == clusters[c].seed() ) soa.seedClusters[h] = c;
+    }
+  }
+  soa.clusterX.resize(nclusters); soa.clusterY.resize(nclusters);
+  soa.clusterZ.resize(nclusters); soa.clusterEnergies.resize(nclusters);
+  soa.dist2.resize(nhits*nclusters);
+  soa.fractions.resize(nhits*nclusters);
+  soa.fractionSums.resize(nhits);
+}
 
+void Basic2DGenericPFlowClusterizer::
+computeFractions(TopoClusterSoA& soa) const {
+  const unsigned nhits = soa.x.size();
+  const unsigned nclusters = soa.clusterX.size();
+  for( unsigned h = 0; h < nhits; ++h ) {
+    double* __restrict__ dist2 = soa.dist2.data() + h*nclusters;
+    double* __restrict__ frac = soa.fractions.data() + h*nclusters;
+    const bool otherSeed = _excludeOtherSeeds && soa.seedable[h];
+    double fractot = 0;
+    for( unsigned c = 0; c < nclusters; ++c ) {
+      const double dx = soa.clusterX[c] - soa.x[h];
+      const double dy = soa.clusterY[c] - soa.y[h];
+      const double dz = soa.clusterZ[c] - soa.z[h];
+      dist2[c] = (dx*dx + dy*dy + dz*dz)/_showerSigma2;
       // fraction assignment logic
-      double fraction;
-      if( refhit->detId() == cluster.seed() && _excludeOtherSeeds ) {
-	fraction = 1.0;	
-      } else if ( seedable[refhit.key()] && _excludeOtherSeeds ) {
-	fraction = 0.0;
-      } else {
-	fraction = cluster.energy()/recHitEnergyNorm * vdt::fast_expf( -0.5*d2 );
-      }      
+      double fraction = soa.clusterEnergies[c]/soa.energyNorms[h] * vdt::fast_expf( -0.5*dist2[c] );
+      if( otherSeed ) fraction = ( soa.seedClusters[h] == int(c) ? 1.0 : 0.0 );
       fractot += fraction;
-      frac.emplace_back(fraction);
+      frac[c] = fraction;
     }
-    for( unsigned i = 0; i < clusters.size(); ++i ) {      
-      if( fractot > _minFracTot || 
-	  ( refhit->detId() == clusters[i].seed() && fractot > 0.0 ) ) {
-	frac[i]/=fractot;
-      } else {
-	continue;
+    soa.fractionSums[h] = fractot;
+  }
+}
+
+void Basic2DGenericPFlowClusterizer::
+growPFClusters(const reco::PFCluster& topo,
+	       const std::vector<bool>& seedable,
+	       const unsigned toleranceScaling,
+	       reco::PFClusterCollection& clusters) const {
+  // the topo cluster rechits and the fit buffers are set up once, the fit
+  // iterations then only refill them
+  TopoClusterSoA soa;
+  fillTopoClusterSoA(topo,seedable,clusters,soa);
+  const auto& recHitFractions = topo.recHitFractions();
+  const unsigned nclusters = clusters.size();
+  std::vector<reco::PFCluster::REPPoint> clus_prev_pos(nclusters);
+
+  double diff = toleranceScaling;
+  for( unsigned iter = 0; ; ++iter ) {
+    if( iter >= _maxIterations ) {
+      LOGDRESSED("Basic2DGenericPFlowClusterizer:growAndStabilizePFClusters")
+	<<"reached " << _maxIterations << " iterations, terminated position "
+	<< "fit with diff = " << diff;
+    }      
+    if( iter >= _maxIterations || 
+	diff <= _stoppingTolerance*toleranceScaling) return;
+    // reset the rechits in this cluster, keeping the previous position    
+    for( unsigned i = 0; i < nclusters; ++i ) {
+      auto& cluster = clusters[i];
+      const reco::PFCluster::REPPoint& repp = cluster.positionREP();
+      clus_prev_pos[i] = reco::PFCluster::REPPoint(repp.rho(),repp.eta(),repp.phi());
+      if( _convergencePosCalc ) {
+	if( clusters.size() == 1 && _allCellsPosCalc ) {
+	  _allCellsPosCalc->calculateAndSetPosition(cluster);
+	} else {
+	  _positionCalc->calculateAndSetPosition(cluster);
+	}
       }
-      // if the fraction has been set to 0, the cell 
-      // is now added to the cluster - careful ! (PJ, 19/07/08)
-      // BUT KEEP ONLY CLOSE CELLS OTHERWISE MEMORY JUST EXPLOSES
-      // (PJ, 15/09/08 <- similar to what existed before the 
-      // previous bug fix, but keeps the close seeds inside, 
-      // even if their fraction was set to zero.)
-      // Also add a protection to keep the seed in the cluster 
-      // when the latter gets far from the former. These cases
-      // (about 1% of the clusters) need to be studied, as 
-      // they create fake photons, in general.
-      // (PJ, 16/09/08) 
-      if( dist2[i] < 100.0 || frac[i] > 0.9999 ) {	
-	clusters[i].addRecHitFraction(reco::PFRecHitFraction(refhit,frac[i]));
+      cluster.resetHitsAndFractions();
+      const math::XYZPoint& clusterpos_xyz = cluster.position();
+      soa.clusterX[i] = clusterpos_xyz.x();
+      soa.clusterY[i] = clusterpos_xyz.y();
+      soa.clusterZ[i] = clusterpos_xyz.z();
+      soa.clusterEnergies[i] = cluster.energy();
+    }
+    computeFractions(soa);
+    // add rechits to clusters with their normalized fractions
+    for( unsigned h = 0; h < recHitFractions.size(); ++h ) {
+      const reco::PFRecHitRef& refhit = recHitFractions[h].recHitRef();
+      const double* dist2 = soa.dist2.data() + h*nclusters;
+      const double* frac = soa.fractions.data() + h*nclusters;
+      const double fractot = soa.fractionSums[h];
+      for( unsigned i = 0; i < nclusters; ++i ) {      
+	if( dist2[i] > 100 ) {
+	  LOGDRESSED("Basic2DGenericPFlowClusterizer:growAndStabilizePFClusters")
+	    << "Warning! :: pfcluster-topocell distance is too large! d= "
+	    << dist2[i];
+	}
+	if( !( fractot > _minFracTot || 
+	       ( soa.seedClusters[h] == int(i) && fractot > 0.0 ) ) ) continue;
+	const double fraction = frac[i]/fractot;
+	// if the fraction has been set to 0, the cell 
+	// is now added to the cluster - careful ! (PJ, 19/07/08)
+	// BUT KEEP ONLY CLOSE CELLS OTHERWISE MEMORY JUST EXPLOSES
+	// (PJ, 15/09/08 <- similar to what existed before the 
+	// previous bug fix, but keeps the close seeds inside, 
+	// even if their fraction was set to zero.)
+	// Also add a protection to keep the seed in the cluster 
+	// when the latter gets far from the former. These cases
+	// (about 1% of the clusters) need to be studied, as 
+	// they create fake photons, in general.
+	// (PJ, 16/09/08) 
+	if( dist2[i] < 100.0 || fraction > 0.9999 ) {	
+	  clusters[i].addRecHitFraction(reco::PFRecHitFraction(refhit,fraction));
+	}
       }
     }
-  }
-  // recalculate positions and calculate convergence parameter
-  double diff2 = 0.0;  
-  for( unsigned i = 0; i < clusters.size(); ++i ) {
-    if( _convergencePosCalc ) {
-      _convergencePosCalc->calculateAndSetPosition(clusters[i]);
-    } else {
-      if( clusters.size() == 1 && _allCellsPosCalc ) {
-	_allCellsPosCalc->calculateAndSetPosition(clusters[i]);
+    // recalculate positions and calculate convergence parameter
+    double diff2 = 0.0;  
+    for( unsigned i = 0; i < nclusters; ++i ) {
+      if( _convergencePosCalc ) {
+	_convergencePosCalc->calculateAndSetPosition(clusters[i]);
       } else {
-	_positionCalc->calculateAndSetPosition(clusters[i]);
+	if( clusters.size() == 1 && _allCellsPosCalc ) {
+	  _allCellsPosCalc->calculateAndSetPosition(clusters[i]);
+	} else {
+	  _positionCalc->calculateAndSetPosition(clusters[i]);
+	}
       }
+      const double delta2 = 
+	reco::deltaR2(clusters[i].positionREP(),clus_prev_pos[i]);    
+      if( delta2 > diff2 ) diff2 = delta2;
     }
-    const double delta2 = 
-      reco::deltaR2(clusters[i].positionREP(),clus_prev_pos[i]);    
-    if( delta2 > diff2 ) diff2 = delta2;
+    diff = std::sqrt(diff2);
   }
-  diff = std::sqrt(diff2);
-  dist2.clear(); frac.clear(); clus_prev_pos.clear();// avoid badness
-  growPFClusters(topo,seedable,toleranceScaling,iter+1,diff,clusters);
 }
 
 void Basic2DGenericPFlowClusterizer::
@@ -5,6 +5,7 @@
 #include "DataFormats/ParticleFlowReco/interface/PFRecHitFraction.h"
 
 #include <unordered_map>
+#include <vector>
 
 class Basic2DGenericPFlowClusterizer : public PFClusterBuilderBase {
   typedef Basic2DGenericPFlowClusterizer B2DGPF;
@@ -41,11 +42,28 @@ class Basic2DGenericPFlowClusterizer : public PFClusterBuilderBase {
 			      const std::vector<bool>&,
 			      reco::PFClusterCollection&) const;
 
+  // rechits of a topo cluster as a structure of arrays, and buffers of the
+  // fit of the clusters in the topo cluster
+  struct TopoClusterSoA {
+    std::vector<double> x, y, z; // rechit positions
+    std::vector<double> energyNorms;
+    std::vector<bool> seedable;
+    std::vector<int> seedClusters; // cluster seeded by the rechit, or -1
+    std::vector<double> clusterX, clusterY, clusterZ, clusterEnergies;
+    // distances and fractions by rechit and cluster, and sums by rechit
+    std::vector<double> dist2, fractions, fractionSums;
+  };
+
+  void fillTopoClusterSoA(const reco::PFCluster&,
+			  const std::vector<bool>&,
+			  const reco::PFClusterCollection&,
+			  TopoClusterSoA&) const;
+
+  void computeFractions(TopoClusterSoA&) const;
+
   void growPFClusters(const reco::PFCluster&,
 		      const std::vector<bool>&,
 		      const unsigned toleranceScaling,
-		      const unsigned iter,
-		      double dist,
 		      reco::PFClusterCollection&) const;
   
   void prunePFClusters(reco::PFClusterCollection&) const;
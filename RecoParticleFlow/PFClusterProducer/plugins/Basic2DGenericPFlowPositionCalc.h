@@ -95,6 +95,8 @@ class Basic2DGenericPFlowPositionCalc : public PFCPositionCalculatorBase {
   void calculateAndSetPosition(reco::PFCluster&) override;
   void calculateAndSetPositions(reco::PFClusterCollection&) override;
 
+  bool isThreadSafe() const override { return true; }
+
  private:
   const int _posCalcNCrystals;
   std::tuple<std::vector<int> ,std::vector<int> , std::vector<float> > _logWeightDenom;
@@ -1,5 +1,8 @@
 #include "Basic2DGenericTopoClusterizer.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "CommonTools/Utils/interface/DynArray.h"
+
+#include <algorithm>
 
 #ifdef PFLOW_DEBUG
 #define LOGVERB(x) edm::LogVerbatim(x)
@@ -18,36 +21,55 @@ buildClusters(const edm::Handle<reco::PFRecHitCollection>& input,
 	      const std::vector<bool>& rechitMask,
 	      const std::vector<bool>& seedable,
 	      reco::PFClusterCollection& output) {
-  auto const & hits = *input;  
-  std::vector<bool> used(hits.size(),false);
-  std::vector<unsigned int> seeds;
-  
+  auto const & hits = *input;
+  const unsigned nhits = hits.size();
+  _navigation.build(hits, _useCornerCells ? 8 : 4);
+  const unsigned nslots = nhits+1; // with the sentinel
+
+  // the rechits which can be gathered in a topo cluster
+  initDynArray(bool,nslots,gatherable,false);
+  for( unsigned i = 0; i < nhits; ++i ) {
+    gatherable[i] = rechitMask[i] && passesGatheringThresholds(hits[i]);
+  }
+
   // get the seeds and sort them descending in energy
-  seeds.reserve(hits.size());  
-  for( unsigned int i = 0; i < hits.size(); ++i ) {
-    if( !rechitMask[i] || !seedable[i] || used[i] ) continue;
+  std::vector<unsigned int> seeds;
+  seeds.reserve(nhits);
+  for( unsigned int i = 0; i < nhits; ++i ) {
+    if( !gatherable[i] || !seedable[i] ) continue;
     seeds.emplace_back(i);
   }
-  // maxHeap would be better
-  std::sort(seeds.begin(),seeds.end(),
-            [&](unsigned int i, unsigned int j) { return hits[i].energy()>hits[j].energy();});  
-  
-  reco::PFCluster temp;
-  for( auto seed : seeds ) {    
-    if( !rechitMask[seed] || !seedable[seed] || used[seed] ) continue;    
-    temp.reset();
-    buildTopoCluster(input,rechitMask,seed,used,temp);
-    if( !temp.recHitFractions().empty() ) output.push_back(temp);
+  std::stable_sort(seeds.begin(),seeds.end(),
+		   [&](unsigned int i, unsigned int j) { return hits[i].energy()>hits[j].energy();});
+
+  // each gatherable rechit reachable from a seed takes the lowest rank among
+  // these seeds, as the highest energy seed gathers first the rechits it can
+  // reach
+  constexpr unsigned noLabel = PFRecHitNavigationSoA::noLabel;
+  declareDynArray(unsigned,nslots,labels);
+  _navigation.labelTopoClusters(gatherable.begin(),seeds,labels.begin());
+
+  // one topo cluster per seed not gathered by a higher energy one, in seed
+  // order, with its rechits in index order
+  const unsigned firstCluster = output.size();
+  std::vector<unsigned> clusterIndices(seeds.size(),noLabel);
+  for( unsigned rank = 0; rank < seeds.size(); ++rank ) {
+    if( labels[seeds[rank]] != rank ) continue;
+    clusterIndices[rank] = output.size();
+    output.emplace_back();
+  }
+  for( unsigned i = 0; i < nhits; ++i ) {
+    if( labels[i] == noLabel ) continue;
+    output[clusterIndices[labels[i]]]
+      .addRecHitFraction(reco::PFRecHitFraction(makeRefhit(input,i), 1.0));
   }
+  LOGDRESSED("GenericTopoCluster::buildClusters()")
+    << "built " << output.size() - firstCluster << " topo clusters from "
+    << seeds.size() << " seeds";
 }
 
-void Basic2DGenericTopoClusterizer::
-buildTopoCluster(const edm::Handle<reco::PFRecHitCollection>& input,
-		 const std::vector<bool>& rechitMask,
-		 unsigned int kcell,
-		 std::vector<bool>& used,		 
-		 reco::PFCluster& topocluster) {
-  auto const & cell = (*input)[kcell];
+bool Basic2DGenericTopoClusterizer::
+passesGatheringThresholds(const reco::PFRecHit& cell) const {
   int cell_layer = (int)cell.layer();
   if( cell_layer == PFLayer::HCAL_BARREL2 && 
       std::abs(cell.positionREP().eta()) > 0.34 ) {
@@ -70,32 +92,10 @@ buildTopoCluster(const edm::Handle<reco::PFRecHitCollection>& input,
 
   if( cell.energy() < thresholdE ||
       cell.pt2() < thresholdPT2  ) {
-    LOGDRESSED("GenericTopoCluster::buildTopoCluster()")
+    LOGDRESSED("GenericTopoCluster::passesGatheringThresholds()")
       << "RecHit " << cell.detId() << " with enegy "
       << cell.energy() << " GeV was rejected!." << std::endl;
-    return;
-  }
-
-
-  auto k = kcell;
-  used[k] = true;
-  auto ref = makeRefhit(input,k);
-  topocluster.addRecHitFraction(reco::PFRecHitFraction(ref, 1.0));
-  
-  auto const & neighbours = 
-    ( _useCornerCells ? cell.neighbours8() : cell.neighbours4() );
-  
-  for( auto nb : neighbours ) {
-    if( used[nb] || !rechitMask[nb] ) {
-      LOGDRESSED("GenericTopoCluster::buildTopoCluster()")
-      	<< "  RecHit " << cell.detId() << "\'s" 
-	<< " neighbor RecHit " << input->at(nb).detId() 
-	<< " with enegy " 
-	<< input->at(nb).energy() << " GeV was rejected!" 
-	<< " Reasons : " << used[nb] << " (used) " 
-	<< !rechitMask[nb] << " (masked)." << std::endl;
-      continue;
-    }
-    buildTopoCluster(input,rechitMask,nb,used,topocluster);
+    return false;
   }
+  return true;
 }
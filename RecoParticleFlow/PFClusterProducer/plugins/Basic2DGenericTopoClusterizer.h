@@ -2,6 +2,7 @@
 #define __Basic2DGenericTopoClusterizer_H__
 
 #include "RecoParticleFlow/PFClusterProducer/interface/InitialClusteringStepBase.h"
+#include "RecoParticleFlow/PFClusterProducer/interface/PFRecHitNavigationSoA.h"
 #include "DataFormats/ParticleFlowReco/interface/PFRecHitFraction.h"
 
 class Basic2DGenericTopoClusterizer : public InitialClusteringStepBase {
@@ -22,11 +23,8 @@ class Basic2DGenericTopoClusterizer : public InitialClusteringStepBase {
   
  private:  
   const bool _useCornerCells;
-  void buildTopoCluster(const edm::Handle<reco::PFRecHitCollection>&,
-			const std::vector<bool>&, // masked rechits
-			unsigned int, //present rechit
-			std::vector<bool>&, // hit usage state
-			reco::PFCluster&); // the topocluster
+  PFRecHitNavigationSoA _navigation; // rebuilt for each event
+  bool passesGatheringThresholds(const reco::PFRecHit&) const;
   
 };
 
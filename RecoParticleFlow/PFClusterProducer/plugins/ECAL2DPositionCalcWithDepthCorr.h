@@ -44,6 +44,8 @@ class ECAL2DPositionCalcWithDepthCorr : public PFCPositionCalculatorBase {
   void calculateAndSetPosition(reco::PFCluster&) override;
   void calculateAndSetPositions(reco::PFClusterCollection&) override;
 
+  bool isThreadSafe() const override { return true; }
+
  private:  
   const double _param_T0_EB;
   const double _param_T0_EE;
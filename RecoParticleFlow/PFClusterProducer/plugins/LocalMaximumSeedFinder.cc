@@ -1,15 +1,10 @@
 #include "LocalMaximumSeedFinder.h"
 
 #include <algorithm>
-#include <queue>
-#include <cfloat>
+#include <limits>
 #include "CommonTools/Utils/interface/DynArray.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
-namespace {
-  const reco::PFRecHit::Neighbours  _noNeighbours(nullptr,0);
-}
-
 LocalMaximumSeedFinder::
 LocalMaximumSeedFinder(const edm::ParameterSet& conf) : 
   SeedFinderBase(conf),   
@@ -26,6 +21,11 @@ LocalMaximumSeedFinder(const edm::ParameterSet& conf) :
 	      {"HCAL_ENDCAP",(int)PFLayer::HCAL_ENDCAP},
 	      {"HF_EM",(int)PFLayer::HF_EM},
 	      {"HF_HAD",(int)PFLayer::HF_HAD} }) {
+  if( _nNeighbours != -1 && _nNeighbours != 0 &&
+      _nNeighbours != 4 && _nNeighbours != 8 ) {
+    throw cms::Exception("InvalidConfiguration")
+      << "LocalMaximumSeedFinder only accepts nNeighbors = {-1,0,4,8}";
+  }
   const std::vector<edm::ParameterSet>& thresholds =
     conf.getParameterSetVector("thresholdsByDetector");
   for( const auto& pset : thresholds ) {
@@ -72,18 +72,23 @@ findSeeds( const edm::Handle<reco::PFRecHitCollection>& input,
 	   const std::vector<bool>& mask,
 	   std::vector<bool>& seedable ) {
 
-  auto nhits = input->size();
-  initDynArray(bool,nhits,usable,true);
-  //need to run over energy sorted rechits
-  declareDynArray(float,nhits,energies);
-  unInitDynArray(int,nhits,qst); // queue storage
-  auto cmp = [&](int i, int j) { return energies[i] < energies[j]; };
-  std::priority_queue<int, DynArray<int>, decltype(cmp)> ordered_hits(cmp,std::move(qst));
+  auto const & hits = *input;
+  const unsigned nhits = hits.size();
+  _navigation.build(hits,_nNeighbours);
+  const unsigned nslots = nhits+1; // with the sentinel
+
+  // masked rechits do not prevent their neighbours from seeding
+  declareDynArray(float,nslots,energies);
+  for( unsigned i = 0; i < nslots; ++i ) {
+    energies[i] = ( i < nhits && mask[i] ? 
+		    _navigation.energies()[i] : 
+		    std::numeric_limits<float>::lowest() );
+  }
 
+  initDynArray(bool,nslots,usable,false);
   for( unsigned i = 0; i < nhits; ++i ) {
     if( !mask[i] ) continue; // cannot seed masked objects
-    auto const & maybeseed = (*input)[i];
-    energies[i]=maybeseed.energy();
+    auto const & maybeseed = hits[i];
     int seedlayer = (int)maybeseed.layer();
     if( seedlayer == PFLayer::HCAL_BARREL2 &&
         std::abs(maybeseed.positionREP().eta()) > 0.34 ) {
@@ -105,53 +110,11 @@ findSeeds( const edm::Handle<reco::PFRecHitCollection>& input,
 
     }
 
-    if( maybeseed.energy() < thresholdE ||
-	maybeseed.pt2() < thresholdPT2   ) usable[i] = false;
-    if( !usable[i] ) continue;
-    ordered_hits.push(i);
-
+    usable[i] = !( maybeseed.energy() < thresholdE ||
+		   maybeseed.pt2() < thresholdPT2 );
   }
 
-
-  while(!ordered_hits.empty() ) {
-    auto idx = ordered_hits.top();
-    ordered_hits.pop();  
-    if( !usable[idx] ) continue;
-    //get the neighbours of this seed
-    auto const & maybeseed = (*input)[idx];
-    reco::PFRecHit::Neighbours  myNeighbours;
-    switch( _nNeighbours ) {
-    case -1:
-      myNeighbours = maybeseed.neighbours();
-      break;
-    case 0: // for HF clustering
-      myNeighbours = _noNeighbours;
-      break;
-    case 4:
-      myNeighbours = maybeseed.neighbours4();
-      break;
-    case 8:
-      myNeighbours = maybeseed.neighbours8();
-      break;
-    default:
-      throw cms::Exception("InvalidConfiguration")
-	<< "LocalMaximumSeedFinder only accepts nNeighbors = {-1,0,4,8}";    
-    }
-    seedable[idx] = true;
-    for( auto neighbour : myNeighbours ) {
-      if( !mask[neighbour] ) continue;
-      if( energies[neighbour] > energies[idx] ) {
-//        std::cout << "how this can be?" << std::endl;
-	seedable[idx] = false;	
-	break;
-      }
-    }
-    if( seedable[idx] ) {
-      for( auto neighbour : myNeighbours ) {
-	usable[neighbour] = false;
-      }
-    }
-  }
+  _navigation.findLocalMaxima(energies.begin(),usable.begin(),seedable);
 
   LogDebug("LocalMaximumSeedFinder") << " found " << std::count(seedable.begin(),seedable.end(),true) << " seeds";
 
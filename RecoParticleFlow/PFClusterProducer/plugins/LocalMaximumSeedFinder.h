@@ -2,6 +2,7 @@
 #define __LocalMaximumSeedFinder_H__
 
 #include "RecoParticleFlow/PFClusterProducer/interface/SeedFinderBase.h"
+#include "RecoParticleFlow/PFClusterProducer/interface/PFRecHitNavigationSoA.h"
 
 #include <unordered_map>
 #include <tuple>
@@ -25,6 +26,8 @@ class LocalMaximumSeedFinder final : public SeedFinderBase {
 
   std::array<I3tuple, 35> _thresholds;
   static constexpr int layerOffset = 15;
+
+  PFRecHitNavigationSoA _navigation; // rebuilt for each event
 };
 
 DEFINE_EDM_PLUGIN(SeedFinderFactory,
@@ -0,0 +1,97 @@
+#include "RecoParticleFlow/PFClusterProducer/interface/PFRecHitNavigationSoA.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <limits>
+
+constexpr unsigned PFRecHitNavigationSoA::noLabel;
+
+void PFRecHitNavigationSoA::
+build(const reco::PFRecHitCollection& hits, int nNeighbours) {
+  auto neighboursOf = [nNeighbours](const reco::PFRecHit& hit) {
+    switch( nNeighbours ) {
+    case -1:
+      return hit.neighbours();
+    case 0:
+      return reco::PFRecHit::Neighbours(nullptr,0);
+    case 4:
+      return hit.neighbours4();
+    case 8:
+      return hit.neighbours8();
+    default:
+      throw cms::Exception("InvalidConfiguration")
+	<< "PFRecHitNavigationSoA only accepts nNeighbours = {-1,0,4,8}";
+    }
+  };
+
+  _size = hits.size();
+  _stride = 0;
+  for( const auto& hit : hits ) {
+    _stride = std::max(_stride,neighboursOf(hit).size());
+  }
+
+  _energies.resize(_size+1);
+  _neighbours.assign(_size*_stride,sentinel());
+  for( unsigned i = 0; i < _size; ++i ) {
+    _energies[i] = hits[i].energy();
+    const auto nbs = neighboursOf(hits[i]);
+    std::copy(nbs.begin(),nbs.end(),_neighbours.begin() + i*_stride);
+  }
+  _energies[_size] = std::numeric_limits<float>::lowest();
+}
+
+void PFRecHitNavigationSoA::
+findLocalMaxima(const float* energies, bool* usable,
+		std::vector<bool>& seedable) const {
+  // highest energy among the neighbours: fixed trip count, no branches
+  std::vector<unsigned> candidates;
+  for( unsigned i = 0; i < _size; ++i ) {
+    auto nb = neighbours(i);
+    float emax = std::numeric_limits<float>::lowest();
+    for( unsigned k = 0; k < _stride; ++k ) {
+      emax = std::max(emax,energies[nb[k]]);
+    }
+    // the local maxima are the seed candidates
+    if( usable[i] && !(emax > energies[i]) ) candidates.push_back(i);
+  }
+
+  // a seed prevents its neighbours from seeding, this only matters for
+  // neighbours of the same energy or non-symmetric neighbour lists:
+  // go through the candidates by decreasing energy
+  std::stable_sort(candidates.begin(),candidates.end(),
+		   [&](unsigned i, unsigned j) { return energies[i] > energies[j]; });
+  for( auto idx : candidates ) {
+    if( !usable[idx] ) continue;
+    seedable[idx] = true;
+    auto nb = neighbours(idx);
+    for( unsigned k = 0; k < _stride; ++k ) {
+      usable[nb[k]] = false;
+    }
+  }
+}
+
+void PFRecHitNavigationSoA::
+labelTopoClusters(const bool* gatherable,
+		  const std::vector<unsigned>& seeds,
+		  unsigned* labels) {
+  std::fill(labels,labels+_size+1,noLabel);
+  // the seeds expand in turn over the rechits not labelled yet: each rechit
+  // enters the worklist at most once, the rank of the first seed reaching it
+  // being the lowest one
+  _worklist.clear();
+  for( unsigned rank = 0; rank < seeds.size(); ++rank ) {
+    if( labels[seeds[rank]] != noLabel ) continue;
+    labels[seeds[rank]] = rank;
+    _worklist.push_back(seeds[rank]);
+    while( !_worklist.empty() ) {
+      auto nb = neighbours(_worklist.back());
+      _worklist.pop_back();
+      for( unsigned k = 0; k < _stride; ++k ) {
+	if( gatherable[nb[k]] && labels[nb[k]] == noLabel ) {
+	  labels[nb[k]] = rank;
+	  _worklist.push_back(nb[k]);
+	}
+      }
+    }
+  }
+}
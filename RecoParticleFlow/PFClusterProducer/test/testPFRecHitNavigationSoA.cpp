@@ -0,0 +1,179 @@
+// The seeds and topo clusters found on the flat neighbour tables of
+// PFRecHitNavigationSoA against the former algorithms walking the neighbours
+// given by the navigators of the rechits (seeds by decreasing energy, topo
+// clusters by depth-first search from the seeds), on random layers of rechits
+// with equal energies, masked rechits and non-symmetric neighbour lists
+
+#include "RecoParticleFlow/PFClusterProducer/interface/PFRecHitNavigationSoA.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+  reco::PFRecHit::Neighbours neighboursOf(const reco::PFRecHit& hit, int nNeighbours) {
+    switch( nNeighbours ) {
+    case -1: return hit.neighbours();
+    case 4: return hit.neighbours4();
+    case 8: return hit.neighbours8();
+    default: return reco::PFRecHit::Neighbours(nullptr,0);
+    }
+  }
+
+  // nx*ny cells in two depths, some neighbours being dropped from the lists
+  reco::PFRecHitCollection makeHits(unsigned nx, unsigned ny, std::mt19937& rng) {
+    std::uniform_real_distribution<float> flat(0.f,1.f);
+    auto index = [&](int x, int y, int z) { return unsigned((z*ny + y)*nx + x); };
+    reco::PFRecHitCollection hits(2*nx*ny);
+    for( int z = 0; z < 2; ++z ) {
+      for( int y = 0; y < int(ny); ++y ) {
+	for( int x = 0; x < int(nx); ++x ) {
+	  auto& hit = hits[index(x,y,z)];
+	  // few distinct energies, for many equal ones
+	  hit.setEnergy(0.5f*int(8.f*flat(rng)));
+	  for( int dy = -1; dy <= 1; ++dy ) {
+	    for( int dx = -1; dx <= 1; ++dx ) {
+	      if( (dx == 0 && dy == 0) || x+dx < 0 || x+dx >= int(nx) || y+dy < 0 || y+dy >= int(ny) ) continue;
+	      if( flat(rng) < 0.1f ) continue;
+	      hit.addNeighbour(dx,dy,0,index(x+dx,y+dy,z));
+	    }
+	  }
+	  if( flat(rng) < 0.9f ) hit.addNeighbour(0,0,z ? -1 : 1,index(x,y,1-z));
+	}
+      }
+    }
+    return hits;
+  }
+
+  // LocalMaximumSeedFinder with the navigators
+  std::vector<bool> referenceSeeds(const reco::PFRecHitCollection& hits, const std::vector<bool>& mask,
+				   std::vector<bool> usable, int nNeighbours) {
+    std::vector<unsigned> ordered;
+    for( unsigned i = 0; i < hits.size(); ++i ) {
+      if( mask[i] && usable[i] ) ordered.push_back(i);
+    }
+    std::stable_sort(ordered.begin(),ordered.end(),
+		     [&](unsigned i, unsigned j) { return hits[i].energy() > hits[j].energy(); });
+    std::vector<bool> seedable(hits.size(),false);
+    for( auto idx : ordered ) {
+      if( !usable[idx] ) continue;
+      seedable[idx] = true;
+      for( auto nb : neighboursOf(hits[idx],nNeighbours) ) {
+	if( mask[nb] && hits[nb].energy() > hits[idx].energy() ) {
+	  seedable[idx] = false;
+	  break;
+	}
+      }
+      if( seedable[idx] ) {
+	for( auto nb : neighboursOf(hits[idx],nNeighbours) ) usable[nb] = false;
+      }
+    }
+    return seedable;
+  }
+
+  // Basic2DGenericTopoClusterizer with the navigators, the rechits of each
+  // topo cluster sorted
+  void buildTopoCluster(const reco::PFRecHitCollection& hits, const std::vector<bool>& mask,
+			const std::vector<bool>& gatherable, int nNeighbours, unsigned k,
+			std::vector<bool>& used, std::vector<unsigned>& cluster) {
+    if( !gatherable[k] ) return;
+    used[k] = true;
+    cluster.push_back(k);
+    for( auto nb : neighboursOf(hits[k],nNeighbours) ) {
+      if( used[nb] || !mask[nb] ) continue;
+      buildTopoCluster(hits,mask,gatherable,nNeighbours,nb,used,cluster);
+    }
+  }
+
+  std::vector<std::vector<unsigned> > referenceTopoClusters(const reco::PFRecHitCollection& hits,
+							    const std::vector<bool>& mask,
+							    const std::vector<bool>& gatherable,
+							    const std::vector<unsigned>& seeds, int nNeighbours) {
+    std::vector<bool> used(hits.size(),false);
+    std::vector<std::vector<unsigned> > clusters;
+    for( auto seed : seeds ) {
+      if( used[seed] ) continue;
+      clusters.emplace_back();
+      buildTopoCluster(hits,mask,gatherable,nNeighbours,seed,used,clusters.back());
+      std::sort(clusters.back().begin(),clusters.back().end());
+    }
+    return clusters;
+  }
+
+  std::vector<std::vector<unsigned> > topoClusters(const std::vector<unsigned>& labels,
+						   const std::vector<unsigned>& seeds) {
+    std::vector<std::vector<unsigned> > clusters;
+    std::vector<unsigned> clusterOfSeed(seeds.size(),PFRecHitNavigationSoA::noLabel);
+    for( unsigned rank = 0; rank < seeds.size(); ++rank ) {
+      if( labels[seeds[rank]] != rank ) continue;
+      clusterOfSeed[rank] = clusters.size();
+      clusters.emplace_back();
+    }
+    for( unsigned i = 0; i+1 < labels.size(); ++i ) {
+      if( labels[i] != PFRecHitNavigationSoA::noLabel ) clusters[clusterOfSeed[labels[i]]].push_back(i);
+    }
+    return clusters;
+  }
+
+}
+
+int main() {
+  std::mt19937 rng(45);
+  std::uniform_real_distribution<float> flat(0.f,1.f);
+  unsigned failures = 0, nSeeds = 0, nClusters = 0;
+  PFRecHitNavigationSoA navigation;
+
+  for( unsigned event = 0; event < 400; ++event ) {
+    const auto hits = makeHits(1 + event%23, 1 + event%17, rng);
+    const unsigned nhits = hits.size();
+    std::vector<bool> mask(nhits), usable(nhits), gatherable(nhits);
+    for( unsigned i = 0; i < nhits; ++i ) {
+      mask[i] = flat(rng) < 0.9f;
+      usable[i] = mask[i] && flat(rng) < 0.8f;
+      gatherable[i] = mask[i] && flat(rng) < (event%2 ? 0.6f : 0.95f);
+    }
+
+    for( int nNeighbours : {-1, 0, 4, 8} ) {
+      navigation.build(hits,nNeighbours);
+      std::vector<float> energies(nhits+1,std::numeric_limits<float>::lowest());
+      std::unique_ptr<bool[]> usableSoA(new bool[nhits+1]);
+      for( unsigned i = 0; i < nhits; ++i ) {
+	if( mask[i] ) energies[i] = hits[i].energy();
+	usableSoA[i] = usable[i];
+      }
+      usableSoA[nhits] = false;
+      std::vector<bool> seedable(nhits,false);
+      navigation.findLocalMaxima(energies.data(),usableSoA.get(),seedable);
+      if( seedable != referenceSeeds(hits,mask,usable,nNeighbours) ) {
+	if( ++failures <= 10 ) std::cout << "different seeds: event " << event << " nNeighbours " << nNeighbours << std::endl;
+      }
+      nSeeds += std::count(seedable.begin(),seedable.end(),true);
+      if( nNeighbours != 4 && nNeighbours != 8 ) continue;
+
+      // topo clusters from these seeds
+      std::vector<unsigned> seeds;
+      for( unsigned i = 0; i < nhits; ++i ) {
+	if( gatherable[i] && (seedable[i] || flat(rng) < 0.02f) ) seeds.push_back(i);
+      }
+      std::stable_sort(seeds.begin(),seeds.end(),
+		       [&](unsigned i, unsigned j) { return hits[i].energy() > hits[j].energy(); });
+      std::unique_ptr<bool[]> gatherableSoA(new bool[nhits+1]);
+      std::copy(gatherable.begin(),gatherable.end(),gatherableSoA.get());
+      gatherableSoA[nhits] = false;
+      std::vector<unsigned> labels(nhits+1);
+      navigation.labelTopoClusters(gatherableSoA.get(),seeds,labels.data());
+      auto clusters = topoClusters(labels,seeds);
+      if( clusters != referenceTopoClusters(hits,mask,gatherable,seeds,nNeighbours) ) {
+	if( ++failures <= 10 ) std::cout << "different topo clusters: event " << event << " nNeighbours " << nNeighbours << std::endl;
+      }
+      nClusters += clusters.size();
+    }
+  }
+
+  std::cout << nSeeds << " seeds, " << nClusters << " topo clusters, " << failures << " differences" << std::endl;
+  return failures ? 1 : 0;
+}
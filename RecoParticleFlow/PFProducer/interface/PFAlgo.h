@@ -239,16 +239,19 @@ class PFAlgo {
   
  protected:
 
-  /// process one block. can be reimplemented in more sophisticated 
-  /// algorithms
+  /// process one block, adding its candidates to the given collection. 
+  /// can be reimplemented in more sophisticated algorithms
   virtual void processBlock( const reco::PFBlockRef& blockref,
                              std::list<reco::PFBlockRef>& hcalBlockRefs, 
-                             std::list<reco::PFBlockRef>& ecalBlockRefs ); 
+                             std::list<reco::PFBlockRef>& ecalBlockRefs,
+                             reco::PFCandidateCollection* candidates ); 
   
   /// Reconstruct a charged particle from a track
-  /// Returns the index of the newly created candidate in pfCandidates_
+  /// Returns the index of the newly created candidate in candidates
   /// Michalis added a flag here to treat muons inside jets
-  unsigned reconstructTrack( const reco::PFBlockElement& elt,bool allowLoose= false);
+  unsigned reconstructTrack( const reco::PFBlockElement& elt,
+                             reco::PFCandidateCollection* candidates,
+                             bool allowLoose= false);
 
   /// Reconstruct a neutral particle from a cluster. 
   /// If chargedEnergy is specified, the neutral 
@@ -258,6 +261,7 @@ class PFAlgo {
 
   unsigned reconstructCluster( const reco::PFCluster& cluster,
                                double particleEnergy,
+                               reco::PFCandidateCollection* candidates,
 			       bool useDirection = false,
 			       double particleX=0.,
 			       double particleY=0.,
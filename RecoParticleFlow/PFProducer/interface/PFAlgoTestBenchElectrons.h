@@ -32,7 +32,8 @@ class PFAlgoTestBenchElectrons : public PFAlgo {
   /// algorithms
   void processBlock( const reco::PFBlockRef& blockref,
                              std::list<reco::PFBlockRef>& hcalBlockRefs, 
-			     std::list<reco::PFBlockRef>& ecalBlockRefs ) override;
+			     std::list<reco::PFBlockRef>& ecalBlockRefs,
+			     reco::PFCandidateCollection* candidates ) override;
   
 
  private:
@@ -7,7 +7,8 @@ using namespace reco;
  
 void PFAlgoTestBenchConversions::processBlock(const reco::PFBlockRef& blockref,
 					    std::list<PFBlockRef>& hcalBlockRefs,
-					    std::list<PFBlockRef>& ecalBlockRefs)
+					    std::list<PFBlockRef>& ecalBlockRefs,
+					    reco::PFCandidateCollection* candidates)
 {
 
   cout<<"conversions test bench: process block"
@@ -9,36 +9,39 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <atomic>
 #include "TMath.h"
 
+#include "tbb/task_arena.h"
+#include "tbb/tbb.h"
+
 using namespace std;
 using namespace reco;
 
 #define INIT_ENTRY(name) {#name,name}
 
 namespace {
+  // union-find usable concurrently: the roots are only ever attached below
+  // a root of lower index, with compare-and-swap, so that the root of a set
+  // is its lowest element whatever the order of the unions
   class QuickUnion{
-  std::vector<unsigned> id_;
-  std::vector<unsigned> size_;
-  int count_;
+  std::vector<std::atomic<unsigned> > id_;
 
   public:
-    QuickUnion(const unsigned NBranches) {
-      count_ = NBranches;
-      id_.resize(NBranches);
-      size_.resize(NBranches);
+    QuickUnion(const unsigned NBranches) : id_(NBranches) {
       for( unsigned i = 0; i < NBranches; ++i ) {
-	id_[i] = i;
-	size_[i] = 1;
+	id_[i].store(i,std::memory_order_relaxed);
       }
     }
     
-    int count() const { return count_; }
-    
     unsigned find(unsigned p) {
-      while( p != id_[p] ) {
-	id_[p] = id_[id_[p]];
-	p = id_[p];
+      unsigned parent = id_[p].load(std::memory_order_acquire);
+      while( p != parent ) {
+	// path halving, losing the race only costs a longer path
+	unsigned grandparent = id_[parent].load(std::memory_order_acquire);
+	id_[p].compare_exchange_weak(parent,grandparent,std::memory_order_acq_rel);
+	p = grandparent;
+	parent = id_[p].load(std::memory_order_acquire);
       }
       return p;
     }
@@ -46,16 +49,14 @@ namespace {
     bool connected(unsigned p, unsigned q) { return find(p) == find(q); }
     
     void unite(unsigned p, unsigned q) {
-      unsigned rootP = find(p);
-      unsigned rootQ = find(q);
-      id_[p] = q;
-      
-      if(size_[rootP] < size_[rootQ] ) { 
-	id_[rootP] = rootQ; size_[rootQ] += size_[rootP]; 
-      } else { 
-	id_[rootQ] = rootP; size_[rootP] += size_[rootQ]; 
+      while( true ) {
+	unsigned rootP = find(p);
+	unsigned rootQ = find(q);
+	if( rootP == rootQ ) return;
+	if( rootP > rootQ ) std::swap(rootP,rootQ);
+	// attach the higher root, unless it got attached in the meantime
+	if( id_[rootQ].compare_exchange_strong(rootQ,rootP,std::memory_order_acq_rel) ) return;
       }
-      --count_;
     }
   };
 }
@@ -162,9 +163,11 @@ void PFBlockAlgo::findBlocks() {
   else                blocks_.reset( new reco::PFBlockCollection );
   blocks_->reserve(elements_.size());
 
+  // the link tests are run concurrently for the different elements, the
+  // blocks are the connected components whatever the order of the links
   QuickUnion qu(bare_elements_.size());
   const auto elem_size = bare_elements_.size();
-  for( unsigned i = 0; i < elem_size; ++i ) {
+  auto linkElement = [&](unsigned i) {
     for( unsigned j = 0; j < elem_size; ++j ) {
       if( qu.connected(i,j) || j == i ) continue;
       if( !linkTests_[linkTestSquare_[bare_elements_[i]->type()][bare_elements_[j]->type()]] ) {
@@ -183,14 +186,17 @@ void PFBlockAlgo::findBlocks() {
         }
       }
     }
-  }
-  
+  };
+  tbb::this_task_arena::isolate([&] {
+    tbb::parallel_for(0u, unsigned(elem_size), linkElement);
+  });
+
+  // one block per root, i.e. ordered by their lowest element
   std::unordered_multimap<unsigned,unsigned> blocksmap(elements_.size());
   std::vector<unsigned> keys;
   keys.reserve(elements_.size());
   for( unsigned i = 0; i < elements_.size(); ++i ) {
-    unsigned key = i; 
-    while( key != qu.find(key) ) key = qu.find(key); // make sure we always find the root node...
+    const unsigned key = qu.find(i);
     auto pos  = std::lower_bound(keys.begin(),keys.end(),key);
     if( pos == keys.end() || *pos != key ) {
       keys.insert(pos,key);      
@@ -198,12 +204,14 @@ void PFBlockAlgo::findBlocks() {
     blocksmap.emplace(key,i);
   }
 
-  PFBlockLink::Type linktype = PFBlockLink::NONE;
-  PFBlock::LinkTest linktest = PFBlock::LINKTEST_RECHIT;
-  for( auto key : keys ) {
-    blocks_->push_back( reco::PFBlock() );
+  // the blocks are independent, they are filled concurrently
+  blocks_->resize(keys.size());
+  auto fillBlock = [&](unsigned iblock) {
+    const unsigned key = keys[iblock];
+    PFBlockLink::Type linktype = PFBlockLink::NONE;
+    PFBlock::LinkTest linktest = PFBlock::LINKTEST_RECHIT;
     auto range = blocksmap.equal_range(key);
-    auto& the_block = blocks_->back();
+    auto& the_block = (*blocks_)[iblock];
     ElementList::value_type::pointer p1(bare_elements_[range.first->second]);
     the_block.addElement(p1);
     const unsigned block_size = blocksmap.count(key) + 1;
@@ -227,7 +235,10 @@ void PFBlockAlgo::findBlocks() {
       }
     }
     packLinks( the_block, links );    
-  }
+  };
+  tbb::this_task_arena::isolate([&] {
+    tbb::parallel_for(0u, unsigned(keys.size()), fillBlock);
+  });
   
   bare_elements_.clear();
   elements_.clear();
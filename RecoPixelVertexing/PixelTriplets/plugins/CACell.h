@@ -9,292 +9,320 @@
 
 #include <cmath>
 #include <array>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "tbb/concurrent_vector.h"
 
 class CACellStatus {
 
 public:
-  
+
   unsigned char getCAState() const {
     return theCAState;
   }
-  
+
   // if there is at least one left neighbor with the same state (friend), the state has to be increased by 1.
   void updateState() {
     theCAState += hasSameStateNeighbors;
   }
-  
+
   bool isRootCell(const unsigned int minimumCAState) const {
     return (theCAState >= minimumCAState);
   }
-  
+
  public:
   unsigned char theCAState=0;
   unsigned char hasSameStateNeighbors=0;
-  
+
 };
 
+
+// lightweight view on a single cell (i.e. a doublet) stored in CACells
 class CACell {
 public:
   using Hit = RecHitsSortedInPhi::Hit;
   using CAntuple = std::vector<unsigned int>;
   using CAntuplet = std::vector<unsigned int>;
-  using CAColl = std::vector<CACell>;
-  using CAStatusColl = std::vector<CACellStatus>;
-  
-  
-  CACell(const HitDoublets* doublets, int doubletId, const int innerHitId, const int outerHitId) :
-    theDoublets(doublets), theDoubletId(doubletId)
-    ,theInnerR(doublets->rv(doubletId, HitDoublets::inner)) 
-    ,theInnerZ(doublets->z(doubletId, HitDoublets::inner))
-  {}
-
-   
-  
+
+  CACell(const HitDoublets* doublets, int doubletId) :
+    theDoublets(doublets), theDoubletId(doubletId) {}
+
   Hit const & getInnerHit() const {
     return theDoublets->hit(theDoubletId, HitDoublets::inner);
   }
-  
+
   Hit const & getOuterHit() const {
     return theDoublets->hit(theDoubletId, HitDoublets::outer);
   }
-  
-  
-  float getInnerX() const {
-    return theDoublets->x(theDoubletId, HitDoublets::inner);
-  }
-  
-  float getOuterX() const {
-    return theDoublets->x(theDoubletId, HitDoublets::outer);
-  }
-  
-  float getInnerY() const {
-    return theDoublets->y(theDoubletId, HitDoublets::inner);
-  }
-  
-  float getOuterY() const {
-    return theDoublets->y(theDoubletId, HitDoublets::outer);
-  }
-  
-  float getInnerZ() const {
-    return theInnerZ;
-  }
-  
-  float getOuterZ() const {
-    return theDoublets->z(theDoubletId, HitDoublets::outer);
-  }
-  
-  float getInnerR() const {
-    return theInnerR;
-  }
-  
-  float getOuterR() const {
-    return theDoublets->rv(theDoubletId, HitDoublets::outer);
+
+  int getInnerHitId() const {
+    return theDoublets->innerHitId(theDoubletId);
   }
-  
-  float getInnerPhi() const {
-    return theDoublets->phi(theDoubletId, HitDoublets::inner);
+
+private:
+
+  const HitDoublets* theDoublets;
+  const int theDoubletId;
+
+};
+
+
+// flat (SoA) storage of all the cells of the automaton.
+// The connection step fills, for each cell, a fixed capacity array of inner neighbors
+// (spilling into a shared overflow buffer only in the rare case it is full):
+// cells are independent and can be connected concurrently.
+// The outer neighbors used by evolve and findNtuplets are then stored in CSR form.
+class CACells {
+public:
+  using CAntuple = CACell::CAntuple;
+  using CAntuplet = CACell::CAntuplet;
+
+  static constexpr unsigned int maxInnerNeighbors = 8;
+
+  unsigned int size() const { return theDoubletIds.size(); }
+
+  CACell operator[](unsigned int i) const { return CACell(theDoublets[i], theDoubletIds[i]); }
+
+  void reserve(unsigned int n) {
+    theDoublets.reserve(n); theDoubletIds.reserve(n);
+    theInnerX.reserve(n); theInnerY.reserve(n); theInnerZ.reserve(n); theInnerR.reserve(n);
+    theOuterX.reserve(n); theOuterY.reserve(n); theOuterZ.reserve(n); theOuterR.reserve(n);
   }
-  
-  float getOuterPhi() const {
-    return theDoublets->phi(theDoubletId, HitDoublets::outer);
+
+  void emplace_back(const HitDoublets* doublets, int doubletId) {
+    theDoublets.push_back(doublets);
+    theDoubletIds.push_back(doubletId);
+    theInnerX.push_back(doublets->x(doubletId, HitDoublets::inner));
+    theInnerY.push_back(doublets->y(doubletId, HitDoublets::inner));
+    theInnerZ.push_back(doublets->z(doubletId, HitDoublets::inner));
+    theInnerR.push_back(doublets->rv(doubletId, HitDoublets::inner));
+    theOuterX.push_back(doublets->x(doubletId, HitDoublets::outer));
+    theOuterY.push_back(doublets->y(doubletId, HitDoublets::outer));
+    theOuterZ.push_back(doublets->z(doubletId, HitDoublets::outer));
+    theOuterR.push_back(doublets->rv(doubletId, HitDoublets::outer));
   }
-  
-  void evolve(unsigned int me, CAStatusColl& allStatus) {
-    
-    allStatus[me].hasSameStateNeighbors = 0;
-    auto mystate = allStatus[me].theCAState;
-    
-    for (auto oc : theOuterNeighbors ) {
-      
-      if (allStatus[oc].getCAState() == mystate) {
-	
-	allStatus[me].hasSameStateNeighbors = 1;
-	
-	break;
-      }
-    }
-    
+
+  // must be called once all cells have been created and before any connection
+  void resetNeighbors() {
+    theNumberOfInnerNeighbors.assign(size(), 0);
+    theInnerNeighbors.resize(size()*maxInnerNeighbors);
+    theOverflowNeighbors.clear();
   }
-  
 
-  void checkAlignmentAndAct(CAColl& allCells, CAntuple & innerCells, const float ptmin, const float region_origin_x,
-			    const float region_origin_y, const float region_origin_radius, const float thetaCut,
-			    const float phiCut, const float hardPtCut, std::vector<CACell::CAntuplet> * foundTriplets) {
+  // thread safe as long as each cellId is processed by a single thread
+  void checkAlignmentAndConnect(unsigned int cellId, CAntuple const & innerCells, const float ptmin,
+				const float region_origin_x, const float region_origin_y, const float region_origin_radius,
+				const float thetaCut, const float phiCut, const float hardPtCut) {
     int ncells = innerCells.size();
     int constexpr VSIZE = 16;
     int ok[VSIZE];
     float r1[VSIZE];
     float z1[VSIZE];
-    auto ro = getOuterR();
-    auto zo = getOuterZ();
-    unsigned int cellId = this - &allCells.front();
+    auto ro = theOuterR[cellId];
+    auto zo = theOuterZ[cellId];
+    auto ri = theInnerR[cellId];
+    auto zi = theInnerZ[cellId];
+    auto & nn = theNumberOfInnerNeighbors[cellId];
     auto loop = [&](int i, int vs) {
       for (int j=0;j<vs; ++j) {
 	auto koc = innerCells[i+j];
-	auto & oc =  allCells[koc];
-	r1[j] = oc.getInnerR();
-	z1[j] = oc.getInnerZ();
+	r1[j] = theInnerR[koc];
+	z1[j] = theInnerZ[koc];
       }
       // this vectorize!
-      for (int j=0;j<vs; ++j) ok[j] = areAlignedRZ(r1[j], z1[j], ro, zo, ptmin, thetaCut);
+      for (int j=0;j<vs; ++j) ok[j] = areAlignedRZ(r1[j], z1[j], ri, zi, ro, zo, ptmin, thetaCut);
       for (int j=0;j<vs; ++j) {
 	auto koc = innerCells[i+j];
-	auto & oc =  allCells[koc]; 
-	if (ok[j]&&haveSimilarCurvature(oc,ptmin, region_origin_x, region_origin_y,
+	if (ok[j]&&haveSimilarCurvature(koc, cellId, ptmin, region_origin_x, region_origin_y,
 					region_origin_radius, phiCut, hardPtCut)) {
-	  if (foundTriplets) foundTriplets->emplace_back(CACell::CAntuplet{koc,cellId});
-	  else {
-	    oc.tagAsOuterNeighbor(cellId);
-	  }
+	  if (nn<maxInnerNeighbors) theInnerNeighbors[cellId*maxInnerNeighbors + nn++] = koc;
+	  else theOverflowNeighbors.emplace_back(cellId, koc);
 	}
       }
     };
     auto lim = VSIZE*(ncells/VSIZE);
-    for (int i=0; i<lim; i+=VSIZE) loop(i, VSIZE); 
+    for (int i=0; i<lim; i+=VSIZE) loop(i, VSIZE);
     loop(lim, ncells-lim);
-    
   }
-  
-  void checkAlignmentAndTag(CAColl& allCells, CAntuple & innerCells, const float ptmin, const float region_origin_x,
-			    const float region_origin_y, const float region_origin_radius, const float thetaCut,
-			    const float phiCut, const float hardPtCut) {
-    checkAlignmentAndAct(allCells, innerCells, ptmin, region_origin_x, region_origin_y, region_origin_radius, thetaCut,
-			 phiCut, hardPtCut, nullptr);
-    
+
+  // sort the (rare) overflow so that, for each cell, the inner neighbors keep the order of the scan
+  void sortOverflowNeighbors() {
+    std::sort(theOverflowNeighbors.begin(), theOverflowNeighbors.end());
   }
-  void checkAlignmentAndPushTriplet(CAColl& allCells, CAntuple & innerCells, std::vector<CACell::CAntuplet>& foundTriplets,
-				    const float ptmin, const float region_origin_x, const float region_origin_y,
-				    const float region_origin_radius, const float thetaCut, const float phiCut,
-				    const float hardPtCut) {
-    checkAlignmentAndAct(allCells, innerCells, ptmin, region_origin_x, region_origin_y, region_origin_radius, thetaCut,
-			 phiCut, hardPtCut, &foundTriplets);
+
+  // loop over the inner neighbors of all cells in increasing order of (outer, inner) cell
+  template<typename F>
+  void forEachConnection(F f) const {
+    auto ov = theOverflowNeighbors.begin();
+    for (unsigned int c=0; c<size(); ++c) {
+      auto b = &theInnerNeighbors[c*maxInnerNeighbors];
+      for (auto k=b; k!=b+theNumberOfInnerNeighbors[c]; ++k) f(*k, c);
+      for (; ov!=theOverflowNeighbors.end() && ov->first==c; ++ov) f(ov->second, c);
+    }
+  }
+
+  // invert the inner neighbors into the CSR outer neighbors lists,
+  // for each cell the outer neighbors are ordered by increasing cellId
+  void buildOuterNeighbors() {
+    theOuterNeighborsOffsets.assign(size()+1, 0);
+    forEachConnection([&](unsigned int inner, unsigned int) { ++theOuterNeighborsOffsets[inner+1]; });
+    for (unsigned int c=0; c<size(); ++c) theOuterNeighborsOffsets[c+1] += theOuterNeighborsOffsets[c];
+    theOuterNeighbors.resize(theOuterNeighborsOffsets.back());
+    std::vector<unsigned int> filled(theOuterNeighborsOffsets.begin(), theOuterNeighborsOffsets.end()-1);
+    forEachConnection([&](unsigned int inner, unsigned int outer) { theOuterNeighbors[filled[inner]++] = outer; });
+  }
+
+  unsigned int const * outerNeighborsBegin(unsigned int i) const { return theOuterNeighbors.data() + theOuterNeighborsOffsets[i]; }
+  unsigned int const * outerNeighborsEnd(unsigned int i) const { return theOuterNeighbors.data() + theOuterNeighborsOffsets[i+1]; }
+
+  void evolve(unsigned int me, std::vector<CACellStatus>& allStatus) const {
+
+    allStatus[me].hasSameStateNeighbors = 0;
+    auto mystate = allStatus[me].theCAState;
+
+    for (auto oc = outerNeighborsBegin(me); oc != outerNeighborsEnd(me); ++oc) {
+
+      if (allStatus[*oc].getCAState() == mystate) {
+
+	allStatus[me].hasSameStateNeighbors = 1;
+
+	break;
+      }
+    }
+
   }
-  
-  
-  int areAlignedRZ(float r1, float z1, float ro, float zo, const float ptmin, const float thetaCut) const
+
+
+  static int areAlignedRZ(float r1, float z1, float ri, float zi, float ro, float zo, const float ptmin, const float thetaCut)
   {
     float radius_diff = std::abs(r1 - ro);
     float distance_13_squared = radius_diff*radius_diff + (z1 - zo)*(z1 - zo);
-    
+
     float pMin = ptmin*std::sqrt(distance_13_squared); //this needs to be divided by radius_diff later
-    
-    float tan_12_13_half_mul_distance_13_squared = fabs(z1 * (getInnerR() - ro) + getInnerZ() * (ro - r1) + zo * (r1 - getInnerR())) ;
+
+    float tan_12_13_half_mul_distance_13_squared = fabs(z1 * (ri - ro) + zi * (ro - r1) + zo * (r1 - ri)) ;
     return tan_12_13_half_mul_distance_13_squared * pMin <= thetaCut * distance_13_squared * radius_diff;
   }
-  
-  
-  void tagAsOuterNeighbor(unsigned int otherCell)
-  {
-    theOuterNeighbors.push_back(otherCell);
-  }
-  
-  
-  bool haveSimilarCurvature(const CACell & otherCell, const float ptmin,
+
+
+  bool haveSimilarCurvature(unsigned int otherCell, unsigned int cellId, const float ptmin,
 			    const float region_origin_x, const float region_origin_y, const float region_origin_radius, const float phiCut, const float hardPtCut) const
   {
-    
-    
-    auto x1 = otherCell.getInnerX();
-    auto y1 = otherCell.getInnerY();
-    
-    auto x2 = getInnerX();
-    auto y2 = getInnerY();
-    
-    auto x3 = getOuterX();
-    auto y3 = getOuterY();
-    
+
+
+    auto x1 = theInnerX[otherCell];
+    auto y1 = theInnerY[otherCell];
+
+    auto x2 = theInnerX[cellId];
+    auto y2 = theInnerY[cellId];
+
+    auto x3 = theOuterX[cellId];
+    auto y3 = theOuterY[cellId];
+
     float distance_13_squared = (x1 - x3)*(x1 - x3) + (y1 - y3)*(y1 - y3);
     float tan_12_13_half_mul_distance_13_squared = std::abs(y1 * (x2 - x3) + y2 * (x3 - x1) + y3 * (x1 - x2)) ;
     // high pt : just straight
     if(tan_12_13_half_mul_distance_13_squared * ptmin <= 1.0e-4f*distance_13_squared)
       {
-	
+
 	float distance_3_beamspot_squared = (x3-region_origin_x) * (x3-region_origin_x) + (y3-region_origin_y) * (y3-region_origin_y);
-	
+
 	float dot_bs3_13 = ((x1 - x3)*( region_origin_x - x3) + (y1 - y3) * (region_origin_y-y3));
 	float proj_bs3_on_13_squared = dot_bs3_13*dot_bs3_13/distance_13_squared;
-	
+
 	float distance_13_beamspot_squared  = distance_3_beamspot_squared -  proj_bs3_on_13_squared;
-	
+
 	return distance_13_beamspot_squared < (region_origin_radius+phiCut)*(region_origin_radius+phiCut);
       }
-    
+
     //87 cm/GeV = 1/(3.8T * 0.3)
-    
+
     //take less than radius given by the hardPtCut and reject everything below
     float minRadius = hardPtCut*87.f;  // FIXME move out and use real MagField
-    
+
     auto det = (x1 - x2) * (y2 - y3) - (x2 - x3) * (y1 - y2);
-    
-    
+
+
     auto offset = x2 * x2 + y2*y2;
-    
+
     auto bc = (x1 * x1 + y1 * y1 - offset)*0.5f;
-    
+
     auto cd = (offset - x3 * x3 - y3 * y3)*0.5f;
-    
-    
-    
+
+
+
     auto idet = 1.f / det;
-    
+
     auto x_center = (bc * (y2 - y3) - cd * (y1 - y2)) * idet;
     auto y_center = (cd * (x1 - x2) - bc * (x2 - x3)) * idet;
-    
+
     auto radius = std::sqrt((x2 - x_center)*(x2 - x_center) + (y2 - y_center)*(y2 - y_center));
-    
+
     if(radius < minRadius)  return false;  // hard cut on pt
-    
+
     auto centers_distance_squared = (x_center - region_origin_x)*(x_center - region_origin_x) + (y_center - region_origin_y)*(y_center - region_origin_y);
     auto region_origin_radius_plus_tolerance = region_origin_radius + phiCut;
     auto minimumOfIntersectionRange = (radius - region_origin_radius_plus_tolerance)*(radius - region_origin_radius_plus_tolerance);
-    
+
     if (centers_distance_squared >= minimumOfIntersectionRange) {
       auto maximumOfIntersectionRange = (radius + region_origin_radius_plus_tolerance)*(radius + region_origin_radius_plus_tolerance);
       return centers_distance_squared <= maximumOfIntersectionRange;
-    } 
-    
+    }
+
     return false;
-    
+
   }
-  
-  
+
+
   // trying to free the track building process from hardcoded layers, leaving the visit of the graph
   // based on the neighborhood connections between cells.
-  
-  void findNtuplets(CAColl& allCells, std::vector<CAntuplet>& foundNtuplets, CAntuplet& tmpNtuplet, const unsigned int minHitsPerNtuplet) const {
-    
+
+  void findNtuplets(unsigned int me, std::vector<CAntuplet>& foundNtuplets, CAntuplet& tmpNtuplet, const unsigned int minHitsPerNtuplet) const {
+
     // the building process for a track ends if:
     // it has no outer neighbor
     // it has no compatible neighbor
     // the ntuplets is then saved if the number of hits it contains is greater than a threshold
-    
+
     if (tmpNtuplet.size() == minHitsPerNtuplet - 1)
       {
 	foundNtuplets.push_back(tmpNtuplet);
       }
     else
       {
-	unsigned int numberOfOuterNeighbors = theOuterNeighbors.size();
-	for (unsigned int i = 0; i < numberOfOuterNeighbors; ++i) {
-	  tmpNtuplet.push_back((theOuterNeighbors[i]));
-	  allCells[theOuterNeighbors[i]].findNtuplets(allCells,foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
+	for (auto oc = outerNeighborsBegin(me); oc != outerNeighborsEnd(me); ++oc) {
+	  tmpNtuplet.push_back(*oc);
+	  findNtuplets(*oc, foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
 	  tmpNtuplet.pop_back();
 	}
       }
-    
+
   }
-  
-  
+
+
 private:
-  
-  CAntuple theOuterNeighbors;
-  
-  const HitDoublets* theDoublets;  
-  const int theDoubletId;
-  
-  const float theInnerR;
-  const float theInnerZ;
-  
+
+  std::vector<const HitDoublets*> theDoublets;
+  std::vector<int> theDoubletIds;
+
+  std::vector<float> theInnerX;
+  std::vector<float> theInnerY;
+  std::vector<float> theInnerZ;
+  std::vector<float> theInnerR;
+  std::vector<float> theOuterX;
+  std::vector<float> theOuterY;
+  std::vector<float> theOuterZ;
+  std::vector<float> theOuterR;
+
+  std::vector<unsigned char> theNumberOfInnerNeighbors;
+  std::vector<unsigned int> theInnerNeighbors;
+  tbb::concurrent_vector<std::pair<unsigned int, unsigned int>> theOverflowNeighbors;
+
+  std::vector<unsigned int> theOuterNeighborsOffsets;
+  std::vector<unsigned int> theOuterNeighbors;
+
 };
 
 
@@ -1,20 +1,17 @@
 #include "CellularAutomaton.h"
 
 #include<queue>
+#include<cassert>
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
 
-void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublets *>& hitDoublets, const TrackingRegion& region,
-		const float thetaCut, const float phiCut, const float hardPtCut)
+void CellularAutomaton::createCells(const std::vector<const HitDoublets *>& hitDoublets)
 {
         int tsize=0;
         for ( auto hd :  hitDoublets) tsize+=hd->size();
         allCells.reserve(tsize);
         unsigned int cellId = 0;
-	float ptmin = region.ptMin();
-	float region_origin_x = region.origin().x();
-	float region_origin_y = region.origin().y();
-	float region_origin_radius = region.originRBound();
-
 	std::vector<bool> alreadyVisitedLayerPairs;
 	alreadyVisitedLayerPairs.resize(theLayerGraph.theLayerPairs.size());
 	for (auto visited : alreadyVisitedLayerPairs)
@@ -60,23 +57,11 @@ void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublet
 				currentLayerPairRef.theFoundCells[1] = cellId+numberOfDoublets;
 				for (unsigned int i = 0; i < numberOfDoublets; ++i)
 				{
-				  allCells.emplace_back(doubletLayerPairId, i,
-							doubletLayerPairId->innerHitId(i),
-							doubletLayerPairId->outerHitId(i));
-				  
-										  
-				  currentOuterLayerRef.isOuterHitOfCell[doubletLayerPairId->outerHitId(i)].push_back(cellId);
-														     
-				  cellId++;
+				  allCells.emplace_back(doubletLayerPairId, i);
 
-				  auto & neigCells = currentInnerLayerRef.isOuterHitOfCell[doubletLayerPairId->innerHitId(i)];
-				  allCells.back().checkAlignmentAndTag(allCells,
-								       neigCells, ptmin, region_origin_x,
-								       region_origin_y, region_origin_radius, thetaCut,
-								       phiCut, hardPtCut
-								       );
-				  
+				  currentOuterLayerRef.isOuterHitOfCell[doubletLayerPairId->outerHitId(i)].push_back(cellId);
 
+				  cellId++;
 				}
 				assert(cellId==currentLayerPairRef.theFoundCells[1]);
 				for (auto outerLayerPair : currentOuterLayerRef.theOuterLayerPairs)
@@ -99,6 +84,47 @@ void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublet
 
 }
 
+void CellularAutomaton::connectCells(const TrackingRegion& region,
+		const float thetaCut, const float phiCut, const float hardPtCut)
+{
+	float ptmin = region.ptMin();
+	float region_origin_x = region.origin().x();
+	float region_origin_y = region.origin().y();
+	float region_origin_radius = region.originRBound();
+
+	allCells.resetNeighbors();
+
+	// all the cells ending on the inner layer of a pair are known once createCells is done:
+	// each cell only writes its own inner neighbors, so they can be connected in parallel
+	for (auto const & layerPair : theLayerGraph.theLayerPairs)
+	{
+		auto const & innerLayer = theLayerGraph.theLayers[layerPair.theLayers[0]];
+		auto const & foundCells = layerPair.theFoundCells;
+		tbb::parallel_for(tbb::blocked_range<unsigned int>(foundCells[0], foundCells[1], 64),
+			[&](const tbb::blocked_range<unsigned int>& r)
+			{
+				for (auto cellId = r.begin(); cellId != r.end(); ++cellId)
+				{
+				  auto cell = allCells[cellId];
+				  auto const & neigCells = innerLayer.isOuterHitOfCell[cell.getInnerHitId()];
+				  allCells.checkAlignmentAndConnect(cellId, neigCells, ptmin, region_origin_x,
+								    region_origin_y, region_origin_radius, thetaCut,
+								    phiCut, hardPtCut);
+				}
+			});
+	}
+
+	allCells.sortOverflowNeighbors();
+}
+
+void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublets *>& hitDoublets, const TrackingRegion& region,
+		const float thetaCut, const float phiCut, const float hardPtCut)
+{
+	createCells(hitDoublets);
+	connectCells(region, thetaCut, phiCut, hardPtCut);
+	allCells.buildOuterNeighbors();
+}
+
 void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet)
 {
   allStatus.resize(allCells.size());
@@ -109,20 +135,19 @@ void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet)
   for (unsigned int iteration = 0; iteration < numberOfIterations - 1;
        ++iteration)
     {
-      for (auto& layerPair : theLayerGraph.theLayerPairs)
+      // evolve only reads the state of the neighbors: all cells can be evolved concurrently
+      tbb::parallel_for(tbb::blocked_range<unsigned int>(0, allCells.size(), 256),
+	[&](const tbb::blocked_range<unsigned int>& r)
 	{
-	  for (auto i =layerPair.theFoundCells[0]; i<layerPair.theFoundCells[1]; ++i)
+	  for (auto i = r.begin(); i != r.end(); ++i)
 	    {
-	      allCells[i].evolve(i,allStatus);
+	      allCells.evolve(i,allStatus);
 	    }
-	}
-      
-      for (auto& layerPair : theLayerGraph.theLayerPairs)
+	});
+
+      for (auto& cell : allStatus)
 	{
-	  for (auto i =layerPair.theFoundCells[0]; i<layerPair.theFoundCells[1]; ++i)
-	    {
-	      allStatus[i].updateState();
-	    }
+	  cell.updateState();
 	}
       
     }
@@ -138,7 +163,7 @@ void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet)
 	  for (auto i =foundCells[0]; i<foundCells[1]; ++i)
 	    {
 	      auto & cell =  allStatus[i];
-	      allCells[i].evolve(i,allStatus);
+	      allCells.evolve(i,allStatus);
 	      cell.updateState();
 	      if (cell.isRootCell(minHitsPerNtuplet - 2))
 		{
@@ -161,7 +186,7 @@ void CellularAutomaton::findNtuplets(
 	{
 	  tmpNtuplet.clear();
 	  tmpNtuplet.push_back(root_cell);
-	  allCells[root_cell].findNtuplets(allCells,foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
+	  allCells.findNtuplets(root_cell, foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
 	}
 
 }
@@ -170,96 +195,11 @@ void CellularAutomaton::findNtuplets(
 void CellularAutomaton::findTriplets(const std::vector<const HitDoublets*>& hitDoublets,std::vector<CACell::CAntuplet>& foundTriplets, const TrackingRegion& region,
 		const float thetaCut, const float phiCut, const float hardPtCut)
 {
-        int tsize=0;
-        for ( auto hd :  hitDoublets) tsize+=hd->size();
-        allCells.reserve(tsize);
+	createCells(hitDoublets);
+	connectCells(region, thetaCut, phiCut, hardPtCut);
 
-        unsigned int cellId = 0;
-	float ptmin = region.ptMin();
-	float region_origin_x = region.origin().x();
-	float region_origin_y = region.origin().y();
-	float region_origin_radius = region.originRBound();
-
-	std::vector<bool> alreadyVisitedLayerPairs;
-	alreadyVisitedLayerPairs.resize(theLayerGraph.theLayerPairs.size());
-	for (auto visited : alreadyVisitedLayerPairs)
-	{
-		visited = false;
-	}
-	for (int rootVertex : theLayerGraph.theRootLayers)
+	allCells.forEachConnection([&](unsigned int inner, unsigned int outer)
 	{
-
-		std::queue<int> LayerPairsToVisit;
-
-		for (int LayerPair : theLayerGraph.theLayers[rootVertex].theOuterLayerPairs)
-		{
-			LayerPairsToVisit.push(LayerPair);
-
-		}
-
-		unsigned int numberOfLayerPairsToVisitAtThisDepth =
-				LayerPairsToVisit.size();
-
-		while (!LayerPairsToVisit.empty())
-		{
-			auto currentLayerPair = LayerPairsToVisit.front();
-			auto & currentLayerPairRef = theLayerGraph.theLayerPairs[currentLayerPair];
-			auto & currentInnerLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[0]];
-			auto & currentOuterLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[1]];
-			bool allInnerLayerPairsAlreadyVisited	{ true };
-
-			for (auto innerLayerPair : currentInnerLayerRef.theInnerLayerPairs)
-			{
-				allInnerLayerPairsAlreadyVisited &=
-						alreadyVisitedLayerPairs[innerLayerPair];
-			}
-
-			if (alreadyVisitedLayerPairs[currentLayerPair] == false
-					&& allInnerLayerPairsAlreadyVisited)
-			{
-
-				const HitDoublets* doubletLayerPairId =
-						hitDoublets[currentLayerPair];
-				auto numberOfDoublets = doubletLayerPairId->size();
-				currentLayerPairRef.theFoundCells[0] = cellId;
-				currentLayerPairRef.theFoundCells[1] = cellId+numberOfDoublets;
-				for (unsigned int i = 0; i < numberOfDoublets; ++i)
-				{
-				  allCells.emplace_back(doubletLayerPairId, i,
-							doubletLayerPairId->innerHitId(i),
-							doubletLayerPairId->outerHitId(i));
-				  
-										  
-				  currentOuterLayerRef.isOuterHitOfCell[doubletLayerPairId->outerHitId(i)].push_back(cellId);
-														     
-				  cellId++;
-
-				  auto & neigCells = currentInnerLayerRef.isOuterHitOfCell[doubletLayerPairId->innerHitId(i)];
-				  allCells.back().checkAlignmentAndPushTriplet(allCells,
-									       neigCells, foundTriplets, ptmin, region_origin_x,
-									       region_origin_y, region_origin_radius, thetaCut,
-									       phiCut, hardPtCut
-									       );
-				}
-				assert(cellId==currentLayerPairRef.theFoundCells[1]);
-
-
-				for (auto outerLayerPair : currentOuterLayerRef.theOuterLayerPairs)
-				{
-					LayerPairsToVisit.push(outerLayerPair);
-				}
-
-				alreadyVisitedLayerPairs[currentLayerPair] = true;
-			}
-			LayerPairsToVisit.pop();
-			numberOfLayerPairsToVisitAtThisDepth--;
-			if (numberOfLayerPairsToVisitAtThisDepth == 0)
-			{
-				numberOfLayerPairsToVisitAtThisDepth = LayerPairsToVisit.size();
-			}
-
-		}
-
-	}
-
+		foundTriplets.emplace_back(CACell::CAntuplet{inner,outer});
+	});
 }
@@ -14,7 +14,7 @@ public:
     
   }
   
-  std::vector<CACell> & getAllCells() { return allCells;}
+  CACells const & getAllCells() const { return allCells;}
   
   void createAndConnectCells(const std::vector<const HitDoublets *>&,
 			     const TrackingRegion&, const float, const float, const float);
@@ -25,13 +25,17 @@ public:
 		    const float thetaCut, const float phiCut, const float hardPtCut);
   
 private:
+  // creates the cells visiting the layer pairs from the root layers outwards
+  void createCells(const std::vector<const HitDoublets *>&);
+  // connects each cell to its compatible inner neighbors, cells are processed concurrently
+  void connectCells(const TrackingRegion&, const float, const float, const float);
+
   CAGraph & theLayerGraph;
 
-  std::vector<CACell> allCells;
+  CACells allCells;
   std::vector<CACellStatus> allStatus;
 
   std::vector<unsigned int> theRootCells;
-  std::vector<std::vector<CACell*> > theNtuplets;
   
 };
 
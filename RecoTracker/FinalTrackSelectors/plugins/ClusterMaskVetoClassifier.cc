@@ -0,0 +1,128 @@
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+
+#include "DataFormats/Common/interface/ContainerMask.h"
+#include "DataFormats/Common/interface/DetSetVectorNew.h"
+#include "DataFormats/SiPixelCluster/interface/SiPixelCluster.h"
+#include "DataFormats/SiStripCluster/interface/SiStripCluster.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "DataFormats/TrackReco/interface/TrackFwd.h"
+#include "DataFormats/TrackerRecHit2D/interface/BaseTrackerRecHit.h"
+#include "DataFormats/TrackerRecHit2D/interface/OmniClusterRef.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiStripMatchedRecHit2D.h"
+
+#include<vector>
+#include<memory>
+#include<cassert>
+
+/*
+ * Applies the cluster mask of an iteration to the output of its classifier:
+ * tracks with more than maxMaskedHits hits on masked clusters lose all the quality bits.
+ * Used when an iteration is run speculatively on the full cluster collections
+ * (i.e. without waiting for the tracks of the previous iterations),
+ * the masking is then done here at selection time.
+ */
+namespace {
+  class ClusterMaskVetoClassifier final : public edm::global::EDProducer<> {
+   public:
+    explicit ClusterMaskVetoClassifier(const edm::ParameterSet& conf) :
+      src_(consumes<reco::TrackCollection>(conf.getParameter<edm::InputTag>("src"))),
+      srcMVA_(consumes<MVACollection>(edm::InputTag(conf.getParameter<std::string>("inputClassifier"),"MVAValues"))),
+      srcQual_(consumes<QualityMaskCollection>(edm::InputTag(conf.getParameter<std::string>("inputClassifier"),"QualityMasks"))),
+      maskPixels_(consumes<PixelMask>(conf.getParameter<edm::InputTag>("clustersToSkip"))),
+      maskStrips_(consumes<StripMask>(conf.getParameter<edm::InputTag>("clustersToSkip"))),
+      maxMaskedHits_(conf.getParameter<int>("maxMaskedHits")) {
+
+      produces<MVACollection>("MVAValues");
+      produces<QualityMaskCollection>("QualityMasks");
+
+    }
+
+    static void  fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+      edm::ParameterSetDescription desc;
+      desc.add<edm::InputTag>("src",edm::InputTag());
+      desc.add<std::string>("inputClassifier",std::string());
+      desc.add<edm::InputTag>("clustersToSkip",edm::InputTag());
+      desc.add<int>("maxMaskedHits",0);
+      descriptions.add("ClusterMaskVetoClassifier", desc);
+    }
+
+   private:
+
+      using MVACollection = std::vector<float>;
+      using QualityMaskCollection = std::vector<unsigned char>;
+      using PixelMask = edm::ContainerMask<edmNew::DetSetVector<SiPixelCluster> >;
+      using StripMask = edm::ContainerMask<edmNew::DetSetVector<SiStripCluster> >;
+
+      void produce(edm::StreamID, edm::Event& evt, const edm::EventSetup&) const override {
+
+	edm::Handle<reco::TrackCollection> htracks;
+	evt.getByToken(src_, htracks);
+	auto const & tracks = *htracks;
+
+	edm::Handle<MVACollection> hmva;
+	evt.getByToken(srcMVA_, hmva);
+	edm::Handle<QualityMaskCollection> hqual;
+	evt.getByToken(srcQual_, hqual);
+	assert((*hqual).size()==tracks.size());
+
+	edm::Handle<PixelMask> hpixels;
+	evt.getByToken(maskPixels_, hpixels);
+	edm::Handle<StripMask> hstrips;
+	evt.getByToken(maskStrips_, hstrips);
+	auto const & pixelMask = *hpixels;
+	auto const & stripMask = *hstrips;
+
+	auto masked = [&](OmniClusterRef const & ref) -> bool {
+	  return ref.isPixel() ? pixelMask.mask(ref.key()) : stripMask.mask(ref.key());
+	};
+
+	// products
+	auto mvas = std::make_unique<MVACollection>(*hmva);
+	auto quals = std::make_unique<QualityMaskCollection>(*hqual);
+
+	for (auto j=0U; j!=tracks.size(); ++j) {
+	  if ((*quals)[j]==0) continue;
+	  int nMasked=0;
+	  for (auto it = tracks[j].recHitsBegin(); it != tracks[j].recHitsEnd(); ++it) {
+	    auto const & hit = **it;
+	    if (!hit.isValid() || trackerHitRTTI::isUndef(hit) || trackerHitRTTI::isFast(hit) || trackerHitRTTI::isMulti(hit)) continue;
+	    if (trackerHitRTTI::isMatched(hit)) {
+	      auto const & mhit = static_cast<SiStripMatchedRecHit2D const &>(hit);
+	      nMasked += masked(mhit.monoClusterRef()) || masked(mhit.stereoClusterRef());
+	    } else {
+	      nMasked += masked(static_cast<BaseTrackerRecHit const &>(hit).firstClusterRef());
+	    }
+	    if (nMasked>maxMaskedHits_) break;
+	  }
+	  if (nMasked>maxMaskedHits_) {
+	    (*mvas)[j] = -1.f;
+	    (*quals)[j] = 0;
+	  }
+	}
+
+	evt.put(std::move(mvas),"MVAValues");
+	evt.put(std::move(quals),"QualityMasks");
+
+      }
+
+      edm::EDGetTokenT<reco::TrackCollection> src_;
+      edm::EDGetTokenT<MVACollection> srcMVA_;
+      edm::EDGetTokenT<QualityMaskCollection> srcQual_;
+      edm::EDGetTokenT<PixelMask> maskPixels_;
+      edm::EDGetTokenT<StripMask> maskStrips_;
+      const int maxMaskedHits_;
+
+  };
+}
+
+
+#include "FWCore/PluginManager/interface/ModuleDef.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+DEFINE_FWK_MODULE(ClusterMaskVetoClassifier);
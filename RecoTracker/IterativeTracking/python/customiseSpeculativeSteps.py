@@ -0,0 +1,42 @@
+import FWCore.ParameterSet.Config as cms
+import RecoTracker.IterativeTracking.iterativeTkConfig as _cfg
+from RecoTracker.FinalTrackSelectors.ClusterMaskVetoClassifier_cfi import ClusterMaskVetoClassifier as _ClusterMaskVetoClassifier
+
+# Run some iterations speculatively: their seeding and pattern recognition
+# no longer skip the clusters used by the previous iterations, so they do
+# not wait for them and can run concurrently with the rest of the chain.
+# The cluster mask of the iteration is instead applied at selection time
+# by ClusterMaskVetoClassifier, which replaces the final classifier of the
+# iteration (keeping its label, so the downstream consumers are unchanged).
+#
+# The default steps are the strip-only ones: they are the last in the chain
+# and their seeding does not depend on the pixel tracks.
+
+def _removeClusterMasking(pset, clusters):
+    for name in pset.parameterNames_():
+        par = getattr(pset, name)
+        if isinstance(par, cms.PSet):
+            _removeClusterMasking(par, clusters)
+        elif name in ("skipClusters", "clustersToSkip") and isinstance(par, cms.InputTag) and par.getModuleLabel() == clusters:
+            delattr(pset, name)
+
+def customiseSpeculativeSteps(process, steps=["PixelLessStep", "TobTecStep"]):
+    for step in steps:
+        pre = _cfg._modulePrefix(step)
+        clusters = _cfg._clusterRemover(step)
+        if not hasattr(process, clusters) or not hasattr(process, pre):
+            continue
+
+        for producer in process.producers_().values():
+            _removeClusterMasking(producer, clusters)
+
+        unmasked = getattr(process, pre).clone()
+        setattr(process, pre+"Unmasked", unmasked)
+        setattr(process, pre, _ClusterMaskVetoClassifier.clone(
+            src = _cfg._tracks(step),
+            inputClassifier = pre+"Unmasked",
+            clustersToSkip = clusters
+        ))
+        getattr(process, step+"Task").add(unmasked)
+
+    return process
@@ -0,0 +1,92 @@
+#ifndef RecoTracker_TkTrackingRegions_TrackingRegionModuleSelector_h
+#define RecoTracker_TkTrackingRegions_TrackingRegionModuleSelector_h
+
+/** \class TrackingRegionModuleSelector
+ *
+ * Input: one or several collections of TrackingRegions (as produced by the
+ *        TrackingRegionEDProducerT modules) and optional eta/phi margins.
+ * Output: the sorted detIds of the pixel and strip modules that the regions
+ *         may touch, to restrict the raw-to-cluster step of regional paths.
+ *
+ * A module is kept if its (r,z) extent seen from the origin bounds of a
+ * RectangularEtaPhiTrackingRegion overlaps the eta range of the region and
+ * its phi extent overlaps the phi window widened by the bending of a ptMin
+ * track. Any other kind of region (e.g. GlobalTrackingRegion) selects the
+ * whole tracker.
+ */
+
+#include "FWCore/Framework/interface/ConsumesCollector.h"
+#include "FWCore/Framework/interface/ESWatcher.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "DataFormats/Common/interface/OwnVector.h"
+#include "Geometry/Records/interface/TrackerDigiGeometryRecord.h"
+#include "RecoTracker/TkTrackingRegions/interface/TrackingRegion.h"
+
+#include <vector>
+
+class RectangularEtaPhiTrackingRegion;
+
+class TrackingRegionModuleSelector {
+public:
+
+  TrackingRegionModuleSelector(const edm::ParameterSet& conf, edm::ConsumesCollector && iC);
+
+  /// has to be run during each event
+  void run(const edm::Event& ev, const edm::EventSetup& es);
+
+  /// true if a region is not restricted in eta-phi: all the modules are to be unpacked
+  bool all() const { return all_; }
+
+  /// sorted detIds of the selected modules (empty if all())
+  const std::vector<unsigned int>& pixelModules() const { return pixelModules_; }
+  const std::vector<unsigned int>& stripModules() const { return stripModules_; }
+
+  unsigned int nRegions() const { return nRegions_; }
+  unsigned int nPixelModulesTotal() const { return nPixelTotal_; }
+  unsigned int nStripModulesTotal() const { return nStripTotal_; }
+
+  /// module seen as a ball of radius halfSize around its center
+  struct Module {
+    float r, z, phi;
+    float halfSize;
+    unsigned int id;
+    bool pixel;
+  };
+
+  /// eta-phi window of a region, its margins widened by extraEta and extraPhi, in a field bz [T]
+  struct Window {
+    float etaMin, etaMax;
+    float phi0, phiLeft, phiRight;
+    float zoLo, zoHi;
+    float rb;
+    float rho; ///< radius of curvature of a ptMin track [cm], 0 without field
+  };
+
+  static Window window(const RectangularEtaPhiTrackingRegion& region, float bz, float extraEta, float extraPhi);
+
+  /// true if a track of the window may cross the module
+  static bool touches(const Module& m, const Window& w);
+
+private:
+
+  void initialize(const edm::EventSetup& es);
+  void addRegion(const RectangularEtaPhiTrackingRegion& region, float bz, std::vector<char>& selected) const;
+
+  std::vector<edm::EDGetTokenT<edm::OwnVector<TrackingRegion> > > tRegions_;
+  const float extraEta_;
+  const float extraPhi_;
+
+  edm::ESWatcher<TrackerDigiGeometryRecord> geometryWatcher_;
+  std::vector<Module> modules_;
+  unsigned int nPixelTotal_ = 0;
+  unsigned int nStripTotal_ = 0;
+
+  bool all_ = true;
+  unsigned int nRegions_ = 0;
+  std::vector<unsigned int> pixelModules_;
+  std::vector<unsigned int> stripModules_;
+};
+
+#endif
@@ -0,0 +1,127 @@
+#include "RecoTracker/TkTrackingRegions/interface/TrackingRegionModuleSelector.h"
+#include "RecoTracker/TkTrackingRegions/interface/RectangularEtaPhiTrackingRegion.h"
+
+#include "DataFormats/Math/interface/deltaPhi.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "Geometry/CommonDetUnit/interface/GeomDetEnumerators.h"
+#include "Geometry/TrackerGeometryBuilder/interface/TrackerGeometry.h"
+#include "MagneticField/Engine/interface/MagneticField.h"
+#include "MagneticField/Records/interface/IdealMagneticFieldRecord.h"
+
+#include <algorithm>
+#include <cmath>
+
+TrackingRegionModuleSelector::TrackingRegionModuleSelector(const edm::ParameterSet& conf, edm::ConsumesCollector && iC) :
+  extraEta_(conf.getParameter<double>("extraEta")),
+  extraPhi_(conf.getParameter<double>("extraPhi"))
+{
+  for (auto const& tag : conf.getParameter<std::vector<edm::InputTag> >("inputs"))
+    tRegions_.push_back(iC.consumes<edm::OwnVector<TrackingRegion> >(tag));
+}
+
+void TrackingRegionModuleSelector::initialize(const edm::EventSetup& es) {
+  if (!geometryWatcher_.check(es)) return;
+
+  edm::ESHandle<TrackerGeometry> geom;
+  es.get<TrackerDigiGeometryRecord>().get(geom);
+
+  modules_.clear();
+  nPixelTotal_ = nStripTotal_ = 0;
+  for (auto det : geom->detUnits()) {
+    auto const& surface = det->surface();
+    auto const& pos = surface.position();
+    Module m;
+    m.r = pos.perp();
+    m.z = pos.z();
+    m.phi = pos.barePhi();
+    m.halfSize = 0.5f*std::hypot(surface.bounds().length(), surface.bounds().width());
+    m.id = det->geographicalId().rawId();
+    m.pixel = GeomDetEnumerators::isTrackerPixel(det->subDetector());
+    if (m.pixel) ++nPixelTotal_; else ++nStripTotal_;
+    modules_.push_back(m);
+  }
+}
+
+void TrackingRegionModuleSelector::run(const edm::Event& ev, const edm::EventSetup& es) {
+  initialize(es);
+
+  all_ = tRegions_.empty();
+  nRegions_ = 0;
+  pixelModules_.clear();
+  stripModules_.clear();
+
+  edm::ESHandle<MagneticField> field;
+  es.get<IdealMagneticFieldRecord>().get(field);
+  const float bz = field->inTesla(GlobalPoint(0,0,0)).z();
+
+  std::vector<char> selected(modules_.size(), 0);
+  for (auto const& token : tRegions_) {
+    edm::Handle<edm::OwnVector<TrackingRegion> > regions;
+    ev.getByToken(token, regions);
+    for (auto const& region : *regions) {
+      ++nRegions_;
+      auto const* etaPhiRegion = dynamic_cast<const RectangularEtaPhiTrackingRegion*>(&region);
+      if (!etaPhiRegion) { all_ = true; break; }
+      addRegion(*etaPhiRegion, bz, selected);
+    }
+    if (all_) break;
+  }
+  if (all_) return;
+
+  for (unsigned int i=0; i<modules_.size(); ++i) {
+    if (!selected[i]) continue;
+    (modules_[i].pixel ? pixelModules_ : stripModules_).push_back(modules_[i].id);
+  }
+  std::sort(pixelModules_.begin(), pixelModules_.end());
+  std::sort(stripModules_.begin(), stripModules_.end());
+
+  LogDebug("TrackingRegionModuleSelector") << nRegions_ << " regions select "
+					   << pixelModules_.size() << "/" << nPixelTotal_ << " pixel and "
+					   << stripModules_.size() << "/" << nStripTotal_ << " strip modules";
+}
+
+void TrackingRegionModuleSelector::addRegion(const RectangularEtaPhiTrackingRegion& region, float bz, std::vector<char>& selected) const {
+  const Window w = window(region, bz, extraEta_, extraPhi_);
+  for (unsigned int i=0; i<modules_.size(); ++i) {
+    if (!selected[i] && touches(modules_[i], w)) selected[i] = 1;
+  }
+}
+
+TrackingRegionModuleSelector::Window
+TrackingRegionModuleSelector::window(const RectangularEtaPhiTrackingRegion& region, float bz, float extraEta, float extraPhi) {
+  Window w;
+  w.etaMin = region.etaRange().min() - extraEta;
+  w.etaMax = region.etaRange().max() + extraEta;
+  w.phi0 = region.phiDirection();
+  w.phiLeft = region.phiMargin().left() + extraPhi;
+  w.phiRight = region.phiMargin().right() + extraPhi;
+  w.zoLo = region.origin().z() - region.originZBound();
+  w.zoHi = region.origin().z() + region.originZBound();
+  w.rb = region.originRBound();
+  w.rho = std::abs(bz)>0.f ? region.ptMin()/(0.003f*std::abs(bz)) : 0.f;
+  return w;
+}
+
+bool TrackingRegionModuleSelector::touches(const Module& m, const Window& w) {
+  const float rLo = std::max(m.r-m.halfSize, 1.e-3f);
+  const float rHi = m.r+m.halfSize;
+
+  // eta of the module extent seen from any origin in [zoLo,zoHi]: a track reaches
+  // the radius r after a transverse path between r (straight) and that of a ptMin track
+  const float sHi = w.rho>0.f ? 2.f*w.rho*std::asin(std::min(1.f, 0.5f*rHi/w.rho)) : rHi;
+  const float dzLo = m.z-m.halfSize-w.zoHi;
+  const float dzHi = m.z+m.halfSize-w.zoLo;
+  const float etaLo = std::asinh(dzLo/(dzLo<0 ? rLo : sHi));
+  const float etaHi = std::asinh(dzHi/(dzHi>0 ? rLo : sHi));
+  if (etaHi<w.etaMin || etaLo>w.etaMax) return false;
+
+  // phi: half opening of the module, bending of a ptMin track up to its outer
+  // edge and transverse origin bound seen from its inner edge
+  const float dphi = reco::deltaPhi(m.phi, w.phi0);
+  float tol = m.halfSize<m.r ? std::asin(m.halfSize/m.r) : float(M_PI);
+  if (w.rho>0.f) tol += std::asin(std::min(1.f, 0.5f*rHi/w.rho));
+  if (w.rb<rLo) tol += std::asin(w.rb/rLo);
+  else tol = float(M_PI);
+  return dphi >= -(w.phiLeft+tol) && dphi <= w.phiRight+tol;
+}
@@ -0,0 +1,103 @@
+// the module selection of TrackingRegionModuleSelector must keep every module that a
+// track of the region can cross: random helices of the region are propagated to a
+// random radius and a module containing the crossing point must be selected
+
+#include "RecoTracker/TkTrackingRegions/interface/TrackingRegionModuleSelector.h"
+#include "RecoTracker/TkTrackingRegions/interface/RectangularEtaPhiTrackingRegion.h"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+
+namespace {
+
+  typedef TrackingRegionModuleSelector::Module Module;
+  typedef RectangularEtaPhiTrackingRegion::Margin Margin;
+
+  constexpr float bz = 3.8f;
+
+  Module module(float x, float y, float z, float halfSize) {
+    Module m;
+    m.r = std::hypot(x, y);
+    m.z = z;
+    m.phi = std::atan2(y, x);
+    m.halfSize = halfSize;
+    m.id = 0;
+    m.pixel = true;
+    return m;
+  }
+
+  // modules around crossing points of tracks of the region, all to be selected
+  int checkTracks(const RectangularEtaPhiTrackingRegion& region, std::mt19937& rng) {
+    auto w = TrackingRegionModuleSelector::window(region, bz, 0.f, 0.f);
+    std::uniform_real_distribution<float> flat(0.f, 1.f);
+    int failures = 0;
+    for (int i = 0; i < 100000; ++i) {
+      // the margins edges included
+      float eta = w.etaMin + (w.etaMax - w.etaMin) * (i % 10 == 0 ? float(i % 20 == 0) : flat(rng));
+      float phi = w.phi0 - w.phiLeft + (w.phiLeft + w.phiRight) * (i % 10 == 1 ? float(i % 20 == 1) : flat(rng));
+      float z0 = w.zoLo + (w.zoHi - w.zoLo) * flat(rng);
+      float pt = region.ptMin() * (i % 10 == 2 ? 1.f : 1.f + 4.f * flat(rng));
+      float charge = flat(rng) < 0.5f ? -1.f : 1.f;
+      float rho = pt / (0.003f * bz);
+
+      // crossing point at the transverse radius r of the helix
+      float r = 3.f + (std::min(120.f, 1.99f * rho) - 3.f) * flat(rng);
+      float bend = std::asin(0.5f * r / rho);
+      float phiAtR = phi - charge * bend;
+      float z = z0 + 2.f * rho * bend * std::sinh(eta);
+      float x = r * std::cos(phiAtR);
+      float y = r * std::sin(phiAtR);
+
+      // a module containing it
+      float halfSize = 0.5f + 5.f * flat(rng);
+      float d = 0.99f * halfSize * flat(rng);
+      float ct = 2.f * flat(rng) - 1.f, st = std::sqrt(1.f - ct * ct), a = 2.f * float(M_PI) * flat(rng);
+      Module m = module(x + d * st * std::cos(a), y + d * st * std::sin(a), z + d * ct, halfSize);
+
+      if (!TrackingRegionModuleSelector::touches(m, w)) {
+        if (++failures <= 10)
+          std::cout << "not selected: eta " << eta << " phi " << phi << " z0 " << z0 << " pt " << pt
+                    << " module r " << m.r << " z " << m.z << " phi " << m.phi << " size " << m.halfSize << std::endl;
+      }
+    }
+    return failures;
+  }
+
+  int check(bool ok, const char* what) {
+    if (!ok) std::cout << "failed: " << what << std::endl;
+    return ok ? 0 : 1;
+  }
+
+}  // namespace
+
+int main() {
+  std::mt19937 rng(12345);
+  int failures = 0;
+
+  // central region
+  RectangularEtaPhiTrackingRegion central(GlobalVector(std::cos(0.3f), std::sin(0.3f), 0.2f), GlobalPoint(0, 0, 1.f),
+                                          2.f, 0.1f, 15.f, 0.3f, 0.2f);
+  failures += checkTracks(central, rng);
+
+  // asymmetric margins across phi = +-pi, forward, low pt
+  RectangularEtaPhiTrackingRegion wrapped(GlobalVector(-1.f, 0.05f, 2.f), GlobalPoint(0, 0, -3.f),
+                                          0.9f, 0.1f, 5.f, Margin(0.1f, 0.25f), Margin(0.05f, 0.3f));
+  failures += checkTracks(wrapped, rng);
+
+  // far away modules are not selected
+  auto w = TrackingRegionModuleSelector::window(central, bz, 0.f, 0.f);
+  failures += check(!TrackingRegionModuleSelector::touches(module(-50.f, 0.f, 0.f, 5.f), w), "opposite phi");
+  failures += check(!TrackingRegionModuleSelector::touches(module(50.f, 15.f, 250.f, 5.f), w), "forward eta");
+  failures += check(!TrackingRegionModuleSelector::touches(module(50.f, 15.f, -100.f, 5.f), w), "backward eta");
+  failures += check(TrackingRegionModuleSelector::touches(module(-50.f, 0.f, 0.f, 5.f),
+                                                          TrackingRegionModuleSelector::window(central, bz, 0.f, 3.f)),
+                    "extraPhi");
+
+  auto ww = TrackingRegionModuleSelector::window(wrapped, bz, 0.f, 0.f);
+  failures += check(TrackingRegionModuleSelector::touches(module(-50.f, -1.f, 100.f, 2.f), ww), "phi = -pi side");
+  failures += check(!TrackingRegionModuleSelector::touches(module(0.f, 50.f, 100.f, 2.f), ww), "phi = pi/2");
+
+  if (failures) std::cout << failures << " failures" << std::endl;
+  return failures ? 1 : 0;
+}
@@ -27,6 +27,9 @@ public:
    */
   void addState (const TrajectoryStateOnSurface);
 
+  /// Reserves space for n components
+  void reserve (unsigned int n);
+
   /// Adds (the weight of an) invalid state to the list
   void addInvalidState (const double);
 
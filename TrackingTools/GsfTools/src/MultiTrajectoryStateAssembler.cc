@@ -1,5 +1,4 @@
 #include "TrackingTools/GsfTools/interface/MultiTrajectoryStateAssembler.h"
-#include "TrackingTools/GsfTools/interface/GetComponents.h"
 #include "TrackingTools/GsfTools/interface/BasicMultiTrajectoryState.h"
 #include "TrackingTools/GsfTools/src/TrajectoryStateLessWeight.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
@@ -32,11 +31,24 @@ void MultiTrajectoryStateAssembler::addState (const TrajectoryStateOnSurface tso
   if ( !tsos.isValid() )
     throw cms::Exception("LogicError") << "MultiTrajectoryStateAssembler: trying to add invalid state";
   //
+  // Single states (the usual case, one per propagated / updated component)
+  // are added directly, without building a temporary vector of components
+  //
+  if ( tsos.singleState() ) {
+    if ( !theStates.empty() &&
+	 theStates.front().localParameters().pzSign()*tsos.localParameters().pzSign()<0. )  thePzError = true;
+    theValidWeightSum += tsos.weight();
+    theStates.push_back(tsos);
+    return;
+  }
+  //
   // Add components (i.e. state to be added can be single or multi state)
   //
-  GetComponents comps(tsos);
-  MultiTSOS components(comps());
-  addStateVector(components);
+  addStateVector(tsos.components());
+}
+
+void MultiTrajectoryStateAssembler::reserve (unsigned int n) {
+  theStates.reserve(n);
 }
 
 void MultiTrajectoryStateAssembler::addStateVector (const MultiTSOS& states)
@@ -0,0 +1,58 @@
+#include "TrackingTools/GsfTools/interface/CloseComponentsMerger.h"
+#include "TrackingTools/GsfTools/interface/KullbackLeiblerDistance.h"
+
+#include<iostream>
+#include<algorithm>
+#include<vector>
+#include<cmath>
+#include<cassert>
+
+typedef SingleGaussianState<5> GS;
+typedef MultiGaussianState<5> MGS;
+typedef GS::Vector Vector;
+typedef GS::Matrix Matrix;
+
+// compare the in-place merging with the original map based one
+int main() {
+
+  KullbackLeiblerDistance<5> distance;
+
+  int nBad=0;
+  for (int nc=2; nc<=72; nc+=5) {
+    MGS::SingleStateContainer comps;
+    for (int i=0; i<nc; ++i) {
+      double x = 0.1*i;
+      Vector mean(1.+std::sin(x), 0.5*std::cos(3*x), x, 0.01*i, -0.02*i);
+      Matrix cov(ROOT::Math::SMatrixIdentity());
+      for (int j=0; j<5; ++j) cov(j,j) = 0.1+0.05*j+0.01*std::abs(std::sin(7*x+j));
+      cov(0,1) = 0.01*std::cos(x);
+      comps.push_back(std::make_shared<GS>(mean,cov,1.+0.013*i+0.001*i*i));
+    }
+    MGS mgs(comps);
+
+    for (int nmax=1; nmax<=12; nmax+=3) {
+      CloseComponentsMerger<5> merger(nmax,&distance);
+      auto res = merger.merge(mgs);
+      auto ref = merger.mergeOld(mgs);
+
+      std::vector<double> w1, w2;
+      for (auto const & c : res.components()) w1.push_back(c->weight());
+      for (auto const & c : ref.components()) w2.push_back(c->weight());
+      std::sort(w1.begin(),w1.end());
+      std::sort(w2.begin(),w2.end());
+
+      bool ok = w1.size()==w2.size() && int(w1.size())<=std::max(nmax,1) &&
+	std::abs(res.weight()-mgs.weight())<1.e-9*mgs.weight();
+      for (auto i=0U; ok && i<w1.size(); ++i) ok &= std::abs(w1[i]-w2[i])<1.e-9*w2[i];
+      for (int j=0; ok && j<5; ++j) ok &= std::abs(res.mean()(j)-ref.mean()(j))<1.e-9;
+      if (!ok) {
+	++nBad;
+	std::cout << "mismatch for " << nc << " components merged into " << nmax
+		  << ": " << w1.size() << " vs " << w2.size() << std::endl;
+      }
+    }
+  }
+
+  std::cout << (nBad ? "FAILED" : "OK") << std::endl;
+  return nBad;
+}
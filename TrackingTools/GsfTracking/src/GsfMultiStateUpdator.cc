@@ -1,48 +1,131 @@
 #include "TrackingTools/GsfTracking/interface/GsfMultiStateUpdator.h"
 #include "TrackingTools/GsfTools/interface/GetComponents.h"
-#include "TrackingTools/KalmanUpdators/interface/KFUpdator.h"
 #include "TrackingTools/PatternTools/interface/MeasurementExtractor.h"
 #include "TrackingTools/TransientTrackingRecHit/interface/TransientTrackingRecHit.h"
 #include "DataFormats/GeometrySurface/interface/BoundPlane.h"
+#include "DataFormats/TrackingRecHit/interface/KfComponentsHolder.h"
+#include "DataFormats/Math/interface/invertPosDefMatrix.h"
+#include "DataFormats/Math/interface/ProjectMatrix.h"
 #include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
 #include "TrackingTools/GsfTools/interface/BasicMultiTrajectoryState.h"
-#include "TrackingTools/GsfTracking/interface/PosteriorWeightsCalculator.h"
 #include "TrackingTools/GsfTools/interface/MultiTrajectoryStateAssembler.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "CommonTools/Utils/interface/DynArray.h"
+
+#include <cfloat>
+#include <cmath>
+#include <typeinfo>
+
+namespace {
+
+  /* Kalman update of all the components with the same hit, together with
+   * the posterior weights (as in KFUpdator and PosteriorWeightsCalculator):
+   * the hit is projected and the residual covariance inverted once per
+   * component and used for both.
+   */
+  template <unsigned int D>
+  TrajectoryStateOnSurface
+  lupdate(const TrajectoryStateOnSurface& tsos,
+	  TrajectoryStateOnSurface::Components const & predictedComponents,
+	  const TrackingRecHit& aRecHit) {
+
+    typedef typename AlgebraicROOTObject<5,D>::Matrix Mat5D;
+    typedef typename AlgebraicROOTObject<D,D>::SymMatrix SMatDD;
+    typedef typename AlgebraicROOTObject<D>::Vector VecD;
+    using ROOT::Math::SMatrixNoInit;
+
+    auto n = predictedComponents.size();
+    declareDynArray(AlgebraicVector5,n,fsvs);
+    declareDynArray(AlgebraicSymMatrix55,n,fses);
+    declareDynArray(double,n,weights);
+    declareDynArray(double,n,chi2s);
+
+    VecD r, rMeas;
+    SMatDD V(SMatrixNoInit{}), VMeas(SMatrixNoInit{});
+    ProjectMatrix<double,5,D> pf;
+
+    double chi2Min(DBL_MAX);
+    for (auto i=0U; i<n; ++i) {
+      auto const & tsosI = predictedComponents[i];
+      auto && x = tsosI.localParameters().vector();
+      auto && C = tsosI.localError().matrix();
+
+      KfComponentsHolder holder;
+      holder.template setup<D>(&r, &V, &pf, &rMeas, &VMeas, x, C);
+      aRecHit.getKfComponents(holder);
+
+      r -= rMeas;
+      SMatDD R = V + VMeas;
+
+      double detR;
+      if (! R.Det2(detR) ) {
+	edm::LogError("GsfMultiStateUpdator") << "determinant failed. invalid updated state !.";
+	return TrajectoryStateOnSurface();
+      }
+      if ( !invertPosDefMatrix(R) ) {
+	edm::LogError("GsfMultiStateUpdator") << "inversion failed. invalid updated state !.";
+	return TrajectoryStateOnSurface();
+      }
+
+      // posterior weight (without the common factor exp(-0.5*chi2Min))
+      chi2s[i] = ROOT::Math::Similarity(r,R);
+      if ( chi2s[i]<chi2Min )  chi2Min = chi2s[i];
+      weights[i] = detR>FLT_MIN ? tsosI.weight()*std::sqrt(1./detR) : 0.;
+
+      // Kalman gain and filtered state (Joseph form)
+      AlgebraicMatrix55 M = AlgebraicMatrixID();
+      Mat5D K = C*pf.project(R);
+      pf.projectAndSubtractFrom(M,K);
+      fsvs[i] = x + K * r;
+      fses[i] = ROOT::Math::Similarity(M, C) + ROOT::Math::Similarity(K, V);
+    }
+
+    double sumWeights(0.);
+    for (auto i=0U; i<n; ++i) {
+      weights[i] *= std::exp(-0.5 * (chi2s[i] - chi2Min));
+      sumWeights += weights[i];
+    }
+    if ( sumWeights<DBL_MIN ) {
+      edm::LogError("GsfMultiStateUpdator") << " no weights could be retreived. invalid updated state !.";
+      return TrajectoryStateOnSurface();
+    }
+    sumWeights = 1./sumWeights;
+
+    MultiTrajectoryStateAssembler result;
+    result.reserve(n);
+    for (auto i=0U; i<n; ++i) {
+      auto const & tsosI = predictedComponents[i];
+      result.addState(TrajectoryStateOnSurface(weights[i]*sumWeights,
+					       LocalTrajectoryParameters(fsvs[i], tsosI.localParameters().pzSign()),
+					       LocalTrajectoryError(fses[i]), tsosI.surface(),
+					       &(tsos.globalParameters().magneticField()),
+					       tsosI.surfaceSide()
+					       ));
+    }
+
+    return result.combinedState();
+  }
+
+}
 
 TrajectoryStateOnSurface GsfMultiStateUpdator::update(const TrajectoryStateOnSurface& tsos,
 						      const TrackingRecHit& aRecHit) const {
-  GetComponents comps(tsos);  
+  GetComponents comps(tsos);
   auto const & predictedComponents = comps();
   if (predictedComponents.empty()) {
     edm::LogError("GsfMultiStateUpdator") << "Trying to update trajectory state with zero components! " ;
     return TrajectoryStateOnSurface();
   }
 
-  auto && weights = PosteriorWeightsCalculator(predictedComponents).weights(aRecHit);
-  if ( weights.empty() ) {
-    edm::LogError("GsfMultiStateUpdator") << " no weights could be retreived. invalid updated state !.";
-    return TrajectoryStateOnSurface();
-  }
-
-  MultiTrajectoryStateAssembler result;
-
-  int i = 0;
-  for (auto const & tsosI : predictedComponents) {
-    TrajectoryStateOnSurface updatedTSOS = KFUpdator().update(tsosI, aRecHit);
-    if (updatedTSOS.isValid()){
-      result.addState(TrajectoryStateOnSurface(weights[i], 
-                                               updatedTSOS.localParameters(),
-					       updatedTSOS.localError(), updatedTSOS.surface(), 
-					       &(tsos.globalParameters().magneticField()),
-					       tsosI.surfaceSide()
-                                              ));
-    }
-    else{
-      edm::LogError("GsfMultiStateUpdator") << "KF updated state " << i << " is invalid. skipping.";
-    }
-    ++i;
+  switch (aRecHit.dimension()) {
+    case 1: return lupdate<1>(tsos,predictedComponents,aRecHit);
+    case 2: return lupdate<2>(tsos,predictedComponents,aRecHit);
+    case 3: return lupdate<3>(tsos,predictedComponents,aRecHit);
+    case 4: return lupdate<4>(tsos,predictedComponents,aRecHit);
+    case 5: return lupdate<5>(tsos,predictedComponents,aRecHit);
   }
-
-  return result.combinedState();
+  throw cms::Exception("Rec hit of invalid dimension (not 1,2,3,4,5)") <<
+    "The value was " << aRecHit.dimension() <<
+    ", type is " << typeid(aRecHit).name() << "\n";
 }